@@ -106,6 +106,8 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
   protected:
     DISKANN_DLLEXPORT void use_medoids_data_as_centroids();
     DISKANN_DLLEXPORT void setup_thread_data(uint64_t nthreads, uint64_t visited_reserve = 4096);
+    DISKANN_DLLEXPORT SSDThreadData<T> *new_thread_data();
+    DISKANN_DLLEXPORT void free_thread_data();
 
     DISKANN_DLLEXPORT void set_universal_label(const LabelT &label);
 
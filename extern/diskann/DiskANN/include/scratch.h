@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "boost_dynamic_bitset_fwd.h"
@@ -13,6 +14,7 @@
 
 #include "neighbor.h"
 #include "concurrent_queue.h"
+#include "local_file_reader.h"
 #include "pq.h"
 
 // In-mem index related limits
@@ -159,10 +161,25 @@ template <typename T> class SSDQueryScratch
 
     PQScratch<T> *_pq_scratch;
 
+    char *sector_scratch = nullptr; // [sector_scratch_len] bytes, aligned to SECTOR_LEN
+    size_t sector_scratch_len = 0;
+
+    // Beam search state. Cleared (not freed) between queries so that only the
+    // first query served by a scratch pays for growing them.
+    tsl::robin_set<uint64_t> visited;
+    std::vector<Neighbor> full_retset;
+    NeighborPriorityQueue retset;
+    std::vector<Neighbor> candidates; // max-heap on distance
+    std::vector<uint32_t> unseen_ids;
+    std::vector<uint32_t> frontier;
+    std::vector<std::pair<uint32_t, char *>> frontier_nhoods;
+    std::vector<AlignedRead> frontier_read_reqs;
 
     SSDQueryScratch(size_t max_degree, size_t aligned_dim, size_t pq_chunk);
     ~SSDQueryScratch();
 
+    // grows sector_scratch to hold at least num_sectors sectors of sector_len bytes
+    void reserve_sectors(size_t num_sectors, size_t sector_len);
     void reset();
 };
 
@@ -189,6 +206,17 @@ template <typename T> class ScratchStoreManager
             _scratch = query_scratch.pop();
         }
     }
+    // Creates a new scratch instead of waiting when the pool is empty, so the
+    // pool grows to the number of concurrent users and is reused from then on.
+    ScratchStoreManager(ConcurrentQueue<T *> &query_scratch, const std::function<T *()> &make_scratch)
+        : _scratch_pool(query_scratch)
+    {
+        _scratch = query_scratch.pop();
+        if (_scratch == nullptr)
+        {
+            _scratch = make_scratch();
+        }
+    }
     T *scratch_space()
     {
         return _scratch;
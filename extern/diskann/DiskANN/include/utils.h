@@ -742,7 +742,7 @@ inline size_t save_bin(const std::string &filename, T *data, size_t npts, size_t
 }
 
 template <typename T>
-inline size_t save_bin(std::stringstream& writer, T *data, size_t npts, size_t ndims, size_t offset = 0)
+inline size_t save_bin(std::ostream& writer, T *data, size_t npts, size_t ndims, size_t offset = 0)
 {
 //    std::ofstream writer;
     writer.seekp(offset, writer.beg);
@@ -1023,8 +1023,8 @@ void create_disk_layout(const std::string base_file, const std::string mem_index
 }
 
 template <typename T>
-void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::stringstream &vamana_reader,
-                        std::stringstream &diskann_writer, size_t sector_len, diskann::Metric metric)
+void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::istream &vamana_reader,
+                        std::ostream &diskann_writer, size_t sector_len, diskann::Metric metric)
     {
         // amount to read or write in one shot
         size_t read_blk_size = 64 * 1024 * 1024;
@@ -1040,8 +1040,10 @@ void create_disk_layout(const T *data, uint32_t npts, uint32_t ndims, const std:
 
         uint32_t npts_reorder_file = 0, ndims_reorder_file = 0;
 
-        // create cached reader + writer
-        size_t actual_file_size = vamana_reader.str().size();
+        // the graph and the layout may be files larger than memory, only one sector is buffered
+        vamana_reader.seekg(0, vamana_reader.end);
+        size_t actual_file_size = (size_t)vamana_reader.tellg();
+        vamana_reader.seekg(0, vamana_reader.beg);
         // diskann::cout << "Vamana index file size=" << actual_file_size << std::endl;
 
         // metadata: width, medoid
@@ -1443,11 +1445,11 @@ template DISKANN_DLLEXPORT void create_disk_layout<float>(const std::string base
                                                           const std::string reorder_data_file);
 
 
-template DISKANN_DLLEXPORT void create_disk_layout<int8_t>(const int8_t *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::stringstream &vamana_reader, std::stringstream &diskann_writer,
+template DISKANN_DLLEXPORT void create_disk_layout<int8_t>(const int8_t *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::istream &vamana_reader, std::ostream &diskann_writer,
                                                            size_t sector_len, diskann::Metric metric);
-template DISKANN_DLLEXPORT void create_disk_layout<uint8_t>(const uint8_t *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::stringstream &vamana_reader, std::stringstream &diskann_writer,
+template DISKANN_DLLEXPORT void create_disk_layout<uint8_t>(const uint8_t *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::istream &vamana_reader, std::ostream &diskann_writer,
                                                             size_t sector_len, diskann::Metric metric);
-template DISKANN_DLLEXPORT void create_disk_layout<float>(const float *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::stringstream &vamana_reader, std::stringstream &diskann_writer,
+template DISKANN_DLLEXPORT void create_disk_layout<float>(const float *data, uint32_t npts, uint32_t ndims, const std::vector<size_t>& skip_locs, std::istream &vamana_reader, std::ostream &diskann_writer,
                                                           size_t sector_len, diskann::Metric metric);
 template DISKANN_DLLEXPORT int8_t *load_warmup<int8_t>(const std::string &cache_warmup_file, uint64_t &warmup_num,
                                                        uint64_t warmup_dim, uint64_t warmup_aligned_dim);
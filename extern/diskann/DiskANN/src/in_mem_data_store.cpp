@@ -227,6 +227,12 @@ template <typename data_t> void InMemDataStore<data_t>::link_data(const data_t *
 template <typename data_t> void InMemDataStore<data_t>::populate_data(const std::string &filename, const size_t offset)
 {
     size_t npts, ndim;
+    // the buffer is allocated lazily by the in-memory populate_data/link_data
+    if (_data == nullptr)
+    {
+        alloc_aligned(((void **)&_data), this->capacity() * _aligned_dim * sizeof(data_t), 8 * sizeof(data_t));
+        std::memset(_data, 0, this->capacity() * _aligned_dim * sizeof(data_t));
+    }
     copy_aligned_data_from_file(filename.c_str(), _data, npts, ndim, _aligned_dim, offset);
 
     if ((location_t)npts > this->capacity())
@@ -71,11 +71,9 @@ template <typename T, typename LabelT> PQFlashIndex<T, LabelT>::~PQFlashIndex()
         diskann::aligned_free(coord_cache_buf);
     }
 
+    free_thread_data();
     if (load_flag)
     {
-        // diskann::cout << "Clearing scratch" << std::endl;
-        ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data);
-        manager.destroy();
         this->reader->deregister_all_threads();
         reader->close();
     }
@@ -103,20 +101,35 @@ void PQFlashIndex<T, LabelT>::setup_thread_data(uint64_t nthreads, uint64_t visi
     for (int64_t thread = 0; thread < (int64_t)nthreads; thread++)
     {
         {
-            SSDThreadData<T> *data = new SSDThreadData<T>(this->max_degree, this->aligned_dim, this->n_chunks);
+            SSDThreadData<T> *data = new_thread_data();
             this->thread_data.push(data);
         }
     }
     load_flag = true;
 }
 
+template <typename T, typename LabelT> SSDThreadData<T> *PQFlashIndex<T, LabelT>::new_thread_data()
+{
+    return new SSDThreadData<T>(this->max_degree, this->aligned_dim, this->n_chunks);
+}
+
+// Scratches are sized by max_degree/n_chunks, so they must be dropped whenever
+// those change; searches recreate them on demand.
+template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::free_thread_data()
+{
+    for (auto data = this->thread_data.pop(); data != nullptr; data = this->thread_data.pop())
+    {
+        delete data;
+    }
+}
+
 template <typename T, typename LabelT> void PQFlashIndex<T, LabelT>::load_cache_list(std::vector<uint32_t> &node_list)
 {
     diskann::cout << "Loading the cache list into memory.." << std::flush;
     size_t num_cached_nodes = node_list.size();
 
     // borrow thread data
-    ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data);
+    ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data, [this]() { return new_thread_data(); });
     auto this_thread_data = manager.scratch_space();
 
 
@@ -283,7 +296,7 @@ void PQFlashIndex<T, LabelT>::cache_bfs_levels(uint64_t num_nodes_to_cache, std:
     diskann::cout << "Caching " << num_nodes_to_cache << "..." << std::endl;
 
     // borrow thread data
-    ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data);
+    ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data, [this]() { return new_thread_data(); });
     auto this_thread_data = manager.scratch_space();
 
     std::unique_ptr<tsl::robin_set<uint32_t>> cur_level, prev_level;
@@ -1455,46 +1468,50 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
                                                  const uint32_t io_limit, const bool use_reorder_data,
                                                  QueryStats *stats)
 {
-    std::shared_ptr<float[]> aligned_query_T = std::shared_ptr<float[]>(new float[this->data_dim]);
-
+    // borrow a per-thread scratch, all per-query buffers below live in it
+    ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data, [this]() { return new_thread_data(); });
+    auto query_scratch = &(manager.scratch_space()->scratch);
+    auto pq_scratch = query_scratch->_pq_scratch;
 
+    float *aligned_query_T = pq_scratch->aligned_query_float;
     for (size_t i = 0; i < this->data_dim; i++)
     {
         aligned_query_T[i] = (float) query1[i];
     }
     if (diskann::Metric::COSINE == metric) {
-        normalize(aligned_query_T.get(), this->data_dim);
+        normalize(aligned_query_T, this->data_dim);
     }
 
     // FIXME: alternative instruction on aarch64
 #if defined(__i386__) || defined(__x86_64__)
-    _mm_prefetch((char *)aligned_query_T.get(), _MM_HINT_T1);
+    _mm_prefetch((char *)aligned_query_T, _MM_HINT_T1);
 #endif
 
     // sector scratch
-    auto sector_scratch = std::shared_ptr<char[]>(new char[beam_width * sector_len]);
+    query_scratch->reserve_sectors(beam_width, sector_len);
+    char *sector_scratch = query_scratch->sector_scratch;
 
     // query <-> PQ chunk centers distances
-    pq_table.preprocess_query(aligned_query_T.get()); // center the query and rotate if
+    pq_table.preprocess_query(aligned_query_T); // center the query and rotate if
     // we have a rotation matrix
-    auto pq_dists = std::shared_ptr<float[]>(new float[NUM_CENTROID * this->n_chunks]);
-    pq_table.populate_chunk_distances(aligned_query_T.get(), pq_dists.get());
+    float *pq_dists = pq_scratch->aligned_pqtable_dist_scratch;
+    pq_table.populate_chunk_distances(aligned_query_T, pq_dists);
 
     // query <-> neighbor list
-    auto dist_scratch = std::shared_ptr<float[]>(new float[this->max_degree]);
-    auto pq_coord_scratch = std::shared_ptr<uint8_t[]>(new uint8_t[this->max_degree * this->n_chunks]);
+    float *dist_scratch = pq_scratch->aligned_dist_scratch;
+    uint8_t *pq_coord_scratch = pq_scratch->aligned_pq_coord_scratch;
 
     // lambda to batch compute query<-> node distances in PQ space
     auto compute_dists = [this, pq_coord_scratch, pq_dists](const uint32_t *ids, const uint64_t n_ids,
                                                             float *dists_out) {
-        diskann::aggregate_coords(ids, n_ids, this->data, this->n_chunks, pq_coord_scratch.get());
-        diskann::pq_dist_lookup(pq_coord_scratch.get(), n_ids, this->n_chunks, pq_dists.get(), dists_out);
+        diskann::aggregate_coords(ids, n_ids, this->data, this->n_chunks, pq_coord_scratch);
+        diskann::pq_dist_lookup(pq_coord_scratch, n_ids, this->n_chunks, pq_dists, dists_out);
     };
     Timer query_timer, io_timer, cpu_timer;
 
-    tsl::robin_set<uint64_t> visited;
-    std::vector<Neighbor> full_retset;
-    NeighborPriorityQueue retset;
+    tsl::robin_set<uint64_t> &visited = query_scratch->visited;
+    std::vector<Neighbor> &full_retset = query_scratch->full_retset;
+    NeighborPriorityQueue &retset = query_scratch->retset;
     visited.reserve(l_search);
     full_retset.reserve(l_search);
     retset.reserve(l_search);
@@ -1505,7 +1522,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
     for (uint64_t cur_m = 0; cur_m < num_medoids; cur_m++)
     {
         float cur_expanded_dist =
-            dist_cmp_float->compare(aligned_query_T.get(), centroid_data + aligned_dim * cur_m, (uint32_t)data_dim);
+            dist_cmp_float->compare(aligned_query_T, centroid_data + aligned_dim * cur_m, (uint32_t)data_dim);
         if (cur_expanded_dist < best_dist)
         {
             best_medoid = medoids[cur_m];
@@ -1513,7 +1530,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
         }
     }
 
-    compute_dists(&best_medoid, 1, dist_scratch.get());
+    compute_dists(&best_medoid, 1, dist_scratch);
     retset.insert(Neighbor(best_medoid, dist_scratch[0]));
     visited.insert(best_medoid);
 
@@ -1522,11 +1539,11 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
     uint32_t num_ios = 0;
 
     // cleared every iteration
-    std::vector<uint32_t> frontier;
+    std::vector<uint32_t> &frontier = query_scratch->frontier;
     frontier.reserve(2 * beam_width);
-    std::vector<std::pair<uint32_t, char *>> frontier_nhoods;
+    std::vector<std::pair<uint32_t, char *>> &frontier_nhoods = query_scratch->frontier_nhoods;
     frontier_nhoods.reserve(2 * beam_width);
-    std::vector<AlignedRead> frontier_read_reqs;
+    std::vector<AlignedRead> &frontier_read_reqs = query_scratch->frontier_read_reqs;
     frontier_read_reqs.reserve(2 * beam_width);
     std::vector<std::pair<uint32_t, std::pair<uint32_t, uint32_t *>>> cached_nhoods;
     cached_nhoods.reserve(2 * beam_width);
@@ -1574,7 +1591,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
                 auto id = frontier[i];
                 std::pair<uint32_t, char *> fnhood;
                 fnhood.first = id;
-                fnhood.second = sector_scratch.get() + sector_scratch_idx * sector_len;
+                fnhood.second = sector_scratch + sector_scratch_idx * sector_len;
                 sector_scratch_idx++;
                 frontier_nhoods.push_back(fnhood);
                 frontier_read_reqs.emplace_back(NODE_SECTOR_NO(((size_t)id)) * sector_len, sector_len, fnhood.second);
@@ -1611,14 +1628,14 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
             auto global_cache_iter = coord_cache.find(cached_nhood.first);
             T *node_fp_coords_copy = global_cache_iter->second;
             float cur_expanded_dist;
-            cur_expanded_dist = dist_cmp_float->compare(aligned_query_T.get(), (float *)node_fp_coords_copy, (uint32_t)data_dim);
+            cur_expanded_dist = dist_cmp_float->compare(aligned_query_T, (float *)node_fp_coords_copy, (uint32_t)data_dim);
             full_retset.push_back(Neighbor((uint32_t)cached_nhood.first, cur_expanded_dist));
 
             uint64_t nnbrs = cached_nhood.second.first;
             uint32_t *node_nbrs = cached_nhood.second.second;
 
             // compute node_nbrs <-> query dists in PQ space
-            compute_dists(node_nbrs, nnbrs, dist_scratch.get());
+            compute_dists(node_nbrs, nnbrs, dist_scratch);
 
             // process prefetched nhood
             for (uint64_t m = 0; m < nnbrs; ++m)
@@ -1639,11 +1656,11 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
             uint32_t *node_buf = OFFSET_TO_NODE_NHOOD(node_disk_buf);
             uint64_t nnbrs = (uint64_t)(*node_buf);
             T *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
-            float cur_expanded_dist = dist_cmp_float->compare((float *)aligned_query_T.get(), (float *)node_fp_coords, (uint32_t)data_dim);
+            float cur_expanded_dist = dist_cmp_float->compare((float *)aligned_query_T, (float *)node_fp_coords, (uint32_t)data_dim);
             full_retset.push_back(Neighbor(frontier_nhood.first, cur_expanded_dist));
             uint32_t *node_nbrs = (node_buf + 1);
             // compute node_nbrs <-> query dist in PQ space
-            compute_dists(node_nbrs, nnbrs, dist_scratch.get());
+            compute_dists(node_nbrs, nnbrs, dist_scratch);
             if (stats != nullptr)
             {
                 stats->n_cmps += (uint32_t)nnbrs;
@@ -1745,6 +1762,8 @@ size_t PQFlashIndex<T, LabelT>::load_graph(std::stringstream &in)
     {
         throw diskann::ANNException("ERROR: the size of the file being read does not match the expected size.", -1);
     }
+    // max_degree may have grown
+    free_thread_data();
     return nodes_read;
 }
 
@@ -1756,7 +1775,11 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
                                                  const uint32_t io_limit, const bool reorder,
                                                  QueryStats *stats, bool use_for_range)
 {
-    std::shared_ptr<float[]> aligned_query_T = std::shared_ptr<float[]>(new float[this->data_dim]);
+    // borrow a per-thread scratch, all per-query buffers below live in it
+    ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data, [this]() { return new_thread_data(); });
+    auto query_scratch = &(manager.scratch_space()->scratch);
+    auto pq_scratch = query_scratch->_pq_scratch;
+    float *aligned_query_T = pq_scratch->aligned_query_float;
 
     // if inner product, we also normalize the query and set the last coordinate
     // to 0 (this is the extra coordinate used to convert MIPS to L2 search)
@@ -1767,33 +1790,33 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
     }
 
     if (diskann::Metric::COSINE == metric) {
-        normalize(aligned_query_T.get(), this->data_dim);
+        normalize(aligned_query_T, this->data_dim);
     }
 
     // FIXME: alternative instruction on aarch64
 #if defined(__i386__) || defined(__x86_64__)
-    _mm_prefetch((char *)aligned_query_T.get(), _MM_HINT_T1);
+    _mm_prefetch((char *)aligned_query_T, _MM_HINT_T1);
 #endif
 
     // query <-> PQ chunk centers distances
-    pq_table.preprocess_query(aligned_query_T.get()); // center the query and rotate if
+    pq_table.preprocess_query(aligned_query_T); // center the query and rotate if
     // we have a rotation matrix
-    auto pq_dists = std::shared_ptr<float[]>(new float[NUM_CENTROID * this->n_chunks]);
-    pq_table.populate_chunk_distances(aligned_query_T.get(), pq_dists.get());
+    float *pq_dists = pq_scratch->aligned_pqtable_dist_scratch;
+    pq_table.populate_chunk_distances(aligned_query_T, pq_dists);
 
     // query <-> neighbor list
-    auto dist_scratch = std::shared_ptr<float[]>(new float[this->max_degree]);
-    auto pq_coord_scratch = std::shared_ptr<uint8_t[]>(new uint8_t[this->max_degree * this->n_chunks]);
+    float *dist_scratch = pq_scratch->aligned_dist_scratch;
+    uint8_t *pq_coord_scratch = pq_scratch->aligned_pq_coord_scratch;
 
     // lambda to batch compute query<-> node distances in PQ space
     auto compute_dists = [this, pq_coord_scratch, pq_dists](const uint32_t *ids, const uint64_t n_ids,
                                                             float *dists_out) {
-        diskann::aggregate_coords(ids, n_ids, this->data, this->n_chunks, pq_coord_scratch.get());
-        diskann::pq_dist_lookup(pq_coord_scratch.get(), n_ids, this->n_chunks, pq_dists.get(), dists_out);
+        diskann::aggregate_coords(ids, n_ids, this->data, this->n_chunks, pq_coord_scratch);
+        diskann::pq_dist_lookup(pq_coord_scratch, n_ids, this->n_chunks, pq_dists, dists_out);
     };
 
-    tsl::robin_set<uint64_t> visited;
-    std::vector<Neighbor> full_retset;
+    tsl::robin_set<uint64_t> &visited = query_scratch->visited;
+    std::vector<Neighbor> &full_retset = query_scratch->full_retset;
     visited.reserve(l_search);
     full_retset.reserve(l_search);
     uint32_t best_medoid = 0;
@@ -1801,7 +1824,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
     for (uint64_t cur_m = 0; cur_m < num_medoids; cur_m++)
     {
         float cur_expanded_dist =
-                dist_cmp_float->compare(aligned_query_T.get(), centroid_data + aligned_dim * cur_m, (uint32_t)data_dim);
+                dist_cmp_float->compare(aligned_query_T, centroid_data + aligned_dim * cur_m, (uint32_t)data_dim);
         if (cur_expanded_dist < best_dist)
         {
             best_medoid = medoids[cur_m];
@@ -1809,27 +1832,30 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
         }
     }
 
-    compute_dists(&best_medoid, 1, dist_scratch.get());
+    compute_dists(&best_medoid, 1, dist_scratch);
     visited.insert(best_medoid);
 
     uint64_t has_searched = 0;
-    std::priority_queue<Neighbor> candidate_queue;
-    candidate_queue.push(Neighbor(best_medoid, -dist_scratch[0]));
+    // max-heap of candidates keyed by negated distance, i.e. the closest on top
+    std::vector<Neighbor> &candidates = query_scratch->candidates;
+    candidates.emplace_back(best_medoid, -dist_scratch[0]);
 
     while (has_searched < l_search)
     {
-        if (candidate_queue.empty()) {
+        if (candidates.empty()) {
             break; // TODO: add logger for the break (the graph is not connective)
         }
-        auto nbr = candidate_queue.top();
+        std::pop_heap(candidates.begin(), candidates.end());
+        auto nbr = candidates.back();
         full_retset.push_back({nbr.id, -nbr.distance});
-        candidate_queue.pop();
+        candidates.pop_back();
         auto nohood_id = nbr.id;
 
         uint32_t *node_nbrs = final_graph[nohood_id].data();
         size_t nnbrs = final_graph[nohood_id].size();
 
-        std::vector<uint32_t> unseen_ids;
+        std::vector<uint32_t> &unseen_ids = query_scratch->unseen_ids;
+        unseen_ids.clear();
         for (uint64_t m = 0; m < nnbrs; ++m)
         {
             uint32_t id = node_nbrs[m];
@@ -1839,11 +1865,12 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
             }
         }
         if (unseen_ids.size() != 0) {
-            compute_dists(unseen_ids.data(), unseen_ids.size(), dist_scratch.get());
+            compute_dists(unseen_ids.data(), unseen_ids.size(), dist_scratch);
             for (uint64_t i = 0; i < unseen_ids.size(); ++i)
             {
                 float dist = dist_scratch[i];
-                candidate_queue.emplace(unseen_ids[i], -dist);
+                candidates.emplace_back(unseen_ids[i], -dist);
+                std::push_heap(candidates.begin(), candidates.end());
             }
         }
 
@@ -1863,7 +1890,8 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
         std::vector<Neighbor> reorder_retset;
         std::priority_queue<float> distance_ranks;
         int loc = 0;
-        auto sector_scratch = std::shared_ptr<char[]>(new char[beam_width * sector_len]);
+        query_scratch->reserve_sectors(beam_width, sector_len);
+        char *sector_scratch = query_scratch->sector_scratch;
         while (loc < io_limit && loc < full_retset.size())
         {
             std::vector<AlignedRead> sorted_read_reqs;
@@ -1875,7 +1903,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
                     distance_ranks.top() + this->errors[id] > full_retset[loc].distance) {
                     ids.push_back(id);
                     sorted_read_reqs.push_back({NODE_SECTOR_NO(((size_t)id)) * sector_len, sector_len,
-                                                sector_scratch.get() + cur_loc * sector_len});
+                                                sector_scratch + cur_loc * sector_len});
                     cur_loc ++;
                 }
                 loc ++;
@@ -1921,7 +1949,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_memory(const T *query, const
                 char *node_disk_buf = OFFSET_TO_NODE(sorted_read_reqs[j].buf, id);
                 T *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
                 float exact_dist;
-                exact_dist = dist_cmp_float->compare(aligned_query_T.get(), (float *)node_fp_coords, (uint32_t)data_dim);
+                exact_dist = dist_cmp_float->compare(aligned_query_T, (float *)node_fp_coords, (uint32_t)data_dim);
                 reorder_retset.push_back(Neighbor(id, exact_dist));
                 distance_ranks.push(exact_dist);
                 if (distance_ranks.size() > k_search) {
@@ -1967,7 +1995,11 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_async(const T *query, const
                                                            const uint32_t io_limit, const bool reorder,
                                                            QueryStats *stats)
 {
-    std::shared_ptr<float[]> aligned_query_T = std::shared_ptr<float[]>(new float[this->data_dim]); // TODO: add support for other data type
+    // borrow a per-thread scratch, all per-query buffers below live in it
+    ScratchStoreManager<SSDThreadData<T>> manager(this->thread_data, [this]() { return new_thread_data(); });
+    auto query_scratch = &(manager.scratch_space()->scratch);
+    auto pq_scratch = query_scratch->_pq_scratch;
+    float *aligned_query_T = pq_scratch->aligned_query_float;
 
     // if inner product, we also normalize the query and set the last coordinate
     // to 0 (this is the extra coordinate used to convert MIPS to L2 search)
@@ -1978,33 +2010,33 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_async(const T *query, const
     }
 
     if (diskann::Metric::COSINE == metric) {
-        normalize(aligned_query_T.get(), this->data_dim);
+        normalize(aligned_query_T, this->data_dim);
     }
 
     // FIXME: alternative instruction on aarch64
 #if defined(__i386__) || defined(__x86_64__)
-    _mm_prefetch((char *)aligned_query_T.get(), _MM_HINT_T1);
+    _mm_prefetch((char *)aligned_query_T, _MM_HINT_T1);
 #endif
 
     // query <-> PQ chunk centers distances
-    pq_table.preprocess_query(aligned_query_T.get()); // center the query and rotate if
+    pq_table.preprocess_query(aligned_query_T); // center the query and rotate if
     // we have a rotation matrix
-    auto pq_dists = std::shared_ptr<float[]>(new float[NUM_CENTROID * this->n_chunks]);
-    pq_table.populate_chunk_distances(aligned_query_T.get(), pq_dists.get());
+    float *pq_dists = pq_scratch->aligned_pqtable_dist_scratch;
+    pq_table.populate_chunk_distances(aligned_query_T, pq_dists);
 
     // query <-> neighbor list
-    auto dist_scratch = std::shared_ptr<float[]>(new float[this->max_degree]);
-    auto pq_coord_scratch = std::shared_ptr<uint8_t[]>(new uint8_t[this->max_degree * this->n_chunks]);
+    float *dist_scratch = pq_scratch->aligned_dist_scratch;
+    uint8_t *pq_coord_scratch = pq_scratch->aligned_pq_coord_scratch;
 
     // lambda to batch compute query<-> node distances in PQ space
     auto compute_dists = [this, pq_coord_scratch, pq_dists](const uint32_t *ids, const uint64_t n_ids,
                                                             float *dists_out) {
-        diskann::aggregate_coords(ids, n_ids, this->data, this->n_chunks, pq_coord_scratch.get());
-        diskann::pq_dist_lookup(pq_coord_scratch.get(), n_ids, this->n_chunks, pq_dists.get(), dists_out);
+        diskann::aggregate_coords(ids, n_ids, this->data, this->n_chunks, pq_coord_scratch);
+        diskann::pq_dist_lookup(pq_coord_scratch, n_ids, this->n_chunks, pq_dists, dists_out);
     };
 
-    tsl::robin_set<uint64_t> visited;
-    std::vector<Neighbor> full_retset;
+    tsl::robin_set<uint64_t> &visited = query_scratch->visited;
+    std::vector<Neighbor> &full_retset = query_scratch->full_retset;
     visited.reserve(l_search);
     full_retset.reserve(l_search);
     uint32_t best_medoid = 0;
@@ -2012,7 +2044,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_async(const T *query, const
     for (uint64_t cur_m = 0; cur_m < num_medoids; cur_m++)
     {
         float cur_expanded_dist =
-            dist_cmp_float->compare(aligned_query_T.get(), centroid_data + aligned_dim * cur_m, (uint32_t)data_dim);
+            dist_cmp_float->compare(aligned_query_T, centroid_data + aligned_dim * cur_m, (uint32_t)data_dim);
         if (cur_expanded_dist < best_dist)
         {
             best_medoid = medoids[cur_m];
@@ -2020,37 +2052,40 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_async(const T *query, const
         }
     }
 
-    compute_dists(&best_medoid, 1, dist_scratch.get());
+    compute_dists(&best_medoid, 1, dist_scratch);
     visited.insert(best_medoid);
 
     uint64_t has_searched = 0;
-    std::priority_queue<Neighbor> candidate_queue;
-    candidate_queue.push(Neighbor(best_medoid, -dist_scratch[0]));
+    // max-heap of candidates keyed by negated distance, i.e. the closest on top
+    std::vector<Neighbor> &candidates = query_scratch->candidates;
+    candidates.emplace_back(best_medoid, -dist_scratch[0]);
 
     // Async IO
-    std::shared_ptr<char[]> cache_sectors;
+    char *cache_sectors = nullptr;
     std::map<uint32_t, int> cache_loc;
     std::vector<std::future<bool>> futures;
     int max_io_count = std::max(l_search, (const uint64_t) io_limit) / beam_width + 1;
     std::vector<std::promise<bool>> promises(max_io_count);
     if (reorder) {
-        cache_sectors.reset(new char[sector_len * l_search]);
+        query_scratch->reserve_sectors(l_search, sector_len);
+        cache_sectors = query_scratch->sector_scratch;
     }
 
     std::vector<AlignedRead> sorted_read_reqs;
     while (has_searched < l_search)
     {
-        if (candidate_queue.empty()) {
+        if (candidates.empty()) {
             break; // TODO: add logger for the break (the graph is not connective)
         }
-        auto nbr = candidate_queue.top();
+        std::pop_heap(candidates.begin(), candidates.end());
+        auto nbr = candidates.back();
         full_retset.push_back({nbr.id, -nbr.distance});
-        candidate_queue.pop();
+        candidates.pop_back();
         auto nohood_id = nbr.id;
 
         if (reorder) {
             sorted_read_reqs.emplace_back(NODE_SECTOR_NO(((size_t)nohood_id)) * sector_len, sector_len,
-                                          cache_sectors.get() + has_searched * sector_len);
+                                          cache_sectors + has_searched * sector_len);
             if (sorted_read_reqs.size() >= beam_width || has_searched == l_search - 1) {
                 int io_count = has_searched / beam_width;
                 if (stats != nullptr) {
@@ -2078,7 +2113,8 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_async(const T *query, const
         uint32_t *node_nbrs = final_graph[nohood_id].data();
         size_t nnbrs = final_graph[nohood_id].size();
 
-        std::vector<uint32_t> unseen_ids;
+        std::vector<uint32_t> &unseen_ids = query_scratch->unseen_ids;
+        unseen_ids.clear();
         for (uint64_t m = 0; m < nnbrs; ++m)
         {
             uint32_t id = node_nbrs[m];
@@ -2088,11 +2124,12 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_async(const T *query, const
             }
         }
         if (unseen_ids.size() != 0) {
-            compute_dists(unseen_ids.data(), unseen_ids.size(), dist_scratch.get());
+            compute_dists(unseen_ids.data(), unseen_ids.size(), dist_scratch);
             for (uint64_t i = 0; i < unseen_ids.size(); ++i)
             {
                 float dist = dist_scratch[i];
-                candidate_queue.emplace(unseen_ids[i], -dist);
+                candidates.emplace_back(unseen_ids[i], -dist);
+                std::push_heap(candidates.begin(), candidates.end());
             }
         }
         has_searched ++;
@@ -2118,10 +2155,10 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search_async(const T *query, const
 
             if (not use_bsa || reorder_retset.empty() || reorder_retset.size() < k_search ||
                 distance_ranks.top() + this->errors[id] > full_retset[j].distance) {
-                char *node_disk_buf = OFFSET_TO_NODE(cache_sectors.get() + loc * sector_len, id);
+                char *node_disk_buf = OFFSET_TO_NODE(cache_sectors + loc * sector_len, id);
                 T *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
                 float exact_dist;
-                exact_dist = dist_cmp_float->compare((float *)aligned_query_T.get(), (float *)node_fp_coords, (uint32_t)data_dim);
+                exact_dist = dist_cmp_float->compare((float *)aligned_query_T, (float *)node_fp_coords, (uint32_t)data_dim);
                 if (stats != nullptr)
                 {
                     stats->n_cmps += 1;
@@ -87,6 +87,26 @@ template <typename T> InMemQueryScratch<T>::~InMemQueryScratch()
 template <typename T> void SSDQueryScratch<T>::reset()
 {
     sector_idx = 0;
+    visited.clear();
+    full_retset.clear();
+    retset.clear();
+    candidates.clear();
+    unseen_ids.clear();
+    frontier.clear();
+    frontier_nhoods.clear();
+    frontier_read_reqs.clear();
+}
+
+template <typename T> void SSDQueryScratch<T>::reserve_sectors(size_t num_sectors, size_t sector_len)
+{
+    size_t required = ROUND_UP(num_sectors * sector_len, SECTOR_LEN);
+    if (required <= sector_scratch_len)
+    {
+        return;
+    }
+    diskann::aligned_free((void *)sector_scratch);
+    diskann::alloc_aligned((void **)&sector_scratch, required, SECTOR_LEN);
+    sector_scratch_len = required;
 }
 
 template <typename T> SSDQueryScratch<T>::SSDQueryScratch(size_t max_degree, size_t aligned_dim, size_t pq_chunk)
@@ -106,6 +126,7 @@ template <typename T> SSDQueryScratch<T>::~SSDQueryScratch()
 {
     diskann::aligned_free((void *)coord_scratch);
     diskann::aligned_free((void *)aligned_query_T);
+    diskann::aligned_free((void *)sector_scratch);
 
     delete _pq_scratch;
 }
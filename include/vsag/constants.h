@@ -55,6 +55,7 @@ extern const char* const BLANK_INDEX;
 extern const char* const PARAMETER_DTYPE;
 extern const char* const PARAMETER_DIM;
 extern const char* const PARAMETER_METRIC_TYPE;
+extern const char* const PARAMETER_QUERY_CACHE_SIZE;
 extern const char* const PARAMETER_USE_CONJUGATE_GRAPH;
 extern const char* const PARAMETER_USE_CONJUGATE_GRAPH_SEARCH;
 
@@ -68,6 +69,8 @@ extern const char* const DISKANN_PARAMETER_USE_OPQ;
 extern const char* const DISKANN_PARAMETER_USE_ASYNC_IO;
 extern const char* const DISKANN_PARAMETER_USE_BSA;
 extern const char* const DISKANN_PARAMETER_GRAPH_TYPE;
+extern const char* const DISKANN_PARAMETER_LAYOUT_PATH;
+extern const char* const DISKANN_PARAMETER_BUILD_MEMORY_BUDGET;
 extern const char* const ODESCENT_PARAMETER_ALPHA;
 extern const char* const ODESCENT_PARAMETER_GRAPH_ITER_TURN;
 extern const char* const ODESCENT_PARAMETER_NEIGHBOR_SAMPLE_RATE;
@@ -109,6 +112,11 @@ extern const char* const STATSTIC_RANGE_IO;
 extern const char* const STATSTIC_RANGE_HOP;
 extern const char* const STATSTIC_RANGE_CACHE_HIT;
 extern const char* const STATSTIC_RANGE_IO_TIME;
+extern const char* const STATSTIC_SEARCH_PLAN_GRAPH;
+extern const char* const STATSTIC_SEARCH_PLAN_FILTERED_EXPANSION;
+extern const char* const STATSTIC_SEARCH_PLAN_EXACT_SCAN;
+extern const char* const STATSTIC_QUERY_CACHE_HIT;
+extern const char* const STATSTIC_QUERY_CACHE_MISS;
 
 //Error message
 extern const char* const MESSAGE_PARAMETER;
@@ -136,6 +144,10 @@ extern const char* const HGRAPH_PRECISE_FILE_PATH;
 extern const char* const HGRAPH_PARAMETER_EF_RUNTIME;
 extern const char* const HGRAPH_EXTRA_INFO_SIZE;
 extern const char* const HGRAPH_USE_EXTRA_INFO_FILTER;
+extern const char* const HGRAPH_GRAPH_TYPE;
+extern const char* const HGRAPH_PARAMETER_TARGET_RECALL;
+extern const char* const HGRAPH_PARAMETER_ENTRY_POINT_COUNT;
+extern const char* const HGRAPH_PARAMETER_USE_FILTERED_EXPANSION;
 
 extern const char* const BRUTE_FORCE_QUANTIZATION_TYPE;
 extern const char* const BRUTE_FORCE_IO_TYPE;
@@ -15,8 +15,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
+#include "bitset.h"
+
 namespace vsag {
 
 class Filter {
@@ -26,6 +29,12 @@ public:
         RELATED_TO_VECTOR,
     };
 
+    enum class BitsetSpace {
+        NONE = 0,  // not a bitset filter, CheckValid is called per vector
+        LABEL,     // bit i marks the vector whose label is i
+        INNER_ID,  // bit i marks the vector whose inner id is i
+    };
+
 public:
     /**
       * @brief Check if a vector is filtered out by pre-filter, true means
@@ -71,6 +80,44 @@ public:
     FilterDistribution() const {
         return Distribution::NONE;  // (default) no distribution information hints provides
     }
+
+    /**
+      * @brief Get the bitset of filtered-out vectors. When a filter provides one, the
+      * index translates it into an inner-id bitmap once (cached by Version()) and
+      * tests candidates with a bit probe instead of calling CheckValid
+      *
+      * @return the bitset of invalid ids, nullptr means not a bitset filter
+      */
+    [[nodiscard]] virtual BitsetPtr
+    InvalidBitset() const {
+        return nullptr;  // (default) not a bitset filter
+    }
+
+    /**
+      * @brief Get the id space of the bitset returned by InvalidBitset
+      *
+      * @return id space of the bitset
+      */
+    [[nodiscard]] virtual BitsetSpace
+    InvalidBitsetSpace() const {
+        return BitsetSpace::NONE;
+    }
+
+    // a version for bitsets that may change at any time, the index never reuses their
+    // translation and tests them per candidate instead
+    static constexpr uint64_t UNSTABLE_VERSION = UINT64_MAX;
+
+    /**
+      * @brief Get the version of the bitset content, the index reuses the translated
+      * bitmap as long as the version is unchanged, so it must be increased whenever
+      * the bitset is modified
+      *
+      * @return version of the bitset, or UNSTABLE_VERSION if it is not tracked
+      */
+    [[nodiscard]] virtual uint64_t
+    Version() const {
+        return 0;
+    }
 };
 
 using FilterPtr = std::shared_ptr<Filter>;
@@ -32,12 +32,16 @@
 #include "vsag/index_features.h"
 #include "vsag/iterator_context.h"
 #include "vsag/readerset.h"
+#include "vsag/search_cursor.h"
+#include "vsag/search_param.h"
 
 namespace vsag {
 
 class Index;
 using IndexPtr = std::shared_ptr<Index>;
 using IdMapFunction = std::function<std::tuple<bool, int64_t>(int64_t)>;
+// returns the next chunk of a stream of vectors, nullptr when the stream is exhausted
+using DatasetStream = std::function<DatasetPtr()>;
 
 struct MergeUnit {
     IndexPtr index = nullptr;
@@ -96,6 +100,20 @@ public:
         throw std::runtime_error("Index not support adding vectors");
     }
 
+    /**
+      * @brief Adding vectors pulled chunk by chunk from a stream, each chunk is inserted in
+      * parallel and released before the next one is pulled, so the peak memory is the index
+      * plus one chunk
+      *
+      * @param next_chunk returns datasets that contain dim, num_elements, ids and vectors, and
+      * nullptr after the last one
+      * @return IDs that failed to insert into the index
+      */
+    virtual tl::expected<std::vector<int64_t>, Error>
+    AddStream(const DatasetStream& next_chunk) {
+        throw std::runtime_error("Index not support adding vectors from a stream");
+    }
+
     /**
       * @brief Remove the vector corresponding to the given ID from the index
       *
@@ -204,6 +222,103 @@ public:
         throw std::runtime_error("Index doesn't support new filter");
     }
 
+    /**
+      * @brief Compile the search parameters once for repeated searches
+      *
+      * @param parameters the json string accepted by KnnSearch and RangeSearch
+      * @return an immutable handle, valid for every search on this index
+      */
+    virtual tl::expected<SearchParamPtr, Error>
+    CompileSearchParam(const std::string& parameters) const {
+        return std::make_shared<SearchParam>(parameters);
+    }
+
+    /**
+      * @brief Performing single KNN search on index with compiled search parameters
+      *
+      * @param query should contains dim, num_elements and vectors
+      * @param k the result size of every query
+      * @param param is the handle returned by CompileSearchParam
+      * @param invalid represents whether an element is filtered out by pre-filter
+      * @return result contains
+      *                - num_elements: 1
+      *                - ids, distances: length is (num_elements * k)
+      */
+    [[nodiscard]] virtual tl::expected<DatasetPtr, Error>
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              BitsetPtr invalid = nullptr) const {
+        if (param == nullptr) {
+            return tl::unexpected(Error(ErrorType::INVALID_ARGUMENT, "search param is nullptr"));
+        }
+        return this->KnnSearch(query, k, param->GetParameters(), invalid);
+    }
+
+    /**
+      * @brief Performing single KNN search on index with compiled search parameters
+      *
+      * @param query should contains dim, num_elements and vectors
+      * @param k the result size of every query
+      * @param param is the handle returned by CompileSearchParam
+      * @param filter represents whether an element is filtered out by pre-filter
+      * @return result contains
+      *                - num_elements: 1
+      *                - ids, distances: length is (num_elements * k)
+      */
+    virtual tl::expected<DatasetPtr, Error>
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const std::function<bool(int64_t)>& filter) const {
+        if (param == nullptr) {
+            return tl::unexpected(Error(ErrorType::INVALID_ARGUMENT, "search param is nullptr"));
+        }
+        return this->KnnSearch(query, k, param->GetParameters(), filter);
+    }
+
+    /**
+      * @brief Performing single KNN search on index with compiled search parameters
+      *
+      * @param query should contains dim, num_elements and vectors
+      * @param k the result size of every query
+      * @param param is the handle returned by CompileSearchParam
+      * @param filter represents whether an element is filtered out by pre-filter
+      * @return result contains
+      *                - num_elements: 1
+      *                - ids, distances: length is (num_elements * k)
+      */
+    virtual tl::expected<DatasetPtr, Error>
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const FilterPtr& filter) const {
+        if (param == nullptr) {
+            return tl::unexpected(Error(ErrorType::INVALID_ARGUMENT, "search param is nullptr"));
+        }
+        return this->KnnSearch(query, k, param->GetParameters(), filter);
+    }
+
+    /**
+      * @brief Open a cursor that returns the neighbors of a query page by page
+      *
+      * Unlike the iterator filter search, the cursor keeps the candidate frontier and the
+      * visited set between pages, so deep pages do not search the graph again. The frontier is
+      * bounded by a multiple of ef_search, so a deep pagination may miss far results.
+      *
+      * @param query should contains dim, num_elements and vectors, num_elements must be 1
+      * @param parameters the json string accepted by KnnSearch, ef_search is the lookahead
+      *                   of every page
+      * @param filter represents whether an element is filtered out by pre-filter
+      * @return a cursor, see SearchCursor::Next
+      */
+    virtual tl::expected<SearchCursorPtr, Error>
+    OpenSearchCursor(const DatasetPtr& query,
+                     const std::string& parameters,
+                     const FilterPtr& filter = nullptr) const {
+        throw std::runtime_error("Index doesn't support OpenSearchCursor");
+    }
+
     /**
       * @brief Performing single range search on index
       *
@@ -292,6 +407,116 @@ public:
         throw std::runtime_error("Index doesn't support new filter");
     }
 
+    /**
+      * @brief Performing single range search on index with compiled search parameters
+      *
+      * @param query should contains dim, num_elements and vectors
+      * @param radius of search, determines which results will be returned
+      * @param param is the handle returned by CompileSearchParam
+      * @param limited_size of search result size.
+      *                - limited_size <= 0 : no limit
+      *                - limited_size == 0 : error
+      *                - limited_size >= 1 : limit result size to limited_size
+      * @return result contains
+      *                - num_elements: 1
+      *                - dim: the size of results
+      *                - ids, distances: length is dim
+      */
+    virtual tl::expected<DatasetPtr, Error>
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                int64_t limited_size = -1) const {
+        if (param == nullptr) {
+            return tl::unexpected(Error(ErrorType::INVALID_ARGUMENT, "search param is nullptr"));
+        }
+        return this->RangeSearch(query, radius, param->GetParameters(), limited_size);
+    }
+
+    /**
+      * @brief Performing single range search on index with compiled search parameters
+      *
+      * @param query should contains dim, num_elements and vectors
+      * @param radius of search, determines which results will be returned
+      * @param param is the handle returned by CompileSearchParam
+      * @param invalid represents whether an element is filtered out by pre-filter
+      * @param limited_size of search result size.
+      *                - limited_size <= 0 : no limit
+      *                - limited_size == 0 : error
+      *                - limited_size >= 1 : limit result size to limited_size
+      * @return result contains
+      *                - num_elements: 1
+      *                - dim: the size of results
+      *                - ids, distances: length is dim
+      */
+    virtual tl::expected<DatasetPtr, Error>
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                BitsetPtr invalid,
+                int64_t limited_size = -1) const {
+        if (param == nullptr) {
+            return tl::unexpected(Error(ErrorType::INVALID_ARGUMENT, "search param is nullptr"));
+        }
+        return this->RangeSearch(query, radius, param->GetParameters(), invalid, limited_size);
+    }
+
+    /**
+      * @brief Performing single range search on index with compiled search parameters
+      *
+      * @param query should contains dim, num_elements and vectors
+      * @param radius of search, determines which results will be returned
+      * @param param is the handle returned by CompileSearchParam
+      * @param filter represents whether an element is filtered out by pre-filter
+      * @param limited_size of search result size.
+      *                - limited_size <= 0 : no limit
+      *                - limited_size == 0 : error
+      *                - limited_size >= 1 : limit result size to limited_size
+      * @return result contains
+      *                - num_elements: 1
+      *                - dim: the size of results
+      *                - ids, distances: length is dim
+      */
+    virtual tl::expected<DatasetPtr, Error>
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const std::function<bool(int64_t)>& filter,
+                int64_t limited_size = -1) const {
+        if (param == nullptr) {
+            return tl::unexpected(Error(ErrorType::INVALID_ARGUMENT, "search param is nullptr"));
+        }
+        return this->RangeSearch(query, radius, param->GetParameters(), filter, limited_size);
+    }
+
+    /**
+      * @brief Performing single range search on index with compiled search parameters
+      *
+      * @param query should contains dim, num_elements and vectors
+      * @param radius of search, determines which results will be returned
+      * @param param is the handle returned by CompileSearchParam
+      * @param filter represents whether an element is filtered out by pre-filter
+      * @param limited_size of search result size.
+      *                - limited_size <= 0 : no limit
+      *                - limited_size == 0 : error
+      *                - limited_size >= 1 : limit result size to limited_size
+      * @return result contains
+      *                - num_elements: 1
+      *                - dim: the size of results
+      *                - ids, distances: length is dim
+      */
+    virtual tl::expected<DatasetPtr, Error>
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const FilterPtr& filter,
+                int64_t limited_size = -1) const {
+        if (param == nullptr) {
+            return tl::unexpected(Error(ErrorType::INVALID_ARGUMENT, "search param is nullptr"));
+        }
+        return this->RangeSearch(query, radius, param->GetParameters(), filter, limited_size);
+    }
+
     /**
      * @brief Pretraining the conjugate graph involves searching with generated queries and providing feedback.
      *
@@ -320,6 +545,24 @@ public:
         throw std::runtime_error("Index doesn't support feedback");
     };
 
+    /**
+     * @brief Performing feedback on conjugate graph for a batch of queries, the searches run in
+     * parallel and the found edges are inserted into conjugate graph at the end
+     *
+     * @param queries should contains dim, num_elements and vectors
+     * @param k is the number of edges inserted into conjugate graph for each query
+     * @param global_optimum_tag_ids are the labels of exact nearest neighbor of each query, empty
+     * means they are computed by brute force
+     * @return result is the number of successful insertions into conjugate graph
+     */
+    virtual tl::expected<uint32_t, Error>
+    BatchFeedback(const DatasetPtr& queries,
+                  int64_t k,
+                  const std::string& parameters,
+                  const std::vector<int64_t>& global_optimum_tag_ids = {}) {
+        throw std::runtime_error("Index doesn't support batch feedback");
+    };
+
     /**
      * @brief Calculate the distance between the query and the vector of the given ID.
      *
@@ -72,6 +72,8 @@ enum IndexFeature {
 
     SUPPORT_EXPORT_MODEL, /**< Supports export model */
 
+    SUPPORT_SEARCH_CURSOR, /**< Supports paginated search with a resumable cursor */
+
     INDEX_FEATURE_COUNT /** must be last one */
 };
 }  // namespace vsag
@@ -0,0 +1,57 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "vsag/dataset.h"
+#include "vsag/errors.h"
+#include "vsag/expected.hpp"
+
+namespace vsag {
+
+/**
+  * @brief A paginated search opened by Index::OpenSearchCursor
+  *
+  * The cursor keeps its traversal state between pages, so the next page only pays for the
+  * nodes it explores itself. A cursor is not thread safe and must not outlive its index.
+  */
+class SearchCursor {
+public:
+    virtual ~SearchCursor() = default;
+
+    /**
+      * @brief Get the next page of results, closest first
+      *
+      * @param n the maximum number of results of the page, must be greater than 0
+      * @return result contains
+      *                - num_elements: 1
+      *                - ids, distances: length is at most n, empty once the cursor is exhausted
+      */
+    virtual tl::expected<DatasetPtr, Error>
+    Next(int64_t n) = 0;
+
+    /**
+      * @brief Check whether every reachable result has been returned
+      */
+    [[nodiscard]] virtual bool
+    Exhausted() const = 0;
+};
+
+using SearchCursorPtr = std::shared_ptr<SearchCursor>;
+
+}  // namespace vsag
@@ -0,0 +1,52 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace vsag {
+
+/**
+  * @brief Search parameters compiled once by Index::CompileSearchParam
+  *
+  * A handle is immutable and can be shared by concurrent searches. Indexes that parse their
+  * parameters in advance return a subclass; the base class only keeps the json string, which
+  * is parsed again by every search.
+  */
+class SearchParam {
+public:
+    explicit SearchParam(std::string parameters) : parameters_(std::move(parameters)) {
+    }
+
+    virtual ~SearchParam() = default;
+
+    /**
+      * @brief Get the json string the handle was compiled from
+      */
+    [[nodiscard]] const std::string&
+    GetParameters() const {
+        return parameters_;
+    }
+
+private:
+    const std::string parameters_;
+};
+
+using SearchParamPtr = std::shared_ptr<const SearchParam>;
+
+}  // namespace vsag
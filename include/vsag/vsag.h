@@ -49,4 +49,6 @@ init();
 #include "logger.h"
 #include "options.h"
 #include "readerset.h"
+#include "search_cursor.h"
+#include "search_param.h"
 #include "utils.h"
@@ -24,7 +24,13 @@
 #include "data_cell/sparse_graph_datacell.h"
 #include "dataset_impl.h"
 #include "empty_index_binary_set.h"
+#include "impl/compiled_search_param.h"
+#include "impl/graph_search_cursor.h"
+#include "impl/odescent_graph_builder.h"
 #include "impl/pruning_strategy.h"
+#include "impl/reorder.h"
+#include "impl/search_planner.h"
+#include "index/index_impl.h"
 #include "index/iterator_filter.h"
 #include "logger.h"
 #include "utils/slow_task_timer.h"
@@ -32,6 +38,30 @@
 
 namespace vsag {
 
+static constexpr uint64_t UPDATE_CHECK_SEARCH_K = 10;
+
+static constexpr uint64_t UPDATE_CHECK_SEARCH_L = 100;
+
+static constexpr uint64_t MIN_EARLY_STOP_PATIENCE = 16;
+
+// the ef of the lowest route graph search that collects several entry points, per entry point
+static constexpr uint64_t ENTRY_POINT_EF_FACTOR = 2;
+
+// the expansions without a new top-k result before an adaptive search stops: a higher target
+//  recall waits longer, and a larger k needs longer to settle
+static uint64_t
+early_stop_patience(int64_t k, float target_recall) {
+    if (target_recall >= 1.0F) {
+        return 0;
+    }
+    auto patience = std::ceil(static_cast<double>(k) * -std::log(1.0 - target_recall));
+    return std::max(MIN_EARLY_STOP_PATIENCE, static_cast<uint64_t>(patience));
+}
+
+// written in place of the label remap size, the remap follows as flat slot arrays; older
+//  binaries store the size and then every (label, inner id) pair
+static constexpr uint64_t FLAT_LABEL_REMAP = std::numeric_limits<uint64_t>::max();
+
 static uint64_t
 next_multiple_of_power_of_two(uint64_t x, uint64_t n) {
     if (n > 63) {
@@ -44,12 +74,16 @@ next_multiple_of_power_of_two(uint64_t x, uint64_t n) {
 
 HGraph::HGraph(const HGraphParameterPtr& hgraph_param, const vsag::IndexCommonParam& common_param)
     : InnerIndexInterface(hgraph_param, common_param),
-      route_graphs_(common_param.allocator_.get()),
+      route_(std::make_shared<HGraphRoute>(common_param.allocator_.get())),
       use_reorder_(hgraph_param->use_reorder),
       ignore_reorder_(hgraph_param->ignore_reorder),
       ef_construct_(hgraph_param->ef_construction),
+      odescent_param_(hgraph_param->odescent_param),
       build_thread_count_(hgraph_param->build_thread_count),
-      extra_info_size_(common_param.extra_info_size_) {
+      extra_info_size_(common_param.extra_info_size_),
+      tombstones_(std::make_shared<TombstoneTable>(0, common_param.allocator_.get())),
+      pending_repair_ids_(common_param.allocator_.get()),
+      free_slots_(common_param.allocator_.get()) {
     neighbors_mutex_ = std::make_shared<PointsMutex>(0, common_param.allocator_.get());
     this->basic_flatten_codes_ =
         FlattenInterface::MakeInstance(hgraph_param->base_codes_param, common_param);
@@ -84,6 +118,14 @@ HGraph::HGraph(const HGraphParameterPtr& hgraph_param, const vsag::IndexCommonPa
         this->build_pool_ = SafeThreadPool::FactoryDefaultThreadPool();
     }
 }
+
+HGraph::~HGraph() {
+    // the scheduled repair refers to this index
+    std::lock_guard lock(this->repair_mutex_);
+    if (this->repair_future_.valid()) {
+        this->repair_future_.wait();
+    }
+}
 void
 HGraph::Train(const DatasetPtr& base) {
     this->basic_flatten_codes_->Train(base->GetFloat32Vectors(), base->GetNumElements());
@@ -101,7 +143,12 @@ HGraph::Build(const DatasetPtr& data) {
     this->Train(data);
     auto new_size = this->max_capacity_.load() + 1;
     this->resize(new_size);
-    auto ret = this->Add(data);
+    std::vector<int64_t> ret;
+    if (this->odescent_param_ != nullptr and this->total_count_ == 0) {
+        ret = this->build_by_odescent(data);
+    } else {
+        ret = this->Add(data);
+    }
     this->basic_flatten_codes_->DisableForceInMemory();
     if (use_reorder_) {
         this->high_precise_codes_->DisableForceInMemory();
@@ -118,6 +165,9 @@ HGraph::Add(const DatasetPtr& data) {
                    fmt::format("base.dim({}) must be equal to index.dim({})", base_dim, dim_));
     CHECK_ARGUMENT(data->GetFloat32Vectors() != nullptr, "base.float_vector is nullptr");
 
+    if (this->repair_requested_.exchange(false)) {
+        this->repair_deleted();
+    }
     {
         std::lock_guard lock(this->add_mutex_);
         if (this->total_count_ == 0) {
@@ -125,67 +175,260 @@ HGraph::Add(const DatasetPtr& data) {
         }
     }
 
-    auto add_func =
-        [&](const float* data, int level, InnerIdType inner_id, const char* extra_info) -> void {
-        if (this->extra_infos_ != nullptr) {
-            this->extra_infos_->InsertExtraInfo(extra_info, inner_id);
-        }
-        this->add_one_point(data, level, inner_id);
-    };
-
-    std::vector<std::future<void>> futures;
     auto total = data->GetNumElements();
     const auto* labels = data->GetIds();
     const auto* vectors = data->GetFloat32Vectors();
     const auto* extra_infos = data->GetExtraInfos();
-    Vector<std::pair<InnerIdType, LabelType>> inner_ids(allocator_);
-    for (int64_t j = 0; j < total; ++j) {
-        auto label = labels[j];
-        InnerIdType inner_id;
-        {
-            std::lock_guard label_lock(this->label_lookup_mutex_);
-            if (this->label_table_->CheckLabel(label)) {
+
+    // assign the inner ids, labels and levels of the whole batch in one step
+    Vector<std::pair<InnerIdType, int64_t>> inner_ids(allocator_);
+    Vector<int> levels(allocator_);
+    bool reuse_slot = false;
+    {
+        std::lock_guard label_lock(this->label_lookup_mutex_);
+        std::lock_guard lock(this->add_mutex_);
+        Vector<int64_t> accepted(allocator_);
+        UnorderedSet<LabelType> batch_labels(allocator_);
+        accepted.reserve(total);
+        for (int64_t j = 0; j < total; ++j) {
+            auto label = labels[j];
+            if (this->label_table_->CheckLabel(label) or not batch_labels.emplace(label).second) {
                 failed_ids.emplace_back(label);
                 continue;
             }
-            {
-                std::lock_guard lock(this->add_mutex_);
-                inner_id = this->get_unique_inner_ids(1).at(0);
-                uint64_t new_count = total_count_;
-                this->resize(new_count);
+            accepted.emplace_back(j);
+        }
+
+        // the slots freed by repair_deleted are used first, the rest is reserved at once
+        auto reuse_count = std::min<uint64_t>(accepted.size(), this->free_slots_.size());
+        auto new_count = static_cast<InnerIdType>(accepted.size() - reuse_count);
+        Vector<InnerIdType> new_ids(allocator_);
+        if (new_count > 0) {
+            new_ids = this->get_unique_inner_ids(new_count);
+            this->resize(total_count_);
+        }
+        reuse_slot = reuse_count > 0;
+        this->deleted_count_ -= reuse_count;
+
+        inner_ids.reserve(accepted.size());
+        levels.reserve(accepted.size());
+        for (uint64_t i = 0; i < accepted.size(); ++i) {
+            InnerIdType inner_id;
+            if (i < reuse_count) {
+                // the slot stays FREED until the new vector is linked, see graph_add_one
+                inner_id = this->free_slots_.back();
+                this->free_slots_.pop_back();
+            } else {
+                inner_id = new_ids[i - reuse_count];
             }
-            this->label_table_->Insert(inner_id, label);
-            inner_ids.emplace_back(inner_id, j);
+            this->label_table_->Insert(inner_id, labels[accepted[i]]);
+            inner_ids.emplace_back(inner_id, accepted[i]);
+            levels.emplace_back(this->get_random_level() - 1);
         }
     }
-    for (auto& [inner_id, local_idx] : inner_ids) {
-        int level;
-        {
-            std::lock_guard label_lock(this->label_lookup_mutex_);
-            level = this->get_random_level() - 1;
-        }
-        const auto* extra_info = extra_infos + local_idx * extra_info_size_;
-        if (this->build_pool_ != nullptr) {
-            auto future = this->build_pool_->GeneralEnqueue(
-                add_func, vectors + local_idx * dim_, level, inner_id, extra_info);
-            futures.emplace_back(std::move(future));
-        } else {
-            add_func(vectors + local_idx * dim_, level, inner_id, extra_info);
-        }
+    if (reuse_slot) {
+        // cached label bitmaps still map the reused slots to their old labels
+        this->bitmap_cache_->Clear();
     }
-    if (this->build_pool_ != nullptr) {
+
+    // every worker claims chunks of the batch through a shared cursor
+    std::atomic<uint64_t> cursor{0};
+    uint64_t count = inner_ids.size();
+    auto add_func = [&]() -> void {
+        while (true) {
+            auto begin = cursor.fetch_add(ADD_CHUNK_SIZE);
+            if (begin >= count) {
+                break;
+            }
+            auto end = std::min(begin + ADD_CHUNK_SIZE, count);
+            for (auto i = begin; i < end; ++i) {
+                auto [inner_id, local_idx] = inner_ids[i];
+                if (this->extra_infos_ != nullptr) {
+                    this->extra_infos_->InsertExtraInfo(extra_infos + local_idx * extra_info_size_,
+                                                        inner_id);
+                }
+                this->add_one_point(vectors + local_idx * dim_, levels[i], inner_id);
+            }
+        }
+    };
+
+    auto task_count = std::min(this->build_thread_count_,
+                               (count + ADD_CHUNK_SIZE - 1) / ADD_CHUNK_SIZE);
+    if (this->build_pool_ != nullptr and task_count > 1) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(task_count);
+        for (uint64_t i = 0; i < task_count; ++i) {
+            futures.emplace_back(this->build_pool_->GeneralEnqueue(add_func));
+        }
         for (auto& future : futures) {
             future.get();
         }
+    } else {
+        add_func();
+    }
+    return failed_ids;
+}
+
+std::vector<int64_t>
+HGraph::build_by_odescent(const DatasetPtr& data) {
+    std::vector<int64_t> failed_ids;
+    auto base_dim = data->GetDim();
+    CHECK_ARGUMENT(base_dim == dim_,
+                   fmt::format("base.dim({}) must be equal to index.dim({})", base_dim, dim_));
+    CHECK_ARGUMENT(data->GetFloat32Vectors() != nullptr, "base.float_vector is nullptr");
+
+    auto total = data->GetNumElements();
+    const auto* labels = data->GetIds();
+    const auto* vectors = data->GetFloat32Vectors();
+    const auto* extra_infos = data->GetExtraInfos();
+
+    // the index is empty, only labels repeated inside the batch fail
+    Vector<int64_t> accepted(allocator_);
+    UnorderedSet<LabelType> batch_labels(allocator_);
+    accepted.reserve(total);
+    for (int64_t j = 0; j < total; ++j) {
+        if (not batch_labels.emplace(labels[j]).second) {
+            failed_ids.emplace_back(labels[j]);
+            continue;
+        }
+        accepted.emplace_back(j);
+    }
+    if (accepted.empty()) {
+        return failed_ids;
+    }
+
+    std::lock_guard label_lock(this->label_lookup_mutex_);
+    std::lock_guard lock(this->add_mutex_);
+    auto inner_ids = this->get_unique_inner_ids(static_cast<InnerIdType>(accepted.size()));
+    this->resize(total_count_);
+    Vector<int> levels(accepted.size(), 0, allocator_);
+    int max_level = -1;
+    for (uint64_t i = 0; i < accepted.size(); ++i) {
+        auto local_idx = accepted[i];
+        auto inner_id = inner_ids[i];
+        this->label_table_->Insert(inner_id, labels[local_idx]);
+        this->basic_flatten_codes_->InsertVector(vectors + local_idx * dim_, inner_id);
+        if (use_reorder_) {
+            this->high_precise_codes_->InsertVector(vectors + local_idx * dim_, inner_id);
+        }
+        if (this->extra_infos_ != nullptr) {
+            this->extra_infos_->InsertExtraInfo(extra_infos + local_idx * extra_info_size_,
+                                                inner_id);
+        }
+        levels[i] = this->get_random_level() - 1;
+        max_level = std::max(max_level, levels[i]);
     }
+
+    auto flatten_codes = basic_flatten_codes_;
+    if (use_reorder_) {
+        flatten_codes = high_precise_codes_;
+    }
+    this->build_graph_by_odescent(
+        inner_ids, this->bottom_graph_, flatten_codes, this->odescent_param_);
+
+    // each route level holds the vectors sampled to it, the same levels an insertion build draws
+    auto route = std::make_shared<HGraphRoute>(allocator_);
+    route->entry_point_id = inner_ids[0];
+    for (int level = 0; level <= max_level; ++level) {
+        Vector<InnerIdType> level_ids(allocator_);
+        for (uint64_t i = 0; i < accepted.size(); ++i) {
+            if (levels[i] >= level) {
+                level_ids.emplace_back(inner_ids[i]);
+            }
+        }
+        auto route_graph = this->generate_one_route_graph();
+        this->build_graph_by_odescent(level_ids, route_graph, flatten_codes, this->odescent_param_);
+        route->route_graphs.emplace_back(route_graph);
+        route->entry_point_id = level_ids[0];
+    }
+    std::atomic_store(&this->route_, HGraphRoutePtr(route));
     return failed_ids;
 }
 
+void
+HGraph::build_graph_by_odescent(const Vector<InnerIdType>& ids,
+                                const GraphInterfacePtr& graph,
+                                const FlattenInterfacePtr& flatten,
+                                const ODescentParameterPtr& odescent_param,
+                                const GraphInterfacePtr& seed_graph) {
+    // odescent keeps twice the degree as candidates, the heuristic then chooses the edges
+    auto max_degree = graph->MaximumDegree();
+    auto param = std::make_shared<ODescentParameter>(*odescent_param);
+    param->max_degree = static_cast<int64_t>(max_degree) * 2;
+    GraphInterfacePtr candidates =
+        std::make_shared<SparseGraphDataCell>(allocator_, static_cast<uint32_t>(param->max_degree));
+    ODescent graph_builder(param, flatten, allocator_, this->build_pool_.get());
+    graph_builder.Build(ids, seed_graph);
+    graph_builder.SaveGraph(candidates);
+
+    auto prune_func = [&](uint64_t begin, uint64_t end) -> void {
+        Vector<InnerIdType> neighbors(allocator_);
+        Vector<InnerIdType> edges(allocator_);
+        for (auto i = begin; i < end; ++i) {
+            auto inner_id = ids[i];
+            neighbors.clear();
+            candidates->GetNeighbors(inner_id, neighbors);
+            MaxHeap heap(allocator_);
+            for (const auto& neighbor_id : neighbors) {
+                heap.emplace(flatten->ComputePairVectors(inner_id, neighbor_id), neighbor_id);
+            }
+            select_edges_by_heuristic(heap, max_degree, flatten, allocator_);
+            while (heap.size() > max_degree) {
+                heap.pop();
+            }
+            edges.clear();
+            while (not heap.empty()) {
+                edges.emplace_back(heap.top().second);
+                heap.pop();
+            }
+            LockGuard lock(neighbors_mutex_, inner_id);
+            graph->InsertNeighborsById(inner_id, edges);
+        }
+    };
+
+    uint64_t count = ids.size();
+    if (this->build_pool_ == nullptr) {
+        prune_func(0, count);
+        return;
+    }
+    std::vector<std::future<void>> futures;
+    for (uint64_t begin = 0; begin < count; begin += PRUNE_BLOCK_SIZE) {
+        auto end = std::min(begin + PRUNE_BLOCK_SIZE, count);
+        futures.emplace_back(this->build_pool_->GeneralEnqueue(prune_func, begin, end));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
 DatasetPtr
 HGraph::KnnSearch(const DatasetPtr& query,
                   int64_t k,
                   const std::string& parameters,
                   const FilterPtr& filter) const {
+    auto params = HGraphSearchParameters::FromJson(parameters);
+    return this->knn_search(query, k, params, filter);
+}
+
+SearchParamPtr
+HGraph::CompileSearchParam(const std::string& parameters) const {
+    return CompiledSearchParam<HGraphSearchParameters>::Compile(parameters);
+}
+
+DatasetPtr
+HGraph::KnnSearch(const DatasetPtr& query,
+                  int64_t k,
+                  const SearchParamPtr& param,
+                  const FilterPtr& filter) const {
+    auto params = CompiledSearchParam<HGraphSearchParameters>::Resolve(param);
+    return this->knn_search(query, k, params, filter);
+}
+
+DatasetPtr
+HGraph::knn_search(const DatasetPtr& query,
+                   int64_t k,
+                   const HGraphSearchParameters& params,
+                   const FilterPtr& filter) const {
     int64_t query_dim = query->GetDim();
     CHECK_ARGUMENT(query_dim == dim_,
                    fmt::format("query.dim({}) must be equal to index.dim({})", query_dim, dim_));
@@ -196,37 +439,50 @@ HGraph::KnnSearch(const DatasetPtr& query,
     // check query vector
     CHECK_ARGUMENT(query->GetNumElements() == 1, "query dataset should contain 1 vector only");
 
-    InnerSearchParam search_param;
-    search_param.ep = this->entry_point_id_;
-    search_param.topk = 1;
-    search_param.ef = 1;
-    search_param.is_inner_id_allowed = nullptr;
-    for (auto i = static_cast<int64_t>(this->route_graphs_.size() - 1); i >= 0; --i) {
-        auto result = this->search_one_graph(query->GetFloat32Vectors(),
-                                             this->route_graphs_[i],
-                                             this->basic_flatten_codes_,
-                                             search_param);
-        search_param.ep = result.top().second;
-    }
+    // keeps resize, repair and merge from rewriting the graphs under the search
+    std::shared_lock global_lock(this->global_mutex_);
+    auto ft = this->make_search_filter(filter, params.use_extra_info_filter);
+
+    auto ef = static_cast<uint64_t>(std::max(params.ef_search, k));
+    auto valid_ratio = SearchPlanner::EstimateValidRatio(ft);
+    auto plan = SearchPlanner::Plan(
+        ft,
+        valid_ratio,
+        SearchPlanner::GraphSearchCost(
+            ef, this->bottom_graph_->MaximumDegree(), valid_ratio, this->total_count_),
+        SearchPlanner::ExactScanCost(ft, valid_ratio, this->total_count_),
+        params.use_filtered_expansion);
+    this->search_plan_stats_.Record(plan);
 
-    auto params = HGraphSearchParameters::FromJson(parameters);
-    FilterPtr ft = nullptr;
-    if (filter != nullptr) {
-        if (params.use_extra_info_filter) {
-            ft = std::make_shared<CommonExtraInfoFilter>(filter, this->extra_infos_);
-        } else {
-            ft = std::make_shared<CommonInnerIdFilter>(filter, *this->label_table_);
-        }
+    MaxHeap search_result(allocator_);
+    if (plan == SearchPlan::EXACT_SCAN) {
+        search_result =
+            this->scan_valid_ids(query->GetFloat32Vectors(), ft, static_cast<int64_t>(ef));
+    } else {
+        InnerSearchParam search_param;
+        Vector<InnerIdType> extra_eps(allocator_);
+        search_param.ep = this->search_entry_points(query->GetFloat32Vectors(),
+                                                    *this->load_route(),
+                                                    this->basic_flatten_codes_,
+                                                    params.entry_point_count,
+                                                    extra_eps);
+        search_param.extra_eps = extra_eps.data();
+        search_param.extra_ep_count = extra_eps.size();
+        search_param.ef = ef;
+        search_param.is_inner_id_allowed = ft;
+        search_param.topk = static_cast<int64_t>(search_param.ef);
+        search_param.filtered_expansion = (plan == SearchPlan::FILTERED_EXPANSION);
+        search_param.early_stop_patience = early_stop_patience(k, params.target_recall);
+        search_param.early_stop_k = k;
+        search_result = this->search_one_graph(query->GetFloat32Vectors(),
+                                               this->bottom_graph_,
+                                               this->basic_flatten_codes_,
+                                               search_param);
     }
 
-    search_param.ef = std::max(params.ef_search, k);
-    search_param.is_inner_id_allowed = ft;
-    search_param.topk = static_cast<int64_t>(search_param.ef);
-    auto search_result = this->search_one_graph(
-        query->GetFloat32Vectors(), this->bottom_graph_, this->basic_flatten_codes_, search_param);
-
     if (use_reorder_) {
-        this->reorder(query->GetFloat32Vectors(), this->high_precise_codes_, search_result, k);
+        reorder_candidates(
+            query->GetFloat32Vectors(), this->high_precise_codes_, search_result, k, allocator_);
     }
 
     while (search_result.size() > k) {
@@ -278,14 +534,8 @@ HGraph::KnnSearch(const DatasetPtr& query,
 
     auto params = HGraphSearchParameters::FromJson(parameters);
 
-    FilterPtr ft = nullptr;
-    if (filter != nullptr) {
-        if (params.use_extra_info_filter) {
-            ft = std::make_shared<CommonExtraInfoFilter>(filter, this->extra_infos_);
-        } else {
-            ft = std::make_shared<CommonInnerIdFilter>(filter, *this->label_table_);
-        }
-    }
+    std::shared_lock global_lock(this->global_mutex_);
+    auto ft = this->make_search_filter(filter, params.use_extra_info_filter);
 
     if (iter_ctx == nullptr) {
         auto cur_count = this->bottom_graph_->TotalCount();
@@ -309,18 +559,11 @@ HGraph::KnnSearch(const DatasetPtr& query,
         }
     } else {
         InnerSearchParam search_param;
-        search_param.ep = this->entry_point_id_;
-        search_param.topk = 1;
-        search_param.ef = 1;
-        search_param.is_inner_id_allowed = nullptr;
+        auto route = this->load_route();
+        search_param.ep = route->entry_point_id;
         if (iter_filter_ctx->IsFirstUsed()) {
-            for (auto i = static_cast<int64_t>(this->route_graphs_.size() - 1); i >= 0; --i) {
-                auto result = this->search_one_graph(query->GetFloat32Vectors(),
-                                                     this->route_graphs_[i],
-                                                     this->basic_flatten_codes_,
-                                                     search_param);
-                search_param.ep = result.top().second;
-            }
+            search_param.ep = this->search_route_graphs(
+                query->GetFloat32Vectors(), *route, this->basic_flatten_codes_);
         }
 
         search_param.ef = std::max(params.ef_search, k);
@@ -334,7 +577,8 @@ HGraph::KnnSearch(const DatasetPtr& query,
     }
 
     if (use_reorder_) {
-        this->reorder(query->GetFloat32Vectors(), this->high_precise_codes_, search_result, k);
+        reorder_candidates(
+            query->GetFloat32Vectors(), this->high_precise_codes_, search_result, k, allocator_);
     }
 
     while (search_result.size() > k) {
@@ -368,6 +612,39 @@ HGraph::KnnSearch(const DatasetPtr& query,
     return std::move(dataset_results);
 }
 
+SearchCursorPtr
+HGraph::OpenSearchCursor(const DatasetPtr& query,
+                         const std::string& parameters,
+                         const FilterPtr& filter) const {
+    int64_t query_dim = query->GetDim();
+    CHECK_ARGUMENT(query_dim == dim_,
+                   fmt::format("query.dim({}) must be equal to index.dim({})", query_dim, dim_));
+    CHECK_ARGUMENT(query->GetNumElements() == 1, "query dataset should contain 1 vector only");
+
+    auto params = HGraphSearchParameters::FromJson(parameters);
+    // the seeding runs under the global lock like a search, every later page takes it again
+    std::shared_lock global_lock(this->global_mutex_);
+    auto ft = this->make_search_filter(filter, params.use_extra_info_filter);
+    const auto* vector = query->GetFloat32Vectors();
+    auto cursor = std::make_shared<FlattenGraphSearchCursor>(
+        vector,
+        static_cast<uint64_t>(params.ef_search),
+        this->bottom_graph_,
+        this->basic_flatten_codes_,
+        this->use_reorder_ ? this->high_precise_codes_ : nullptr,
+        ft,
+        this->label_table_,
+        this->neighbors_mutex_,
+        this->global_mutex_,
+        allocator_);
+    auto route = this->load_route();
+    if (GetNumElements() > 0 and
+        route->entry_point_id != std::numeric_limits<InnerIdType>::max()) {
+        cursor->Seed(this->search_route_graphs(vector, *route, this->basic_flatten_codes_));
+    }
+    return cursor;
+}
+
 uint64_t
 HGraph::EstimateMemory(uint64_t num_elements) const {
     uint64_t estimate_memory = 0;
@@ -456,10 +733,26 @@ HGraph::RangeSearch(const DatasetPtr& query,
                     const std::string& parameters,
                     const FilterPtr& filter,
                     int64_t limited_size) const {
-    std::shared_ptr<CommonInnerIdFilter> ft = nullptr;
-    if (filter != nullptr) {
-        ft = std::make_shared<CommonInnerIdFilter>(filter, *this->label_table_);
-    }
+    auto params = HGraphSearchParameters::FromJson(parameters);
+    return this->range_search(query, radius, params, filter, limited_size);
+}
+
+DatasetPtr
+HGraph::RangeSearch(const DatasetPtr& query,
+                    float radius,
+                    const SearchParamPtr& param,
+                    const FilterPtr& filter,
+                    int64_t limited_size) const {
+    auto params = CompiledSearchParam<HGraphSearchParameters>::Resolve(param);
+    return this->range_search(query, radius, params, filter, limited_size);
+}
+
+DatasetPtr
+HGraph::range_search(const DatasetPtr& query,
+                     float radius,
+                     const HGraphSearchParameters& params,
+                     const FilterPtr& filter,
+                     int64_t limited_size) const {
     int64_t query_dim = query->GetDim();
     CHECK_ARGUMENT(query_dim == dim_,
                    fmt::format("query.dim({}) must be equal to index.dim({})", query_dim, dim_));
@@ -473,19 +766,17 @@ HGraph::RangeSearch(const DatasetPtr& query,
     CHECK_ARGUMENT(limited_size != 0,
                    fmt::format("limited_size({}) must not be equal to 0", limited_size));
 
+    std::shared_lock global_lock(this->global_mutex_);
+    auto ft = this->make_search_filter(filter, false);
     InnerSearchParam search_param;
-    search_param.ep = this->entry_point_id_;
-    search_param.topk = 1;
-    search_param.ef = 1;
-    for (auto i = static_cast<int64_t>(this->route_graphs_.size() - 1); i >= 0; --i) {
-        auto result = this->search_one_graph(query->GetFloat32Vectors(),
-                                             this->route_graphs_[i],
-                                             this->basic_flatten_codes_,
-                                             search_param);
-        search_param.ep = result.top().second;
-    }
-
-    auto params = HGraphSearchParameters::FromJson(parameters);
+    Vector<InnerIdType> extra_eps(allocator_);
+    search_param.ep = this->search_entry_points(query->GetFloat32Vectors(),
+                                                *this->load_route(),
+                                                this->basic_flatten_codes_,
+                                                params.entry_point_count,
+                                                extra_eps);
+    search_param.extra_eps = extra_eps.data();
+    search_param.extra_ep_count = extra_eps.size();
 
     search_param.ef = std::max(params.ef_search, limited_size);
     search_param.is_inner_id_allowed = ft;
@@ -495,8 +786,11 @@ HGraph::RangeSearch(const DatasetPtr& query,
     auto search_result = this->search_one_graph(
         query->GetFloat32Vectors(), this->bottom_graph_, this->basic_flatten_codes_, search_param);
     if (use_reorder_) {
-        this->reorder(
-            query->GetFloat32Vectors(), this->high_precise_codes_, search_result, limited_size);
+        reorder_candidates(query->GetFloat32Vectors(),
+                           this->high_precise_codes_,
+                           search_result,
+                           limited_size,
+                           allocator_);
     }
 
     if (limited_size > 0) {
@@ -524,31 +818,846 @@ HGraph::RangeSearch(const DatasetPtr& query,
     return std::move(dataset_results);
 }
 
+MaxHeap
+HGraph::scan_valid_ids(const float* query, const FilterPtr& filter, int64_t topk) const {
+    constexpr uint64_t scan_batch_size = 1024;
+    MaxHeap result(allocator_);
+    const auto* bitmap = dynamic_cast<const InnerIdBitmapFilter*>(filter.get());
+    auto computer = this->basic_flatten_codes_->FactoryComputer(query);
+    Vector<InnerIdType> ids(allocator_);
+    Vector<float> dists(scan_batch_size, allocator_);
+    ids.reserve(scan_batch_size);
+
+    auto flush = [&]() {
+        this->basic_flatten_codes_->Query(dists.data(), computer, ids.data(), ids.size());
+        for (uint64_t i = 0; i < ids.size(); ++i) {
+            if (result.size() < topk or dists[i] < result.top().first) {
+                result.emplace(dists[i], ids[i]);
+                if (result.size() > topk) {
+                    result.pop();
+                }
+            }
+        }
+        ids.clear();
+    };
+
+    auto total = static_cast<InnerIdType>(this->total_count_);
+    for (InnerIdType id = 0; id < total; ++id) {
+        bool valid = bitmap != nullptr ? bitmap->Test(id) : filter->CheckValid(id);
+        if (valid) {
+            ids.emplace_back(id);
+            if (ids.size() == scan_batch_size) {
+                flush();
+            }
+        }
+    }
+    flush();
+    return result;
+}
+
+InnerIdType
+HGraph::search_route_graphs(const float* query,
+                            const HGraphRoute& route,
+                            const FlattenInterfacePtr& flatten,
+                            int64_t stop_level) const {
+    InnerSearchParam search_param;
+    search_param.ep = route.entry_point_id;
+    search_param.topk = 1;
+    search_param.ef = 1;
+    search_param.is_inner_id_allowed = nullptr;
+    for (auto i = static_cast<int64_t>(route.route_graphs.size()) - 1; i > stop_level; --i) {
+        auto result = this->search_one_graph(query, route.route_graphs[i], flatten, search_param);
+        search_param.ep = result.top().second;
+    }
+    return search_param.ep;
+}
+
+InnerIdType
+HGraph::search_entry_points(const float* query,
+                            const HGraphRoute& route,
+                            const FlattenInterfacePtr& flatten,
+                            uint64_t count,
+                            Vector<InnerIdType>& extra_eps) const {
+    extra_eps.clear();
+    if (count <= 1 or route.route_graphs.empty()) {
+        return this->search_route_graphs(query, route, flatten);
+    }
+    InnerSearchParam search_param;
+    search_param.ep = this->search_route_graphs(query, route, flatten, 0);
+    search_param.ef = count * ENTRY_POINT_EF_FACTOR;
+    search_param.topk = static_cast<int64_t>(count);
+    search_param.is_inner_id_allowed = nullptr;
+    auto result = this->search_one_graph(query, route.route_graphs[0], flatten, search_param);
+    if (result.empty()) {
+        return search_param.ep;
+    }
+    while (result.size() > 1) {
+        extra_eps.emplace_back(result.top().second);
+        result.pop();
+    }
+    return result.top().second;
+}
+
+MaxHeap
+HGraph::search_bottom_graph(const float* query,
+                            const FlattenInterfacePtr& flatten,
+                            uint64_t ef,
+                            const FilterPtr& filter) const {
+    InnerSearchParam search_param;
+    search_param.ep = this->search_route_graphs(query, *this->load_route(), flatten);
+    search_param.ef = ef;
+    search_param.topk = static_cast<int64_t>(ef);
+    search_param.is_inner_id_allowed = filter;
+    return this->search_one_graph(query, this->bottom_graph_, flatten, search_param);
+}
+
+FilterPtr
+HGraph::make_search_filter(const FilterPtr& filter, bool use_extra_info_filter) const {
+    FilterPtr ft = nullptr;
+    if (filter != nullptr) {
+        if (use_extra_info_filter) {
+            ft = std::make_shared<CommonExtraInfoFilter>(filter, this->extra_infos_);
+        } else {
+            ft = this->make_inner_id_filter(filter, static_cast<InnerIdType>(total_count_));
+        }
+    }
+    if (this->deleted_count_ > 0) {
+        auto live_ratio =
+            static_cast<float>(this->GetNumElements()) / static_cast<float>(this->total_count_);
+        const auto* bitmap = dynamic_cast<const InnerIdBitmapFilter*>(ft.get());
+        if (bitmap != nullptr) {
+            // a bitmap view keeps the searches and the planner on the bitmap path
+            ft = std::make_shared<InnerIdBitmapFilter>(*bitmap, this->tombstones_, live_ratio);
+        } else {
+            ft = std::make_shared<TombstoneFilter>(ft, this->tombstones_, live_ratio);
+        }
+    }
+    return ft;
+}
+
+bool
+HGraph::Remove(int64_t id) {
+    bool need_repair = false;
+    {
+        std::lock_guard label_lock(this->label_lookup_mutex_);
+        // the label lock keeps resize from replacing the tombstones, the global one keeps
+        //  repair from reading them while they change
+        std::shared_lock global_lock(this->global_mutex_);
+        if (not this->label_table_->CheckLabel(id)) {
+            return false;
+        }
+        auto inner_id = this->label_table_->GetIdByLabel(id);
+        this->label_table_->Remove(id);
+        this->tombstones_->Set(inner_id, TombstoneTable::DELETED);
+        ++this->deleted_count_;
+        this->pending_repair_ids_.emplace_back(inner_id);
+        auto threshold = std::max<uint64_t>(
+            1, static_cast<uint64_t>(REPAIR_TRIGGER_RATIO * static_cast<double>(total_count_)));
+        need_repair = this->pending_repair_ids_.size() >= threshold;
+    }
+    if (need_repair) {
+        this->schedule_repair();
+    }
+    return true;
+}
+
+bool
+HGraph::UpdateId(int64_t old_id, int64_t new_id) {
+    if (old_id == new_id) {
+        return true;
+    }
+    std::lock_guard label_lock(this->label_lookup_mutex_);
+    if (not this->label_table_->CheckLabel(old_id) or this->label_table_->CheckLabel(new_id)) {
+        return false;
+    }
+    auto inner_id = this->label_table_->GetIdByLabel(old_id);
+    this->label_table_->Remove(old_id);
+    this->label_table_->Insert(inner_id, new_id);
+    this->bitmap_cache_->Clear();
+    return true;
+}
+
+bool
+HGraph::UpdateVector(int64_t id, const DatasetPtr& new_base, bool force_update) {
+    auto base_dim = new_base->GetDim();
+    CHECK_ARGUMENT(base_dim == dim_,
+                   fmt::format("base.dim({}) must be equal to index.dim({})", base_dim, dim_));
+    CHECK_ARGUMENT(new_base->GetNumElements() == 1, "new base should contain 1 vector only");
+    InnerIdType inner_id;
+    {
+        std::shared_lock label_lock(this->label_lookup_mutex_);
+        if (not this->label_table_->CheckLabel(id)) {
+            return false;
+        }
+        inner_id = this->label_table_->GetIdByLabel(id);
+    }
+    const auto* data = new_base->GetFloat32Vectors();
+    auto flatten_codes = basic_flatten_codes_;
+    if (use_reorder_) {
+        flatten_codes = high_precise_codes_;
+    }
+
+    if (not force_update) {
+        // the new vector must still be closer to the old one than to any other neighbor
+        std::shared_lock global_lock(this->global_mutex_);
+        float self_dist = 0.0F;
+        auto computer = flatten_codes->FactoryComputer(data);
+        flatten_codes->Query(&self_dist, computer, &inner_id, 1);
+        auto neighbors = this->search_bottom_graph(
+            data, flatten_codes, UPDATE_CHECK_SEARCH_L, this->make_search_filter(nullptr, false));
+        while (neighbors.size() > UPDATE_CHECK_SEARCH_K) {
+            neighbors.pop();
+        }
+        while (not neighbors.empty()) {
+            if (neighbors.top().second != inner_id and neighbors.top().first < self_dist) {
+                return false;
+            }
+            neighbors.pop();
+        }
+    }
+
+    // searches read the codes without node locks, so they wait while the codes are rewritten
+    //  and the vector is relinked
+    std::lock_guard global_lock(this->global_mutex_);
+    if (not this->tombstones_->IsLive(inner_id)) {
+        // removed since the label was looked up
+        return false;
+    }
+    this->basic_flatten_codes_->InsertVector(data, inner_id);
+    if (use_reorder_) {
+        this->high_precise_codes_->InsertVector(data, inner_id);
+    }
+
+    // link the vector at its new position in every graph it belongs to, the old in-edges are
+    //  kept
+    auto relink = [&](const GraphInterfacePtr& graph, MaxHeap& result) {
+        MaxHeap candidates(allocator_);
+        while (not result.empty()) {
+            if (result.top().second != inner_id) {
+                candidates.emplace(result.top());
+            }
+            result.pop();
+        }
+        if (not candidates.empty()) {
+            mutually_connect_new_element(
+                inner_id, candidates, graph, flatten_codes, neighbors_mutex_, allocator_);
+        }
+    };
+    auto result = this->search_bottom_graph(data, flatten_codes, this->ef_construct_, nullptr);
+    relink(this->bottom_graph_, result);
+
+    auto route = this->load_route();
+    InnerSearchParam search_param;
+    search_param.ef = this->ef_construct_;
+    search_param.topk = static_cast<int64_t>(this->ef_construct_);
+    search_param.is_inner_id_allowed = nullptr;
+    for (uint64_t level = 0; level < route->route_graphs.size(); ++level) {
+        const auto& route_graph = route->route_graphs[level];
+        if (inner_id != route->entry_point_id and route_graph->GetNeighborSize(inner_id) == 0) {
+            break;
+        }
+        search_param.ep = this->search_route_graphs(
+            data, *route, flatten_codes, static_cast<int64_t>(level));
+        result = this->search_one_graph(data, route_graph, flatten_codes, search_param);
+        relink(route_graph, result);
+    }
+    return true;
+}
+
+void
+HGraph::Merge(const std::vector<MergeUnit>& merge_units) {
+    std::vector<std::pair<std::shared_ptr<HGraph>, IdMapFunction>> shards;
+    for (const auto& unit : merge_units) {
+        auto index = std::dynamic_pointer_cast<IndexImpl<HGraph>>(unit.index);
+        CHECK_ARGUMENT(index != nullptr, "only hgraph indexes can be merged into hgraph");
+        auto shard = std::dynamic_pointer_cast<HGraph>(index->GetInnerIndex());
+        CHECK_ARGUMENT(shard != nullptr and shard.get() != this,
+                       "an hgraph index cannot be merged into itself");
+        this->check_merge_compatible(*shard);
+        shards.emplace_back(shard, unit.id_map_func);
+    }
+    if (shards.empty()) {
+        return;
+    }
+
+    // a scheduled repair would hold a thread of build_pool_ while it waits for the locks below,
+    //  and the odescent refinement needs the pool
+    this->wait_repair();
+    std::lock_guard label_lock(this->label_lookup_mutex_);
+    std::lock_guard lock(this->add_mutex_);
+    // codes are copied without decoding, so every shard must encode with the quantizers of the
+    //  index trained into the same model (e.g. exported from one model), an empty index takes
+    //  the quantizers of the first shard
+    const auto& first = shards[0].first;
+    const auto& model = this->total_count_ == 0 ? *first : *this;
+    for (const auto& [shard, id_map_func] : shards) {
+        CHECK_ARGUMENT(
+            shard->basic_flatten_codes_->SameModel(model.basic_flatten_codes_) and
+                (not use_reorder_ or
+                 shard->high_precise_codes_->SameModel(model.high_precise_codes_)),
+            "shard quantizer must be trained into the same model as index quantizer");
+    }
+    if (this->total_count_ == 0) {
+        first->basic_flatten_codes_->ExportModel(this->basic_flatten_codes_);
+        if (use_reorder_) {
+            first->high_precise_codes_->ExportModel(this->high_precise_codes_);
+        }
+    }
+
+    UnorderedMap<InnerIdType, InnerIdType> self_map(allocator_);
+    for (InnerIdType inner_id = 0; inner_id < this->total_count_; ++inner_id) {
+        if (this->tombstones_->IsLive(inner_id)) {
+            self_map.emplace(inner_id, inner_id);
+        }
+    }
+    std::vector<UnorderedMap<InnerIdType, InnerIdType>> id_maps;
+    for (const auto& [shard, id_map_func] : shards) {
+        id_maps.emplace_back(this->copy_shard(*shard, id_map_func));
+    }
+
+    // the edges of every shard are kept, the merge only has to find the cross-shard ones
+    auto bottom_seed =
+        std::make_shared<SparseGraphDataCell>(allocator_, this->bottom_graph_->MaximumDegree());
+    Vector<GraphInterfacePtr> route_seeds(allocator_);
+    UnorderedMap<InnerIdType, int> levels(allocator_);
+    this->collect_merge_edges(*this, self_map, bottom_seed, route_seeds, levels);
+    for (uint64_t i = 0; i < shards.size(); ++i) {
+        this->collect_merge_edges(*shards[i].first, id_maps[i], bottom_seed, route_seeds, levels);
+    }
+    if (levels.empty()) {
+        return;
+    }
+    Vector<InnerIdType> ids(allocator_);
+    ids.reserve(levels.size());
+    for (const auto& [inner_id, level] : levels) {
+        ids.emplace_back(inner_id);
+    }
+    std::sort(ids.begin(), ids.end());
+    std::vector<Vector<InnerIdType>> parts;
+    auto add_part = [&](const UnorderedMap<InnerIdType, InnerIdType>& id_map) {
+        Vector<InnerIdType> part(allocator_);
+        part.reserve(id_map.size());
+        for (const auto& [old_id, new_id] : id_map) {
+            part.emplace_back(new_id);
+        }
+        if (not part.empty()) {
+            std::sort(part.begin(), part.end());
+            parts.emplace_back(std::move(part));
+        }
+    };
+    add_part(self_map);
+    for (const auto& id_map : id_maps) {
+        add_part(id_map);
+    }
+
+    auto flatten_codes = basic_flatten_codes_;
+    if (use_reorder_) {
+        flatten_codes = high_precise_codes_;
+    }
+    auto merge_param = std::make_shared<ODescentParameter>();
+    if (this->odescent_param_ != nullptr) {
+        *merge_param = *this->odescent_param_;
+    }
+    merge_param->turn = std::min(merge_param->turn, MERGE_REFINE_TURN);
+
+    // the graphs are rewritten in place, searches hold global_mutex_ shared and wait for the
+    //  merge to finish, open cursors only see single lists replaced under their node locks
+    std::lock_guard global_lock(this->global_mutex_);
+    Vector<InnerIdType> edges(allocator_);
+    for (const auto& inner_id : ids) {
+        bottom_seed->GetNeighbors(inner_id, edges);
+        LockGuard lock(neighbors_mutex_, inner_id);
+        this->bottom_graph_->InsertNeighborsById(inner_id, edges);
+    }
+    this->link_merged_shards(parts, levels, flatten_codes);
+    auto route = std::make_shared<HGraphRoute>(allocator_);
+    route->entry_point_id = ids[0];
+    for (uint64_t level = 0; level < route_seeds.size(); ++level) {
+        Vector<InnerIdType> level_ids(allocator_);
+        for (const auto& inner_id : ids) {
+            if (levels[inner_id] >= static_cast<int>(level)) {
+                level_ids.emplace_back(inner_id);
+            }
+        }
+        if (level_ids.empty()) {
+            break;
+        }
+        auto route_graph = this->generate_one_route_graph();
+        this->build_graph_by_odescent(
+            level_ids, route_graph, flatten_codes, merge_param, route_seeds[level]);
+        route->route_graphs.emplace_back(route_graph);
+        route->entry_point_id = level_ids[0];
+    }
+    std::atomic_store(&this->route_, HGraphRoutePtr(route));
+}
+
+void
+HGraph::check_merge_compatible(HGraph& shard) const {
+    CHECK_ARGUMENT(shard.dim_ == this->dim_,
+                   fmt::format("shard.dim({}) must be equal to index.dim({})", shard.dim_, dim_));
+    CHECK_ARGUMENT(shard.metric_ == this->metric_, "shard metric must be equal to index metric");
+    CHECK_ARGUMENT(shard.use_reorder_ == this->use_reorder_,
+                   "shard use_reorder must be equal to index use_reorder");
+    CHECK_ARGUMENT(shard.extra_info_size_ == this->extra_info_size_,
+                   "shard extra_info_size must be equal to index extra_info_size");
+    auto check_codes = [](const FlattenInterfacePtr& shard_codes,
+                          const FlattenInterfacePtr& codes) {
+        CHECK_ARGUMENT(shard_codes->GetQuantizerName() == codes->GetQuantizerName() and
+                           shard_codes->code_size_ == codes->code_size_,
+                       fmt::format("shard quantizer({}) must be equal to index quantizer({})",
+                                   shard_codes->GetQuantizerName(),
+                                   codes->GetQuantizerName()));
+    };
+    check_codes(shard.basic_flatten_codes_, this->basic_flatten_codes_);
+    if (use_reorder_) {
+        check_codes(shard.high_precise_codes_, this->high_precise_codes_);
+    }
+}
+
+static void
+copy_codes(const FlattenInterfacePtr& from,
+           InnerIdType from_id,
+           const FlattenInterfacePtr& to,
+           InnerIdType to_id,
+           Vector<uint8_t>& buffer) {
+    if (not from->GetCodesById(from_id, buffer.data()) or
+        not to->InsertCodes(buffer.data(), to_id)) {
+        throw VsagException(ErrorType::INTERNAL_ERROR, "failed to copy codes of a merged vector");
+    }
+}
+
+UnorderedMap<InnerIdType, InnerIdType>
+HGraph::copy_shard(const HGraph& shard, const IdMapFunction& id_map_func) {
+    UnorderedMap<InnerIdType, InnerIdType> id_map(allocator_);
+    Vector<InnerIdType> old_ids(allocator_);
+    Vector<LabelType> labels(allocator_);
+    UnorderedSet<LabelType> shard_labels(allocator_);
+    for (InnerIdType old_id = 0; old_id < shard.total_count_; ++old_id) {
+        if (not shard.tombstones_->IsLive(old_id)) {
+            continue;
+        }
+        auto label = shard.label_table_->GetLabelById(old_id);
+        if (id_map_func != nullptr) {
+            auto [keep, new_label] = id_map_func(label);
+            if (not keep) {
+                continue;
+            }
+            label = new_label;
+        }
+        // a label that already exists is dropped, the same as a failed add
+        if (this->label_table_->CheckLabel(label) or not shard_labels.emplace(label).second) {
+            continue;
+        }
+        old_ids.emplace_back(old_id);
+        labels.emplace_back(label);
+    }
+    if (old_ids.empty()) {
+        return id_map;
+    }
+
+    auto new_ids = this->get_unique_inner_ids(static_cast<InnerIdType>(old_ids.size()));
+    this->resize(total_count_);
+    auto code_size = basic_flatten_codes_->code_size_;
+    if (use_reorder_) {
+        code_size = std::max(code_size, high_precise_codes_->code_size_);
+    }
+    Vector<uint8_t> codes(code_size, allocator_);
+    Vector<char> extra_info(extra_info_size_, allocator_);
+    for (uint64_t i = 0; i < old_ids.size(); ++i) {
+        auto old_id = old_ids[i];
+        auto new_id = new_ids[i];
+        this->label_table_->Insert(new_id, labels[i]);
+        copy_codes(shard.basic_flatten_codes_, old_id, basic_flatten_codes_, new_id, codes);
+        if (use_reorder_) {
+            copy_codes(shard.high_precise_codes_, old_id, high_precise_codes_, new_id, codes);
+        }
+        if (this->extra_infos_ != nullptr) {
+            if (not shard.extra_infos_->GetExtraInfoById(old_id, extra_info.data())) {
+                throw VsagException(ErrorType::INTERNAL_ERROR,
+                                    "failed to copy extra info of a merged vector");
+            }
+            this->extra_infos_->InsertExtraInfo(extra_info.data(), new_id);
+        }
+        this->tombstones_->Set(new_id, TombstoneTable::LIVE);
+        id_map.emplace(old_id, new_id);
+    }
+    return id_map;
+}
+
+void
+HGraph::collect_merge_edges(const HGraph& source,
+                            const UnorderedMap<InnerIdType, InnerIdType>& id_map,
+                            const GraphInterfacePtr& bottom_seed,
+                            Vector<GraphInterfacePtr>& route_seeds,
+                            UnorderedMap<InnerIdType, int>& levels) {
+    Vector<InnerIdType> edges(allocator_);
+    Vector<InnerIdType> mapped_edges(allocator_);
+    // edges to vectors that are not merged (deleted or dropped) are cut
+    auto remap_edges = [&](const GraphInterfacePtr& graph, InnerIdType old_id) {
+        edges.clear();
+        mapped_edges.clear();
+        graph->GetNeighbors(old_id, edges);
+        for (const auto& neighbor_id : edges) {
+            auto iter = id_map.find(neighbor_id);
+            if (iter != id_map.end()) {
+                mapped_edges.emplace_back(iter->second);
+            }
+        }
+    };
+
+    for (const auto& [old_id, new_id] : id_map) {
+        remap_edges(source.bottom_graph_, old_id);
+        bottom_seed->InsertNeighborsById(new_id, mapped_edges);
+        levels[new_id] = -1;
+    }
+
+    // a vector keeps the highest route level it was linked to in its shard
+    auto route = source.load_route();
+    Vector<InnerIdType> members(allocator_);
+    for (uint64_t level = 0; level < route->route_graphs.size(); ++level) {
+        const auto& route_graph = route->route_graphs[level];
+        auto sparse_graph = std::dynamic_pointer_cast<SparseGraphDataCell>(route_graph);
+        if (sparse_graph == nullptr) {
+            throw VsagException(ErrorType::INTERNAL_ERROR, "route graph is not a sparse graph");
+        }
+        sparse_graph->GetIds(members);
+        while (route_seeds.size() <= level) {
+            route_seeds.emplace_back(this->generate_one_route_graph());
+        }
+        for (const auto& old_id : members) {
+            auto iter = id_map.find(old_id);
+            if (iter == id_map.end()) {
+                continue;
+            }
+            remap_edges(route_graph, old_id);
+            route_seeds[level]->InsertNeighborsById(iter->second, mapped_edges);
+            levels[iter->second] = static_cast<int>(level);
+        }
+    }
+}
+
+void
+HGraph::link_merged_shards(const std::vector<Vector<InnerIdType>>& parts,
+                           const UnorderedMap<InnerIdType, int>& levels,
+                           const FlattenInterfacePtr& flatten) {
+    if (parts.size() < 2) {
+        return;
+    }
+    auto max_degree = this->bottom_graph_->MaximumDegree();
+
+    // the highest route members of a shard, its entry point among them, spread over all of it
+    std::vector<Vector<InnerIdType>> seeds;
+    for (const auto& part : parts) {
+        Vector<std::pair<int, InnerIdType>> ranked(allocator_);
+        for (const auto& inner_id : part) {
+            auto level = levels.at(inner_id);
+            if (level >= 0) {
+                ranked.emplace_back(-level, inner_id);
+            }
+        }
+        std::sort(ranked.begin(), ranked.end());
+        Vector<InnerIdType> part_seeds(allocator_);
+        for (uint64_t i = 0; i < std::min<uint64_t>(ranked.size(), MERGE_SEED_COUNT); ++i) {
+            part_seeds.emplace_back(ranked[i].second);
+        }
+        if (part_seeds.empty()) {
+            part_seeds.emplace_back(part[0]);
+        }
+        seeds.emplace_back(std::move(part_seeds));
+    }
+
+    // the bottom graph has no edge between shards yet, so a search started at a seed of a shard
+    //  stays in it and finds the vectors of that shard closest to from, its boundary to from
+    Vector<std::pair<InnerIdType, InnerIdType>> cross_edges(allocator_);
+    auto link = [&](InnerIdType from, uint64_t to_part, Vector<InnerIdType>& boundary) {
+        auto entry_id = seeds[to_part][0];
+        auto entry_dist = std::numeric_limits<float>::max();
+        for (const auto& seed : seeds[to_part]) {
+            auto dist = flatten->ComputePairVectors(from, seed);
+            if (dist < entry_dist) {
+                entry_dist = dist;
+                entry_id = seed;
+            }
+        }
+        auto result = this->search_by_id(from, entry_id, flatten, this->ef_construct_);
+        while (result.size() > max_degree) {
+            result.pop();
+        }
+        while (not result.empty()) {
+            auto to = result.top().second;
+            result.pop();
+            cross_edges.emplace_back(from, to);
+            cross_edges.emplace_back(to, from);
+            boundary.emplace_back(to);
+        }
+    };
+
+    std::vector<Vector<InnerIdType>> boundaries;
+    for (uint64_t i = 0; i < parts.size(); ++i) {
+        boundaries.emplace_back(allocator_);
+    }
+    for (uint64_t from_part = 0; from_part < parts.size(); ++from_part) {
+        for (const auto& seed : seeds[from_part]) {
+            for (uint64_t to_part = 0; to_part < parts.size(); ++to_part) {
+                if (to_part != from_part) {
+                    link(seed, to_part, boundaries[to_part]);
+                }
+            }
+        }
+    }
+    // the boundary found from the seeds links back to the other shards
+    Vector<InnerIdType> unused(allocator_);
+    for (uint64_t from_part = 0; from_part < parts.size(); ++from_part) {
+        auto& boundary = boundaries[from_part];
+        std::sort(boundary.begin(), boundary.end());
+        boundary.erase(std::unique(boundary.begin(), boundary.end()), boundary.end());
+        if (boundary.size() > MERGE_BOUNDARY_COUNT) {
+            std::shuffle(boundary.begin(), boundary.end(), this->level_generator_);
+            boundary.resize(MERGE_BOUNDARY_COUNT);
+        }
+        for (const auto& inner_id : boundary) {
+            for (uint64_t to_part = 0; to_part < parts.size(); ++to_part) {
+                if (to_part != from_part) {
+                    link(inner_id, to_part, unused);
+                }
+            }
+        }
+    }
+
+    // every linked vector chooses its edges among its own list and its cross-shard neighbors
+    std::sort(cross_edges.begin(), cross_edges.end());
+    cross_edges.erase(std::unique(cross_edges.begin(), cross_edges.end()), cross_edges.end());
+    Vector<InnerIdType> neighbors(allocator_);
+    Vector<InnerIdType> new_neighbors(allocator_);
+    for (uint64_t begin = 0; begin < cross_edges.size();) {
+        auto inner_id = cross_edges[begin].first;
+        auto end = begin;
+        this->bottom_graph_->GetNeighbors(inner_id, neighbors);
+        while (end < cross_edges.size() and cross_edges[end].first == inner_id) {
+            neighbors.emplace_back(cross_edges[end].second);
+            ++end;
+        }
+        begin = end;
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        MaxHeap candidates(allocator_);
+        for (const auto& neighbor : neighbors) {
+            candidates.emplace(flatten->ComputePairVectors(inner_id, neighbor), neighbor);
+        }
+        select_edges_by_heuristic(candidates, max_degree, flatten, allocator_);
+        while (candidates.size() > max_degree) {
+            candidates.pop();
+        }
+        new_neighbors.clear();
+        while (not candidates.empty()) {
+            new_neighbors.emplace_back(candidates.top().second);
+            candidates.pop();
+        }
+        LockGuard lock(neighbors_mutex_, inner_id);
+        this->bottom_graph_->InsertNeighborsById(inner_id, new_neighbors);
+    }
+}
+
+MaxHeap
+HGraph::search_by_id(InnerIdType query_id,
+                     InnerIdType entry_id,
+                     const FlattenInterfacePtr& flatten,
+                     uint64_t ef) const {
+    UnorderedSet<InnerIdType> visited(allocator_);
+    MaxHeap results(allocator_);
+    MaxHeap frontier(allocator_);
+    Vector<InnerIdType> neighbors(allocator_);
+    auto entry_dist = flatten->ComputePairVectors(query_id, entry_id);
+    results.emplace(entry_dist, entry_id);
+    frontier.emplace(-entry_dist, entry_id);
+    visited.emplace(entry_id);
+    while (not frontier.empty()) {
+        auto [neg_dist, inner_id] = frontier.top();
+        if (-neg_dist > results.top().first and results.size() >= ef) {
+            break;
+        }
+        frontier.pop();
+        this->bottom_graph_->GetNeighbors(inner_id, neighbors);
+        for (const auto& neighbor : neighbors) {
+            if (not visited.emplace(neighbor).second) {
+                continue;
+            }
+            auto dist = flatten->ComputePairVectors(query_id, neighbor);
+            if (results.size() < ef or dist < results.top().first) {
+                results.emplace(dist, neighbor);
+                frontier.emplace(-dist, neighbor);
+                if (results.size() > ef) {
+                    results.pop();
+                }
+            }
+        }
+    }
+    return results;
+}
+
+void
+HGraph::repair_deleted() {
+    Vector<InnerIdType> deleted_ids(allocator_);
+    {
+        std::lock_guard label_lock(this->label_lookup_mutex_);
+        deleted_ids.swap(this->pending_repair_ids_);
+    }
+    if (deleted_ids.empty()) {
+        return;
+    }
+
+    // searches hold global_mutex_ shared, so none of them runs while the lists are repaired
+    std::lock_guard add_lock(this->add_mutex_);
+    std::lock_guard<std::shared_mutex> global_lock(this->global_mutex_);
+    auto flatten_codes = basic_flatten_codes_;
+    if (use_reorder_) {
+        flatten_codes = high_precise_codes_;
+    }
+
+    // only vectors living in the bottom graph alone are unlinked and reused, the entry point and
+    //  the route graph members stay as tombstones so that the routes keep working
+    Vector<InnerIdType> freed_ids(allocator_);
+    auto route = this->load_route();
+    for (auto inner_id : deleted_ids) {
+        if (this->tombstones_->Get(inner_id) != TombstoneTable::DELETED or
+            inner_id == route->entry_point_id) {
+            continue;
+        }
+        if (not route->route_graphs.empty() and
+            route->route_graphs[0]->GetNeighborSize(inner_id) > 0) {
+            continue;
+        }
+        this->tombstones_->Set(inner_id, TombstoneTable::FREED);
+        freed_ids.emplace_back(inner_id);
+    }
+
+    // replace the deleted neighbors of every node by the live neighbors of the deleted ones
+    auto is_live = [&](InnerIdType id) -> bool { return this->tombstones_->IsLive(id); };
+    Vector<InnerIdType> neighbors(allocator_);
+    Vector<InnerIdType> second_neighbors(allocator_);
+    Vector<InnerIdType> new_neighbors(allocator_);
+    UnorderedSet<InnerIdType> candidate_ids(allocator_);
+    auto total = static_cast<InnerIdType>(this->total_count_);
+    for (InnerIdType inner_id = 0; inner_id < total; ++inner_id) {
+        if (this->tombstones_->Get(inner_id) == TombstoneTable::FREED) {
+            continue;
+        }
+        this->bottom_graph_->GetNeighbors(inner_id, neighbors);
+        if (std::all_of(neighbors.begin(), neighbors.end(), is_live)) {
+            continue;
+        }
+        candidate_ids.clear();
+        for (const auto& neighbor : neighbors) {
+            if (is_live(neighbor)) {
+                candidate_ids.emplace(neighbor);
+                continue;
+            }
+            this->bottom_graph_->GetNeighbors(neighbor, second_neighbors);
+            for (const auto& second_neighbor : second_neighbors) {
+                if (second_neighbor != inner_id and is_live(second_neighbor)) {
+                    candidate_ids.emplace(second_neighbor);
+                }
+            }
+        }
+        MaxHeap candidates(allocator_);
+        for (const auto& candidate_id : candidate_ids) {
+            candidates.emplace(flatten_codes->ComputePairVectors(inner_id, candidate_id),
+                               candidate_id);
+        }
+        select_edges_by_heuristic(
+            candidates, this->bottom_graph_->MaximumDegree(), flatten_codes, allocator_);
+        new_neighbors.clear();
+        while (not candidates.empty()) {
+            new_neighbors.emplace_back(candidates.top().second);
+            candidates.pop();
+        }
+        LockGuard lock(neighbors_mutex_, inner_id);
+        this->bottom_graph_->InsertNeighborsById(inner_id, new_neighbors);
+    }
+
+    for (const auto& inner_id : freed_ids) {
+        LockGuard lock(neighbors_mutex_, inner_id);
+        this->bottom_graph_->InsertNeighborsById(inner_id, Vector<InnerIdType>(allocator_));
+    }
+    this->free_slots_.insert(this->free_slots_.end(), freed_ids.begin(), freed_ids.end());
+}
+
+void
+HGraph::schedule_repair() {
+    std::lock_guard lock(this->repair_mutex_);
+    if (this->repair_future_.valid() and
+        this->repair_future_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        // the ids removed meanwhile stay pending until the next trigger
+        return;
+    }
+    if (this->build_pool_ == nullptr) {
+        this->repair_requested_ = true;
+        return;
+    }
+    this->repair_future_ = this->build_pool_->GeneralEnqueue([this]() { this->repair_deleted(); });
+}
+
+void
+HGraph::wait_repair() const {
+    std::lock_guard lock(this->repair_mutex_);
+    if (this->repair_future_.valid()) {
+        this->repair_future_.get();
+    }
+}
+
+void
+HGraph::rebuild_tombstones() {
+    // deleted vectors are not serialized separately, their labels are just missing in the remap
+    this->tombstones_ = std::make_shared<TombstoneTable>(this->max_capacity_.load(), allocator_);
+    this->pending_repair_ids_.clear();
+    this->free_slots_.clear();
+    this->deleted_count_ = 0;
+    const auto& label_remap = this->label_table_->label_remap_;
+    for (InnerIdType inner_id = 0; inner_id < this->total_count_; ++inner_id) {
+        InnerIdType remap_id;
+        if (not label_remap.Find(this->label_table_->label_table_[inner_id], remap_id) or
+            remap_id != inner_id) {
+            this->tombstones_->Set(inner_id, TombstoneTable::DELETED);
+            this->pending_repair_ids_.emplace_back(inner_id);
+            ++this->deleted_count_;
+        }
+    }
+}
+
+std::string
+HGraph::GetStats() const {
+    JsonType stats;
+    stats[STATSTIC_DATA_NUM] = this->GetNumElements();
+    stats[STATSTIC_INDEX_NAME] = this->GetName();
+    this->search_plan_stats_.ToJson(stats);
+    if (this->query_cache_ != nullptr) {
+        this->query_cache_->ToJson(stats);
+    }
+    return stats.dump();
+}
+
 void
 HGraph::serialize_basic_info(StreamWriter& writer) const {
     StreamWriter::WriteObj(writer, this->use_reorder_);
     StreamWriter::WriteObj(writer, this->dim_);
     StreamWriter::WriteObj(writer, this->metric_);
-    uint64_t max_level = this->route_graphs_.size();
+    auto route = this->load_route();
+    uint64_t max_level = route->route_graphs.size();
     StreamWriter::WriteObj(writer, max_level);
-    StreamWriter::WriteObj(writer, this->entry_point_id_);
+    StreamWriter::WriteObj(writer, route->entry_point_id);
     StreamWriter::WriteObj(writer, this->ef_construct_);
     StreamWriter::WriteObj(writer, this->mult_);
     auto capacity = this->max_capacity_.load();
     StreamWriter::WriteObj(writer, capacity);
     StreamWriter::WriteVector(writer, this->label_table_->label_table_);
 
-    uint64_t size = this->label_table_->label_remap_.size();
-    StreamWriter::WriteObj(writer, size);
-    for (const auto& pair : this->label_table_->label_remap_) {
-        auto key = pair.first;
-        StreamWriter::WriteObj(writer, key);
-        StreamWriter::WriteObj(writer, pair.second);
-    }
+    StreamWriter::WriteObj(writer, FLAT_LABEL_REMAP);
+    this->label_table_->label_remap_.Serialize(writer);
 }
 
 void
 HGraph::Serialize(StreamWriter& writer) const {
+    this->wait_repair();
     if (this->ignore_reorder_) {
         this->use_reorder_ = false;
     }
@@ -558,7 +1667,7 @@ HGraph::Serialize(StreamWriter& writer) const {
     if (this->use_reorder_) {
         this->high_precise_codes_->Serialize(writer);
     }
-    for (const auto& route_graph : this->route_graphs_) {
+    for (const auto& route_graph : this->load_route()->route_graphs) {
         route_graph->Serialize(writer);
     }
     if (this->extra_info_size_ > 0 && this->extra_infos_ != nullptr) {
@@ -575,7 +1684,7 @@ HGraph::Deserialize(StreamReader& reader) {
         this->high_precise_codes_->Deserialize(reader);
     }
 
-    for (auto& route_graph : this->route_graphs_) {
+    for (const auto& route_graph : this->load_route()->route_graphs) {
         route_graph->Deserialize(reader);
     }
     auto new_size = max_capacity_.load();
@@ -587,6 +1696,7 @@ HGraph::Deserialize(StreamReader& reader) {
         this->extra_infos_->Deserialize(reader);
     }
     this->total_count_ = this->basic_flatten_codes_->TotalCount();
+    this->rebuild_tombstones();
 }
 
 void
@@ -596,10 +1706,12 @@ HGraph::deserialize_basic_info(StreamReader& reader) {
     StreamReader::ReadObj(reader, this->metric_);
     uint64_t max_level;
     StreamReader::ReadObj(reader, max_level);
+    auto route = std::make_shared<HGraphRoute>(allocator_);
     for (uint64_t i = 0; i < max_level; ++i) {
-        this->route_graphs_.emplace_back(this->generate_one_route_graph());
+        route->route_graphs.emplace_back(this->generate_one_route_graph());
     }
-    StreamReader::ReadObj(reader, this->entry_point_id_);
+    StreamReader::ReadObj(reader, route->entry_point_id);
+    std::atomic_store(&this->route_, HGraphRoutePtr(route));
     StreamReader::ReadObj(reader, this->ef_construct_);
     StreamReader::ReadObj(reader, this->mult_);
     InnerIdType capacity;
@@ -607,14 +1719,21 @@ HGraph::deserialize_basic_info(StreamReader& reader) {
     this->max_capacity_.store(capacity);
     StreamReader::ReadVector(reader, this->label_table_->label_table_);
 
+    auto& label_remap = this->label_table_->label_remap_;
     uint64_t size;
     StreamReader::ReadObj(reader, size);
+    if (size == FLAT_LABEL_REMAP) {
+        label_remap.Deserialize(reader);
+        return;
+    }
+    label_remap.Clear();
+    label_remap.Reserve(size);
     for (uint64_t i = 0; i < size; ++i) {
         LabelType key;
         StreamReader::ReadObj(reader, key);
         InnerIdType value;
         StreamReader::ReadObj(reader, value);
-        this->label_table_->label_remap_.emplace(key, value);
+        label_remap.Insert(key, value);
     }
 }
 
@@ -626,17 +1745,12 @@ HGraph::CalcDistanceById(const float* query, int64_t id) const {
     }
     float result = 0.0F;
     auto computer = flat->FactoryComputer(query);
-    {
-        std::shared_lock<std::shared_mutex> lock(this->label_lookup_mutex_);
-        auto iter = this->label_table_->label_remap_.find(id);
-        if (iter == this->label_table_->label_remap_.end()) {
-            throw VsagException(ErrorType::INVALID_ARGUMENT,
-                                fmt::format("failed to find id: {}", id));
-        }
-        auto new_id = iter->second;
-        flat->Query(&result, computer, &new_id, 1);
-        return result;
+    InnerIdType new_id;
+    if (not this->label_table_->label_remap_.Find(id, new_id)) {
+        throw VsagException(ErrorType::INVALID_ARGUMENT, fmt::format("failed to find id: {}", id));
     }
+    flat->Query(&result, computer, &new_id, 1);
+    return result;
 }
 
 DatasetPtr
@@ -651,19 +1765,13 @@ HGraph::CalDistanceById(const float* query, const int64_t* ids, int64_t count) c
     result->Distances(distances);
     auto computer = flat->FactoryComputer(query);
     Vector<InnerIdType> inner_ids(count, 0, allocator_);
-    {
-        std::shared_lock<std::shared_mutex> lock(this->label_lookup_mutex_);
-        for (int64_t i = 0; i < count; ++i) {
-            auto iter = this->label_table_->label_remap_.find(ids[i]);
-            if (iter == this->label_table_->label_remap_.end()) {
-                logger::debug(fmt::format("failed to find id: {}", ids[i]));
-                distances[i] = -1;
-                continue;
-            }
-            inner_ids[i] = iter->second;
+    for (int64_t i = 0; i < count; ++i) {
+        if (not this->label_table_->label_remap_.Find(ids[i], inner_ids[i])) {
+            logger::debug(fmt::format("failed to find id: {}", ids[i]));
+            distances[i] = -1;
         }
-        flat->Query(distances, computer, inner_ids.data(), count);
     }
+    flat->Query(distances, computer, inner_ids.data(), count);
     return result;
 }
 
@@ -671,14 +1779,14 @@ std::pair<int64_t, int64_t>
 HGraph::GetMinAndMaxId() const {
     int64_t min_id = INT64_MAX;
     int64_t max_id = INT64_MIN;
-    std::shared_lock<std::shared_mutex> lock(this->label_lookup_mutex_);
-    if (this->label_table_->label_remap_.empty()) {
+    const auto& label_remap = this->label_table_->label_remap_;
+    if (label_remap.Empty()) {
         throw std::runtime_error("Label map size is zero");
     }
-    for (auto& it : this->label_table_->label_remap_) {
-        max_id = it.first > max_id ? it.first : max_id;
-        min_id = it.first < min_id ? it.first : min_id;
-    }
+    label_remap.ForEach([&](LabelType label, InnerIdType) {
+        max_id = label > max_id ? label : max_id;
+        min_id = label < min_id ? label : min_id;
+    });
     return {min_id, max_id};
 }
 
@@ -688,7 +1796,6 @@ HGraph::GetExtraInfoByIds(const int64_t* ids, int64_t count, char* extra_infos)
         throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION, "extra_info is NULL");
     }
     for (int64_t i = 0; i < count; ++i) {
-        std::shared_lock<std::shared_mutex> lock(this->label_lookup_mutex_);
         auto inner_id = this->label_table_->GetIdByLabel(ids[i]);
         this->extra_infos_->GetExtraInfoById(inner_id, extra_infos + i * extra_info_size_);
     }
@@ -700,63 +1807,71 @@ HGraph::add_one_point(const float* data, int level, InnerIdType inner_id) {
     if (use_reorder_) {
         this->high_precise_codes_->InsertVector(data, inner_id);
     }
-    std::unique_lock add_lock(add_mutex_);
-    if (level >= static_cast<int>(this->route_graphs_.size()) || bottom_graph_->TotalCount() == 0) {
-        std::lock_guard<std::shared_mutex> wlock(this->global_mutex_);
-        // level maybe a negative number(-1)
-        for (auto j = static_cast<int>(this->route_graphs_.size()); j <= level; ++j) {
-            this->route_graphs_.emplace_back(this->generate_one_route_graph());
-        }
-        this->graph_add_one(data, level, inner_id);
-        entry_point_id_ = inner_id;
-        add_lock.unlock();
-    } else {
-        add_lock.unlock();
-        std::shared_lock<std::shared_mutex> rlock(this->global_mutex_);
-        this->graph_add_one(data, level, inner_id);
+    // global_mutex_ only keeps resize, repair and merge away, inserts and searches share it
+    std::shared_lock<std::shared_mutex> rlock(this->global_mutex_);
+    auto route = this->load_route();
+    auto invalid_id = std::numeric_limits<InnerIdType>::max();
+    if (route->entry_point_id != invalid_id and
+        level < static_cast<int>(route->route_graphs.size())) {
+        this->graph_add_one(data, level, inner_id, *route);
+        return;
     }
+
+    // the vector becomes the new entry point: link it into the current hierarchy first, then
+    //  publish the higher levels, so a reader never sees an entry point that is not linked yet
+    std::lock_guard route_lock(this->route_mutex_);
+    route = this->load_route();
+    this->graph_add_one(data, level, inner_id, *route);
+    if (route->entry_point_id != invalid_id and
+        level < static_cast<int>(route->route_graphs.size())) {
+        return;
+    }
+    auto new_route = std::make_shared<HGraphRoute>(*route);
+    // level maybe a negative number(-1)
+    for (auto j = static_cast<int>(route->route_graphs.size()); j <= level; ++j) {
+        auto route_graph = this->generate_one_route_graph();
+        route_graph->InsertNeighborsById(inner_id, Vector<InnerIdType>(allocator_));
+        new_route->route_graphs.emplace_back(route_graph);
+    }
+    new_route->entry_point_id = inner_id;
+    std::atomic_store(&this->route_, HGraphRoutePtr(new_route));
 }
 
 void
-HGraph::graph_add_one(const float* data, int level, InnerIdType inner_id) {
-    MaxHeap result(allocator_);
-    InnerSearchParam param{
-        .topk = 1,
-        .ep = this->entry_point_id_,
-        .ef = 1,
-        .is_inner_id_allowed = nullptr,
-    };
-
-    LockGuard cur_lock(neighbors_mutex_, inner_id);
+HGraph::graph_add_one(const float* data, int level, InnerIdType inner_id, const HGraphRoute& route) {
     auto flatten_codes = basic_flatten_codes_;
     if (use_reorder_) {
         flatten_codes = high_precise_codes_;
     }
-    for (auto j = this->route_graphs_.size() - 1; j > level; --j) {
-        result = search_one_graph(data, route_graphs_[j], flatten_codes, param);
-        param.ep = result.top().second;
+    if (route.entry_point_id == std::numeric_limits<InnerIdType>::max()) {
+        bottom_graph_->InsertNeighborsById(inner_id, Vector<InnerIdType>(allocator_));
+        this->tombstones_->Set(inner_id, TombstoneTable::LIVE);
+        return;
     }
 
+    // the new vector has no in-edges until mutually_connect_new_element publishes them, so it
+    //  is searched without holding its own lock
+    MaxHeap result(allocator_);
+    InnerSearchParam param;
+    param.ep = this->search_route_graphs(data, route, flatten_codes, level);
     param.ef = this->ef_construct_;
     param.topk = static_cast<int64_t>(ef_construct_);
+    param.is_inner_id_allowed = nullptr;
 
-    if (bottom_graph_->TotalCount() != 0) {
-        result = search_one_graph(data, this->bottom_graph_, flatten_codes, param);
-        mutually_connect_new_element(
-            inner_id, result, this->bottom_graph_, flatten_codes, neighbors_mutex_, allocator_);
-    } else {
-        bottom_graph_->InsertNeighborsById(inner_id, Vector<InnerIdType>(allocator_));
-    }
+    result = search_one_graph(data, this->bottom_graph_, flatten_codes, param);
+    mutually_connect_new_element(
+        inner_id, result, this->bottom_graph_, flatten_codes, neighbors_mutex_, allocator_);
 
-    for (int64_t j = 0; j <= level; ++j) {
-        if (route_graphs_[j]->TotalCount() != 0) {
-            result = search_one_graph(data, route_graphs_[j], flatten_codes, param);
-            mutually_connect_new_element(
-                inner_id, result, route_graphs_[j], flatten_codes, neighbors_mutex_, allocator_);
-        } else {
-            route_graphs_[j]->InsertNeighborsById(inner_id, Vector<InnerIdType>(allocator_));
-        }
+    auto linked_level = std::min(static_cast<int64_t>(level),
+                                 static_cast<int64_t>(route.route_graphs.size()) - 1);
+    for (int64_t j = 0; j <= linked_level; ++j) {
+        const auto& route_graph = route.route_graphs[j];
+        result = search_one_graph(data, route_graph, flatten_codes, param);
+        mutually_connect_new_element(
+            inner_id, result, route_graph, flatten_codes, neighbors_mutex_, allocator_);
     }
+    // a reused slot becomes visible only after it is linked
+    this->tombstones_->Set(inner_id, TombstoneTable::LIVE);
 }
 
 void
@@ -773,6 +1888,9 @@ HGraph::resize(uint64_t new_size) {
         this->neighbors_mutex_->Resize(new_size_power_2);
         pool_ = std::make_shared<VisitedListPool>(1, allocator_, new_size_power_2, allocator_);
         this->label_table_->label_table_.resize(new_size_power_2);
+        // searches and cursors still holding the old table keep reading it
+        this->tombstones_ =
+            std::make_shared<TombstoneTable>(*this->tombstones_, new_size_power_2, allocator_);
         bottom_graph_->Resize(new_size_power_2);
         this->max_capacity_.store(new_size_power_2);
         this->basic_flatten_codes_->Resize(new_size_power_2);
@@ -793,11 +1911,18 @@ HGraph::InitFeatures() {
         IndexFeature::SUPPORT_BUILD_WITH_MULTI_THREAD,
         IndexFeature::SUPPORT_ADD_AFTER_BUILD,
     });
+    // delete & update
+    this->index_feature_list_->SetFeatures({
+        IndexFeature::SUPPORT_DELETE_BY_ID,
+        IndexFeature::SUPPORT_UPDATE_ID_CONCURRENT,
+        IndexFeature::SUPPORT_UPDATE_VECTOR_CONCURRENT,
+    });
     // search
     this->index_feature_list_->SetFeatures({
         IndexFeature::SUPPORT_KNN_SEARCH,
         IndexFeature::SUPPORT_KNN_SEARCH_WITH_ID_FILTER,
         IndexFeature::SUPPORT_KNN_ITERATOR_FILTER_SEARCH,
+        IndexFeature::SUPPORT_SEARCH_CURSOR,
     });
     // concurrency
     this->index_feature_list_->SetFeature(IndexFeature::SUPPORT_SEARCH_CONCURRENT);
@@ -816,6 +1941,7 @@ HGraph::InitFeatures() {
         IndexFeature::SUPPORT_CHECK_ID_EXIST,
         IndexFeature::SUPPORT_CLONE,
         IndexFeature::SUPPORT_EXPORT_MODEL,
+        IndexFeature::SUPPORT_MERGE_INDEX,
     });
 
     // About Train
@@ -857,35 +1983,6 @@ HGraph::InitFeatures() {
     }
 }
 
-void
-HGraph::reorder(const float* query,
-                const FlattenInterfacePtr& flatten_interface,
-                MaxHeap& candidate_heap,
-                int64_t k) const {
-    uint64_t size = candidate_heap.size();
-    if (k <= 0) {
-        k = static_cast<int64_t>(size);
-    }
-    Vector<InnerIdType> ids(size, allocator_);
-    Vector<float> dists(size, allocator_);
-    uint64_t idx = 0;
-    while (not candidate_heap.empty()) {
-        ids[idx] = candidate_heap.top().second;
-        ++idx;
-        candidate_heap.pop();
-    }
-    auto computer = flatten_interface->FactoryComputer(query);
-    flatten_interface->Query(dists.data(), computer, ids.data(), size);
-    for (uint64_t i = 0; i < size; ++i) {
-        if (candidate_heap.size() < k or dists[i] <= candidate_heap.top().first) {
-            candidate_heap.emplace(dists[i], ids[i]);
-        }
-        if (candidate_heap.size() > k) {
-            candidate_heap.pop();
-        }
-    }
-}
-
 static const ConstParamMap EXTERNAL_MAPPING = {
     {
         HGRAPH_USE_REORDER,
@@ -975,6 +2072,34 @@ static const ConstParamMap EXTERNAL_MAPPING = {
             BUILD_THREAD_COUNT,
         },
     },
+    {
+        HGRAPH_GRAPH_TYPE,
+        {
+            BUILD_PARAMS_KEY,
+            BUILD_GRAPH_TYPE,
+        },
+    },
+    {
+        ODESCENT_PARAMETER_ALPHA,
+        {
+            BUILD_PARAMS_KEY,
+            ODESCENT_PARAMETER_ALPHA,
+        },
+    },
+    {
+        ODESCENT_PARAMETER_GRAPH_ITER_TURN,
+        {
+            BUILD_PARAMS_KEY,
+            ODESCENT_PARAMETER_GRAPH_ITER_TURN,
+        },
+    },
+    {
+        ODESCENT_PARAMETER_NEIGHBOR_SAMPLE_RATE,
+        {
+            BUILD_PARAMS_KEY,
+            ODESCENT_PARAMETER_NEIGHBOR_SAMPLE_RATE,
+        },
+    },
     {
         SQ4_UNIFORM_TRUNC_RATE,
         {
@@ -1032,7 +2157,8 @@ static const std::string HGRAPH_PARAMS_TEMPLATE =
         },
         "{BUILD_PARAMS_KEY}": {
             "{BUILD_EF_CONSTRUCTION}": 400,
-            "{BUILD_THREAD_COUNT}": 100
+            "{BUILD_THREAD_COUNT}": 100,
+            "{BUILD_GRAPH_TYPE}": "{BUILD_GRAPH_TYPE_NSW}"
         },
         "{HGRAPH_EXTRA_INFO_KEY}": {
             "{IO_PARAMS_KEY}": {
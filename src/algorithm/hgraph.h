@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <future>
 #include <nlohmann/json.hpp>
 #include <random>
 #include <shared_mutex>
@@ -28,6 +29,8 @@
 #include "default_thread_pool.h"
 #include "hgraph_parameter.h"
 #include "impl/basic_searcher.h"
+#include "impl/search_planner.h"
+#include "impl/tombstone_table.h"
 #include "index/index_common_param.h"
 #include "index/iterator_filter.h"
 #include "index_feature_list.h"
@@ -39,6 +42,20 @@
 #include "vsag/index_features.h"
 
 namespace vsag {
+
+// the route graphs with their entry point, published as a whole so that searches and inserts
+// always see a consistent hierarchy without holding a lock
+struct HGraphRoute {
+    explicit HGraphRoute(Allocator* allocator) : route_graphs(allocator) {
+    }
+
+    Vector<GraphInterfacePtr> route_graphs;
+
+    InnerIdType entry_point_id{std::numeric_limits<InnerIdType>::max()};
+};
+
+using HGraphRoutePtr = std::shared_ptr<const HGraphRoute>;
+
 class HGraph : public InnerIndexInterface {
 public:
     static ParamPtr
@@ -51,7 +68,7 @@ public:
     HGraph(const ParamPtr& param, const IndexCommonParam& common_param)
         : HGraph(std::dynamic_pointer_cast<HGraphParameter>(param), common_param){};
 
-    ~HGraph() override = default;
+    ~HGraph() override;
 
     [[nodiscard]] std::string
     GetName() const override {
@@ -96,6 +113,39 @@ public:
                 const FilterPtr& filter,
                 int64_t limited_size = -1) const override;
 
+    [[nodiscard]] SearchCursorPtr
+    OpenSearchCursor(const DatasetPtr& query,
+                     const std::string& parameters,
+                     const FilterPtr& filter) const override;
+
+    [[nodiscard]] SearchParamPtr
+    CompileSearchParam(const std::string& parameters) const override;
+
+    [[nodiscard]] DatasetPtr
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const FilterPtr& filter) const override;
+
+    [[nodiscard]] DatasetPtr
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const FilterPtr& filter,
+                int64_t limited_size = -1) const override;
+
+    bool
+    Remove(int64_t id) override;
+
+    bool
+    UpdateId(int64_t old_id, int64_t new_id) override;
+
+    bool
+    UpdateVector(int64_t id, const DatasetPtr& new_base, bool force_update = false) override;
+
+    void
+    Merge(const std::vector<MergeUnit>& merge_units) override;
+
     void
     Serialize(StreamWriter& writer) const override;
 
@@ -104,7 +154,7 @@ public:
 
     int64_t
     GetNumElements() const override {
-        return this->total_count_;
+        return static_cast<int64_t>(this->total_count_ - this->deleted_count_);
     }
 
     uint64_t
@@ -116,6 +166,9 @@ public:
         return 0;
     }
 
+    [[nodiscard]] std::string
+    GetStats() const override;
+
     float
     CalcDistanceById(const float* query, int64_t id) const override;
 
@@ -161,7 +214,27 @@ private:
     add_one_point(const float* data, int level, InnerIdType id);
 
     void
-    graph_add_one(const float* data, int level, InnerIdType inner_id);
+    graph_add_one(const float* data, int level, InnerIdType inner_id, const HGraphRoute& route);
+
+    [[nodiscard]] inline HGraphRoutePtr
+    load_route() const {
+        return std::atomic_load(&this->route_);
+    }
+
+    InnerIdType
+    search_route_graphs(const float* query,
+                        const HGraphRoute& route,
+                        const FlattenInterfacePtr& flatten,
+                        int64_t stop_level = -1) const;
+
+    // the ep of the bottom graph, the next count - 1 hits of a wider search on the lowest
+    //  route graph are returned in extra_eps
+    InnerIdType
+    search_entry_points(const float* query,
+                        const HGraphRoute& route,
+                        const FlattenInterfacePtr& flatten,
+                        uint64_t count,
+                        Vector<InnerIdType>& extra_eps) const;
 
     void
     resize(uint64_t new_size);
@@ -184,22 +257,92 @@ private:
                      InnerSearchParam& inner_search_param,
                      IteratorFilterContext* iter_ctx) const;
 
+    MaxHeap
+    scan_valid_ids(const float* query, const FilterPtr& filter, int64_t topk) const;
+
+    DatasetPtr
+    knn_search(const DatasetPtr& query,
+               int64_t k,
+               const HGraphSearchParameters& params,
+               const FilterPtr& filter) const;
+
+    DatasetPtr
+    range_search(const DatasetPtr& query,
+                 float radius,
+                 const HGraphSearchParameters& params,
+                 const FilterPtr& filter,
+                 int64_t limited_size) const;
+
+    MaxHeap
+    search_bottom_graph(const float* query,
+                        const FlattenInterfacePtr& flatten,
+                        uint64_t ef,
+                        const FilterPtr& filter) const;
+
+    FilterPtr
+    make_search_filter(const FilterPtr& filter, bool use_extra_info_filter) const;
+
+    std::vector<int64_t>
+    build_by_odescent(const DatasetPtr& data);
+
     void
-    serialize_basic_info(StreamWriter& writer) const;
+    build_graph_by_odescent(const Vector<InnerIdType>& ids,
+                            const GraphInterfacePtr& graph,
+                            const FlattenInterfacePtr& flatten,
+                            const ODescentParameterPtr& odescent_param,
+                            const GraphInterfacePtr& seed_graph = nullptr);
 
     void
-    deserialize_basic_info(StreamReader& reader);
+    check_merge_compatible(HGraph& shard) const;
+
+    UnorderedMap<InnerIdType, InnerIdType>
+    copy_shard(const HGraph& shard, const IdMapFunction& id_map_func);
+
+    void
+    collect_merge_edges(const HGraph& source,
+                        const UnorderedMap<InnerIdType, InnerIdType>& id_map,
+                        const GraphInterfacePtr& bottom_seed,
+                        Vector<GraphInterfacePtr>& route_seeds,
+                        UnorderedMap<InnerIdType, int>& levels);
+
+    // links every merged shard (a sorted part of the ids) to the others at the vectors close to
+    //  them, the lists inside a shard are only extended by these cross-shard edges
+    void
+    link_merged_shards(const std::vector<Vector<InnerIdType>>& parts,
+                       const UnorderedMap<InnerIdType, int>& levels,
+                       const FlattenInterfacePtr& flatten);
+
+    // the ef closest vectors to query_id reachable in the bottom graph from entry_id
+    MaxHeap
+    search_by_id(InnerIdType query_id,
+                 InnerIdType entry_id,
+                 const FlattenInterfacePtr& flatten,
+                 uint64_t ef) const;
 
     void
-    reorder(const float* query,
-            const FlattenInterfacePtr& flatten_interface,
-            MaxHeap& candidate_heap,
-            int64_t k) const;
+    repair_deleted();
+
+    // runs repair_deleted on build_pool_, or at the next Add without a pool
+    void
+    schedule_repair();
+
+    // waits for the scheduled repair, if any, to finish
+    void
+    wait_repair() const;
+
+    void
+    rebuild_tombstones();
+
+    void
+    serialize_basic_info(StreamWriter& writer) const;
+
+    void
+    deserialize_basic_info(StreamReader& reader);
 
 private:
     FlattenInterfacePtr basic_flatten_codes_{nullptr};
     FlattenInterfacePtr high_precise_codes_{nullptr};
-    Vector<GraphInterfacePtr> route_graphs_;
+    HGraphRoutePtr route_{nullptr};
     GraphInterfacePtr bottom_graph_{nullptr};
 
     mutable bool use_reorder_{false};
@@ -210,15 +353,19 @@ private:
     std::default_random_engine level_generator_{2021};
     double mult_{1.0};
 
-    InnerIdType entry_point_id_{std::numeric_limits<InnerIdType>::max()};
-
     uint64_t ef_construct_{400};
 
+    ODescentParameterPtr odescent_param_{nullptr};
+
+    mutable SearchPlanStats search_plan_stats_;
+
     uint64_t total_count_{0};
 
     std::shared_ptr<VisitedListPool> pool_{nullptr};
 
+    // shared by searches and inserts, exclusive only for resize, repair and merge
     mutable std::shared_mutex global_mutex_;
+    std::mutex route_mutex_;  // serializes the inserts that publish a new route
     mutable MutexArrayPtr neighbors_mutex_;
     mutable std::shared_mutex add_mutex_;
 
@@ -233,6 +380,33 @@ private:
     ExtraInfoInterfacePtr extra_infos_{nullptr};
     uint64_t extra_info_size_{0};
 
+    // written under label_lookup_mutex_ or global_mutex_, both keep resize from replacing it
+    TombstoneTablePtr tombstones_{nullptr};
+    std::atomic<uint64_t> deleted_count_{0};
+    Vector<InnerIdType> pending_repair_ids_;
+    Vector<InnerIdType> free_slots_;
+
+    mutable std::mutex repair_mutex_;
+    mutable std::future<void> repair_future_;
+    std::atomic<bool> repair_requested_{false};
+
     static constexpr uint64_t DEFAULT_RESIZE_BIT = 10;
+
+    // the number of vectors whose odescent candidates are pruned in one task
+    static constexpr uint64_t PRUNE_BLOCK_SIZE = 1024;
+
+    // the number of vectors an add worker claims at a time
+    static constexpr uint64_t ADD_CHUNK_SIZE = 16;
+
+    // the odescent turns that stitch the route graphs of merged shards together
+    static constexpr int64_t MERGE_REFINE_TURN = 5;
+
+    // a merged shard is linked to the others from this many of its highest route members, and
+    //  from at most MERGE_BOUNDARY_COUNT of its vectors found close to them
+    static constexpr uint64_t MERGE_SEED_COUNT = 64;
+    static constexpr uint64_t MERGE_BOUNDARY_COUNT = 256;
+
+    // repair the graph once this ratio of the vectors is waiting for it
+    static constexpr double REPAIR_TRIGGER_RATIO = 0.01;
 };
 }  // namespace vsag
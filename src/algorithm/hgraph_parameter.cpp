@@ -67,6 +67,23 @@ HGraphParameter::FromJson(const JsonType& json) {
         if (build_params.contains(BUILD_THREAD_COUNT)) {
             this->build_thread_count = build_params[BUILD_THREAD_COUNT];
         }
+        if (build_params.contains(BUILD_GRAPH_TYPE)) {
+            this->graph_type = build_params[BUILD_GRAPH_TYPE];
+        }
+        CHECK_ARGUMENT(
+            this->graph_type == BUILD_GRAPH_TYPE_NSW or this->graph_type == GRAPH_TYPE_ODESCENT,
+            fmt::format("hgraph {} must be {} or {}, got {}",
+                        BUILD_GRAPH_TYPE,
+                        BUILD_GRAPH_TYPE_NSW,
+                        GRAPH_TYPE_ODESCENT,
+                        this->graph_type));
+        if (this->graph_type == GRAPH_TYPE_ODESCENT) {
+            // the odescent options live in build_params, the degree is the one of the graph
+            auto odescent_json = build_params;
+            odescent_json[GRAPH_PARAM_MAX_DEGREE] = graph_json[GRAPH_PARAM_MAX_DEGREE];
+            this->odescent_param = std::make_shared<ODescentParameter>();
+            this->odescent_param->FromJson(odescent_json);
+        }
     }
 
     CHECK_ARGUMENT(json.contains(HGRAPH_EXTRA_INFO_KEY),
@@ -90,6 +107,10 @@ HGraphParameter::ToJson() {
 
     json[BUILD_PARAMS_KEY][BUILD_EF_CONSTRUCTION] = this->ef_construction;
     json[BUILD_PARAMS_KEY][BUILD_THREAD_COUNT] = this->build_thread_count;
+    if (this->odescent_param != nullptr) {
+        json[BUILD_PARAMS_KEY].update(this->odescent_param->ToJson());
+    }
+    json[BUILD_PARAMS_KEY][BUILD_GRAPH_TYPE] = this->graph_type;
     json[HGRAPH_EXTRA_INFO_KEY] = this->extra_info_param->ToJson();
     return json;
 }
@@ -116,6 +137,21 @@ HGraphSearchParameters::FromJson(const std::string& json_string) {
     }
     CHECK_ARGUMENT((1 <= obj.ef_search) and (obj.ef_search <= 1000),
                    fmt::format("ef_search({}) must in range[1, 1000]", obj.ef_search));
+    if (params[INDEX_TYPE_HGRAPH].contains(HGRAPH_PARAMETER_TARGET_RECALL)) {
+        obj.target_recall = params[INDEX_TYPE_HGRAPH][HGRAPH_PARAMETER_TARGET_RECALL];
+        CHECK_ARGUMENT((0.0F < obj.target_recall) and (obj.target_recall <= 1.0F),
+                       fmt::format("target_recall({}) must in range(0, 1]", obj.target_recall));
+    }
+    if (params[INDEX_TYPE_HGRAPH].contains(HGRAPH_PARAMETER_ENTRY_POINT_COUNT)) {
+        obj.entry_point_count = params[INDEX_TYPE_HGRAPH][HGRAPH_PARAMETER_ENTRY_POINT_COUNT];
+        CHECK_ARGUMENT(
+            (1 <= obj.entry_point_count) and (obj.entry_point_count <= 64),
+            fmt::format("entry_point_count({}) must in range[1, 64]", obj.entry_point_count));
+    }
+    if (params[INDEX_TYPE_HGRAPH].contains(HGRAPH_PARAMETER_USE_FILTERED_EXPANSION)) {
+        obj.use_filtered_expansion =
+            params[INDEX_TYPE_HGRAPH][HGRAPH_PARAMETER_USE_FILTERED_EXPANSION];
+    }
 
     return obj;
 }
@@ -18,6 +18,8 @@
 #include "data_cell/extra_info_datacell_parameter.h"
 #include "data_cell/flatten_datacell_parameter.h"
 #include "data_cell/graph_interface_parameter.h"
+#include "impl/odescent_graph_parameter.h"
+#include "inner_string_params.h"
 #include "parameter.h"
 
 namespace vsag {
@@ -39,11 +41,14 @@ public:
     FlattenDataCellParamPtr precise_codes_param{nullptr};
     GraphInterfaceParamPtr bottom_graph_param{nullptr};
     ExtraInfoDataCellParamPtr extra_info_param{nullptr};
+    // set when the graph is built in bulk by odescent instead of by insertion
+    ODescentParameterPtr odescent_param{nullptr};
 
     bool use_reorder{false};
     bool ignore_reorder{false};
     uint64_t ef_construction{400};
     uint64_t build_thread_count{100};
+    std::string graph_type{BUILD_GRAPH_TYPE_NSW};
 
     std::string name;
 };
@@ -59,6 +64,13 @@ public:
     int64_t ef_search{30};
     bool use_reorder{false};
     bool use_extra_info_filter{false};
+    // below 1.0 a knn search stops adaptively once its top-k converges, ef_search is the cap
+    float target_recall{1.0F};
+    // the bottom graph search starts from this many entry points of the lowest route graph
+    int64_t entry_point_count{1};
+    // a very selective filter switches the search to the two-hop filtered expansion unless
+    //  this is false
+    bool use_filtered_expansion{true};
 
 private:
     HGraphSearchParameters() = default;
@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <queue>
 #include <string>
 
@@ -53,7 +54,8 @@ public:
     searchRange(const void* query_data,
                 float radius,
                 size_t ef,
-                const vsag::FilterPtr is_id_allowed = nullptr) const = 0;
+                const vsag::FilterPtr is_id_allowed = nullptr,
+                int64_t limited_size = -1) const = 0;
 
     // Return k nearest neighbor in the order of closer fist
     virtual std::vector<std::pair<dist_t, LabelType>>
@@ -77,6 +79,21 @@ public:
     virtual tl::expected<vsag::DatasetPtr, vsag::Error>
     getBatchDistanceByLabel(const int64_t* ids, const void* data_point, int64_t count) = 0;
 
+    // writes the distance of each label to distances, the max value for unknown labels
+    virtual void
+    getDistancesByLabel(const int64_t* labels,
+                        int64_t count,
+                        const void* data_point,
+                        dist_t* distances) {
+        for (int64_t i = 0; i < count; ++i) {
+            try {
+                distances[i] = getDistanceByLabel(labels[i], data_point);
+            } catch (const std::runtime_error& e) {
+                distances[i] = std::numeric_limits<dist_t>::max();
+            }
+        }
+    }
+
     virtual std::pair<int64_t, int64_t>
     getMinAndMaxId() = 0;
 
@@ -0,0 +1,149 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "deleted_slots.h"
+
+#include <new>
+#include <stdexcept>
+
+namespace hnswlib {
+
+static constexpr uint64_t SLOT_MASK = 0xFFFFFFFFULL;
+
+static bool
+set_bit(std::atomic<uint64_t>* bits, InnerIdType id) {
+    uint64_t bit = 1ULL << (id % 64);
+    return (bits[id / 64].fetch_or(bit, std::memory_order_acq_rel) & bit) == 0;
+}
+
+static bool
+clear_bit(std::atomic<uint64_t>* bits, InnerIdType id) {
+    uint64_t bit = 1ULL << (id % 64);
+    return (bits[id / 64].fetch_and(~bit, std::memory_order_acq_rel) & bit) != 0;
+}
+
+template <typename T>
+static std::atomic<T>*
+grow_atomic_array(vsag::Allocator* allocator,
+                  std::atomic<T>* old_array,
+                  uint64_t old_size,
+                  uint64_t new_size) {
+    auto* new_array = (std::atomic<T>*)allocator->Allocate(new_size * sizeof(std::atomic<T>));
+    if (new_array == nullptr) {
+        throw std::runtime_error("Not enough memory: failed to allocate deleted slots");
+    }
+    for (uint64_t i = 0; i < new_size; ++i) {
+        T value = i < old_size ? old_array[i].load(std::memory_order_relaxed) : 0;
+        new (new_array + i) std::atomic<T>(value);
+    }
+    allocator->Deallocate(old_array);
+    return new_array;
+}
+
+DeletedSlots::DeletedSlots(vsag::Allocator* allocator) : allocator_(allocator) {
+}
+
+DeletedSlots::~DeletedSlots() {
+    Reset();
+}
+
+void
+DeletedSlots::Resize(uint64_t new_max_elements) {
+    if (new_max_elements <= max_elements_) {
+        return;
+    }
+    auto old_words = (max_elements_ + 63) / 64;
+    auto new_words = (new_max_elements + 63) / 64;
+    bits_ = grow_atomic_array(allocator_, bits_, old_words, new_words);
+    queued_ = grow_atomic_array(allocator_, queued_, old_words, new_words);
+    next_ = grow_atomic_array(allocator_, next_, max_elements_, new_max_elements);
+    max_elements_ = new_max_elements;
+}
+
+void
+DeletedSlots::Reset() {
+    allocator_->Deallocate(bits_);
+    bits_ = nullptr;
+    allocator_->Deallocate(queued_);
+    queued_ = nullptr;
+    allocator_->Deallocate(next_);
+    next_ = nullptr;
+    head_.store(0);
+    max_elements_ = 0;
+}
+
+bool
+DeletedSlots::Mark(InnerIdType id) {
+    return set_bit(bits_, id);
+}
+
+bool
+DeletedSlots::Unmark(InnerIdType id) {
+    return clear_bit(bits_, id);
+}
+
+bool
+DeletedSlots::Push(InnerIdType id) {
+    if (not set_bit(queued_, id)) {
+        // pushing twice would link the entry into the stack a second time and cut it
+        return false;
+    }
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t new_head = 0;
+    do {
+        next_[id].store(static_cast<uint32_t>(head & SLOT_MASK), std::memory_order_relaxed);
+        new_head = ((head >> 32) + 1) << 32 | (static_cast<uint64_t>(id) + 1);
+    } while (not head_.compare_exchange_weak(
+        head, new_head, std::memory_order_release, std::memory_order_acquire));
+    return true;
+}
+
+bool
+DeletedSlots::Pop(InnerIdType& id) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t new_head = 0;
+    do {
+        auto slot = head & SLOT_MASK;
+        if (slot == 0) {
+            return false;
+        }
+        auto next = next_[slot - 1].load(std::memory_order_relaxed);
+        new_head = ((head >> 32) + 1) << 32 | next;
+    } while (not head_.compare_exchange_weak(
+        head, new_head, std::memory_order_acq_rel, std::memory_order_acquire));
+    id = static_cast<InnerIdType>((head & SLOT_MASK) - 1);
+    clear_bit(queued_, id);
+    return true;
+}
+
+void
+DeletedSlots::Swap(InnerIdType a, InnerIdType b) {
+    bool a_marked = IsMarked(a);
+    bool b_marked = IsMarked(b);
+    if (a_marked == b_marked) {
+        return;
+    }
+    auto from = a_marked ? a : b;
+    auto to = a_marked ? b : a;
+    Unmark(from);
+    Mark(to);
+    // the entry of from is stale now, the slot that took over the mark needs its own
+    auto queued_bit = 1ULL << (from % 64);
+    if (queued_[from / 64].load(std::memory_order_acquire) & queued_bit) {
+        Push(to);
+    }
+}
+
+}  // namespace hnswlib
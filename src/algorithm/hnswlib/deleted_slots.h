@@ -0,0 +1,89 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "typing.h"
+#include "vsag/allocator.h"
+
+namespace hnswlib {
+
+using InnerIdType = vsag::InnerIdType;
+
+// Deleted marks of an HNSW graph plus the slots that can be reclaimed by later inserts.
+// The marks are an atomic bitmap and the free slots a lock-free stack threaded through a
+// per-slot next array, so marking, checking, pushing and popping never take a lock.
+// A slot is on the stack at most once; an entry whose slot is no longer marked (e.g. after
+// Swap) is stale, and callers of Pop skip it. Resize, Reset and Swap must not run
+// concurrently with anything else.
+class DeletedSlots {
+public:
+    explicit DeletedSlots(vsag::Allocator* allocator);
+
+    ~DeletedSlots();
+
+    // grows the number of slots, keeps the existing marks and free slots
+    void
+    Resize(uint64_t new_max_elements);
+
+    // releases all marks and free slots
+    void
+    Reset();
+
+    bool
+    IsMarked(InnerIdType id) const {
+        return (bits_[id / 64].load(std::memory_order_acquire) >> (id % 64)) & 1;
+    }
+
+    // returns false if the slot is already marked
+    bool
+    Mark(InnerIdType id);
+
+    // returns false if the slot is not marked
+    bool
+    Unmark(InnerIdType id);
+
+    // makes a marked slot available to Pop, returns false if the slot is already on the stack
+    bool
+    Push(InnerIdType id);
+
+    // takes a slot pushed before, returns false if there is none
+    bool
+    Pop(InnerIdType& id);
+
+    // exchanges the marks of two slots, used when internal ids are swapped; the slot that takes
+    // over a mark is pushed if the other one was on the stack
+    void
+    Swap(InnerIdType a, InnerIdType b);
+
+private:
+    uint64_t max_elements_{0};
+    std::atomic<uint64_t>* bits_{nullptr};
+    // one bit per slot that is currently on the stack
+    std::atomic<uint64_t>* queued_{nullptr};
+
+    // free slots are stored as id + 1 so that 0 ends the stack; the upper half of head_ is a
+    // version counter bumped by every update, which keeps a stale compare-and-swap from
+    // succeeding after the same slot has been popped and pushed again
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint32_t>* next_{nullptr};
+
+    vsag::Allocator* const allocator_{nullptr};
+};
+
+}  // namespace hnswlib
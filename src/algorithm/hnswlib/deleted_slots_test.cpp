@@ -0,0 +1,153 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "deleted_slots.h"
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "default_allocator.h"
+
+using namespace hnswlib;
+
+TEST_CASE("DeletedSlots Basic Test", "[ut][DeletedSlots]") {
+    auto allocator = std::make_shared<vsag::DefaultAllocator>();
+    DeletedSlots slots(allocator.get());
+    slots.Resize(100);
+
+    SECTION("mark & unmark") {
+        REQUIRE_FALSE(slots.IsMarked(70));
+        REQUIRE(slots.Mark(70));
+        REQUIRE_FALSE(slots.Mark(70));
+        REQUIRE(slots.IsMarked(70));
+        REQUIRE_FALSE(slots.IsMarked(71));
+        REQUIRE(slots.Unmark(70));
+        REQUIRE_FALSE(slots.Unmark(70));
+        REQUIRE_FALSE(slots.IsMarked(70));
+    }
+
+    SECTION("push & pop") {
+        InnerIdType id = 0;
+        REQUIRE_FALSE(slots.Pop(id));
+        slots.Push(0);
+        slots.Push(99);
+        slots.Push(5);
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 5);
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 99);
+        slots.Push(7);
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 7);
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 0);
+        REQUIRE_FALSE(slots.Pop(id));
+    }
+
+    SECTION("push twice") {
+        REQUIRE(slots.Push(8));
+        REQUIRE_FALSE(slots.Push(8));
+        InnerIdType id = 0;
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 8);
+        REQUIRE_FALSE(slots.Pop(id));
+        REQUIRE(slots.Push(8));
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 8);
+    }
+
+    SECTION("swap & resize keep the slots") {
+        slots.Mark(3);
+        slots.Push(3);
+        slots.Swap(3, 4);
+        REQUIRE(slots.IsMarked(4));
+        REQUIRE_FALSE(slots.IsMarked(3));
+
+        slots.Resize(10000);
+        REQUIRE(slots.IsMarked(4));
+        REQUIRE_FALSE(slots.IsMarked(9999));
+        InnerIdType id = 0;
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 4);
+        // the entry of 3 is stale, the caller skips it
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 3);
+        REQUIRE_FALSE(slots.IsMarked(id));
+        REQUIRE_FALSE(slots.Pop(id));
+    }
+
+    SECTION("a stale entry becomes valid when the slot is marked again") {
+        slots.Mark(3);
+        slots.Push(3);
+        slots.Swap(3, 4);
+        slots.Mark(3);
+        REQUIRE_FALSE(slots.Push(3));
+        InnerIdType id = 0;
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 4);
+        REQUIRE(slots.Pop(id));
+        REQUIRE(id == 3);
+        REQUIRE(slots.IsMarked(id));
+        REQUIRE_FALSE(slots.Pop(id));
+    }
+}
+
+TEST_CASE("DeletedSlots Concurrent Test", "[ut][DeletedSlots]") {
+    auto allocator = std::make_shared<vsag::DefaultAllocator>();
+    DeletedSlots slots(allocator.get());
+    const uint32_t thread_count = 4;
+    const uint32_t per_thread = 2000;
+    slots.Resize(thread_count * per_thread);
+
+    std::vector<std::vector<InnerIdType>> popped(thread_count);
+    std::atomic<uint32_t> failed_marks{0};
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() {
+            for (uint32_t i = 0; i < per_thread; ++i) {
+                InnerIdType id = t * per_thread + i;
+                if (not slots.Mark(id)) {
+                    failed_marks++;
+                }
+                slots.Push(id);
+                if (i % 2 == 1 and slots.Pop(id)) {
+                    popped[t].push_back(id);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(failed_marks == 0);
+
+    // every pushed slot is popped exactly once
+    std::set<InnerIdType> all;
+    uint64_t total = 0;
+    for (const auto& ids : popped) {
+        all.insert(ids.begin(), ids.end());
+        total += ids.size();
+    }
+    InnerIdType id = 0;
+    while (slots.Pop(id)) {
+        all.insert(id);
+        ++total;
+    }
+    REQUIRE(total == thread_count * per_thread);
+    REQUIRE(all.size() == thread_count * per_thread);
+}
@@ -38,10 +38,12 @@ HierarchicalNSW::HierarchicalNSW(SpaceInterface* s,
     : allocator_(allocator),
       points_locks_(max_elements, allocator),
       allow_replace_deleted_(allow_replace_deleted),
+      upper_links_(allocator),
       use_reversed_edges_(use_reversed_edges),
+      reversed_edges_(allocator),
       normalize_(normalize),
       label_lookup_(allocator),
-      deleted_elements_(allocator) {
+      deleted_slots_(allocator) {
     max_elements_ = max_elements;
     num_deleted_ = 0;
     data_size_ = s->get_data_size();
@@ -85,14 +87,11 @@ HierarchicalNSW::reset() {
     }
     allocator_->Deallocate(element_levels_);
     element_levels_ = nullptr;
-    allocator_->Deallocate(reversed_level0_link_list_);
-    reversed_level0_link_list_ = nullptr;
-    allocator_->Deallocate(reversed_link_lists_);
-    reversed_link_lists_ = nullptr;
+    reversed_edges_.Reset();
     allocator_->Deallocate(molds_);
     molds_ = nullptr;
-    allocator_->Deallocate(link_lists_);
-    link_lists_ = nullptr;
+    upper_links_.Reset();
+    deleted_slots_.Reset();
 }
 
 bool
@@ -105,20 +104,7 @@ HierarchicalNSW::init_memory_space() {
         throw std::runtime_error("allocate data_level0_memory_ error");
     }
     if (use_reversed_edges_) {
-        reversed_level0_link_list_ =
-            (reverselinklist**)allocator_->Allocate(max_elements_ * sizeof(reverselinklist*));
-        if (reversed_level0_link_list_ == nullptr) {
-            throw std::runtime_error("allocate reversed_level0_link_list_ fail");
-        }
-        memset(reversed_level0_link_list_, 0, max_elements_ * sizeof(reverselinklist*));
-        reversed_link_lists_ = (vsag::UnorderedMap<int, reverselinklist>**)allocator_->Allocate(
-            max_elements_ * sizeof(vsag::UnorderedMap<int, reverselinklist>*));
-        if (reversed_link_lists_ == nullptr) {
-            throw std::runtime_error("allocate reversed_link_lists_ fail");
-        }
-        memset(reversed_link_lists_,
-               0,
-               max_elements_ * sizeof(vsag::UnorderedMap<int, reverselinklist>*));
+        reversed_edges_.Resize(max_elements_);
     }
 
     if (normalize_) {
@@ -126,29 +112,12 @@ HierarchicalNSW::init_memory_space() {
         molds_ = (float*)allocator_->Allocate(max_elements_ * sizeof(float));
     }
 
-    link_lists_ = (char**)allocator_->Allocate(sizeof(void*) * max_elements_);
-    if (link_lists_ == nullptr)
-        throw std::runtime_error("Not enough memory: HierarchicalNSW failed to allocate linklists");
-    memset(link_lists_, 0, sizeof(void*) * max_elements_);
+    upper_links_.Resize(max_elements_);
+    deleted_slots_.Resize(max_elements_);
     return true;
 }
 
 HierarchicalNSW::~HierarchicalNSW() {
-    if (link_lists_ != nullptr) {
-        for (InnerIdType i = 0; i < max_elements_; i++) {
-            if (element_levels_[i] > 0 || link_lists_[i] != nullptr)
-                allocator_->Deallocate(link_lists_[i]);
-        }
-    }
-
-    if (use_reversed_edges_) {
-        for (InnerIdType i = 0; i < max_elements_; i++) {
-            auto& in_edges_level0 = *(reversed_level0_link_list_ + i);
-            delete in_edges_level0;
-            auto& in_edges = *(reversed_link_lists_ + i);
-            delete in_edges;
-        }
-    }
     reset();
 }
 
@@ -208,6 +177,25 @@ HierarchicalNSW::getBatchDistanceByLabel(const int64_t* ids,
     return std::move(result);
 }
 
+void
+HierarchicalNSW::getDistancesByLabel(const int64_t* labels,
+                                     int64_t count,
+                                     const void* data_point,
+                                     float* distances) {
+    std::shared_lock lock_table(label_lookup_lock_);
+    std::shared_ptr<float[]> normalize_query;
+    normalizeVector(data_point, normalize_query);
+    for (int64_t i = 0; i < count; ++i) {
+        auto search = label_lookup_.find(labels[i]);
+        if (search == label_lookup_.end()) {
+            distances[i] = std::numeric_limits<float>::max();
+            continue;
+        }
+        distances[i] =
+            fstdistfunc_(data_point, getDataByInternalId(search->second), dist_func_param_);
+    }
+}
+
 std::pair<int64_t, int64_t>
 HierarchicalNSW::getMinAndMaxId() {
     int64_t min_id = INT64_MAX;
@@ -273,16 +261,12 @@ HierarchicalNSW::updateConnections(InnerIdType internal_id,
     if (use_reversed_edges_) {
         if (is_update) {
             for (int i = 0; i < cur_size; ++i) {
-                auto id = data[i];
-                auto& in_edges = getEdges(id, level);
                 // remove the node that point to the current node
-                in_edges.erase(internal_id);
+                reversed_edges_.Erase(data[i], level, internal_id);
             }
         }
         for (size_t i = 0; i < cand_neighbors.size(); i++) {
-            auto id = cand_neighbors[i];
-            auto& in_edges = getEdges(id, level);
-            in_edges.insert(internal_id);
+            reversed_edges_.Insert(cand_neighbors[i], level, internal_id);
         }
     }
     setBatchNeigohbors(internal_id, level, cand_neighbors.data(), cand_neighbors.size());
@@ -300,11 +284,10 @@ HierarchicalNSW::checkReverseConnection() {
             auto link_list = data + 1;
             auto size = getListCount(data);
             edge_count += size;
-            reversed_edge_count += getEdges(internal_id, level).size();
+            reversed_edge_count += getEdges(internal_id, level).size;
             for (int j = 0; j < size; ++j) {
                 auto id = link_list[j];
-                const auto& in_edges = getEdges(id, level);
-                if (in_edges.find(internal_id) == in_edges.end()) {
+                if (not getEdges(id, level).Contains(internal_id)) {
                     std::cout << "can not find internal_id (" << internal_id
                               << ") in its neighbor (" << id << ")" << std::endl;
                     return false;
@@ -328,7 +311,12 @@ HierarchicalNSW::bruteForce(const void* data_point,
                             const vsag::FilterPtr is_id_allowed) const {
     std::shared_lock resize_lock(resize_mutex_);
     std::priority_queue<std::pair<float, LabelType>> results;
+    std::shared_ptr<float[]> normalize_query;
+    normalizeVector(data_point, normalize_query);
     for (uint32_t i = 0; i < cur_element_count_; i++) {
+        if (isMarkedDeleted(i)) {
+            continue;
+        }
         if (is_id_allowed && not is_id_allowed->CheckValid(getExternalLabel(i))) {
             continue;
         }
@@ -572,41 +560,62 @@ HierarchicalNSW::searchBaseLayerST(InnerIdType ep_id,
                                    const void* data_point,
                                    float radius,
                                    int64_t ef,
-                                   const vsag::FilterPtr is_id_allowed) const {
+                                   const vsag::FilterPtr is_id_allowed,
+                                   int64_t limited_size) const {
     VisitedListPtr vl = visited_list_pool_->getFreeVisitedList();
     vl_type* visited_array = vl->mass;
     vl_type visited_array_tag = vl->curV;
 
-    MaxHeap top_candidates(allocator_);
+    auto result_radius = radius + vsag::THRESHOLD_ERROR;
+    auto expand_radius = radius * (1.0F + vsag::RANGE_SEARCH_SLACK) + vsag::THRESHOLD_ERROR;
+    auto beam_size = static_cast<size_t>(std::max<int64_t>(ef, 1));
+    auto result_limit = static_cast<size_t>(std::max<int64_t>(limited_size, 0));
+
+    // the beam keeps the ef closest nodes seen so far and only leads the search towards the
+    //  radius, the results are streamed into a buffer unless limited_size bounds them
+    MaxHeap beam(allocator_);
+    vsag::Vector<std::pair<float, InnerIdType>> buffer(allocator_);
+    MaxHeap limited_results(allocator_);
     MaxHeap candidate_set(allocator_);
 
-    float lower_bound;
-    if ((!has_deletions || !isMarkedDeleted(ep_id)) &&
-        ((!is_id_allowed) || is_id_allowed->CheckValid(getExternalLabel(ep_id)))) {
-        float dist = fstdistfunc_(data_point, getDataByInternalId(ep_id), dist_func_param_);
-        lower_bound = dist;
-        if (dist <= radius + vsag::THRESHOLD_ERROR)
-            top_candidates.emplace(dist, ep_id);
-        candidate_set.emplace(-dist, ep_id);
-    } else {
-        lower_bound = std::numeric_limits<float>::max();
-        candidate_set.emplace(-lower_bound, ep_id);
-    }
+    auto push = [&](float dist, InnerIdType internal_id) {
+        candidate_set.emplace(-dist, internal_id);
+        beam.emplace(dist, internal_id);
+        if (beam.size() > beam_size) {
+            beam.pop();
+        }
+        if (dist > result_radius or (has_deletions and isMarkedDeleted(internal_id)) or
+            (is_id_allowed and not is_id_allowed->CheckValid(getExternalLabel(internal_id)))) {
+            return;
+        }
+        if (result_limit == 0) {
+            buffer.emplace_back(dist, internal_id);
+        } else if (limited_results.size() < result_limit or
+                   dist < limited_results.top().first) {
+            limited_results.emplace(dist, internal_id);
+            if (limited_results.size() > result_limit) {
+                limited_results.pop();
+            }
+        }
+    };
 
+    push(fstdistfunc_(data_point, getDataByInternalId(ep_id), dist_func_param_), ep_id);
     visited_array[ep_id] = visited_array_tag;
-    uint64_t visited_count = 0;
 
     std::shared_ptr<char[]> link_data = std::shared_ptr<char[]>(new char[size_links_level0_]);
     while (not candidate_set.empty()) {
         std::pair<float, InnerIdType> current_node_pair = candidate_set.top();
-
+        float current_dist = -current_node_pair.first;
+        if (current_dist > expand_radius and beam.size() == beam_size and
+            current_dist > beam.top().first) {
+            break;
+        }
         candidate_set.pop();
 
         InnerIdType current_node_id = current_node_pair.second;
         getLinklistAtLevel(current_node_id, 0, link_data.get());
         int* data = (int*)link_data.get();
         size_t size = getListCount((linklistsizeint*)data);
-        //                bool cur_node_deleted = isMarkedDeleted(current_node_id);
         if (collect_metrics) {
             metric_hops_++;
             metric_distance_computations_ += size;
@@ -631,38 +640,28 @@ HierarchicalNSW::searchBaseLayerST(InnerIdType ep_id,
 #endif
             if (visited_array[candidate_id] != visited_array_tag) {
                 visited_array[candidate_id] = visited_array_tag;
-                ++visited_count;
 
                 char* currObj1 = (getDataByInternalId(candidate_id));
                 float dist = fstdistfunc_(data_point, currObj1, dist_func_param_);
 
-                if (visited_count < ef || dist <= radius + vsag::THRESHOLD_ERROR ||
-                    lower_bound > dist) {
-                    candidate_set.emplace(-dist, candidate_id);
+                if (dist <= expand_radius or beam.size() < beam_size or
+                    dist < beam.top().first) {
+                    push(dist, candidate_id);
                     vector_data_ptr = data_level0_memory_->GetElementPtr(candidate_set.top().second,
                                                                          offsetLevel0_);
 #ifdef USE_SSE
-                    _mm_prefetch(vector_data_ptr, _MM_HINT_T0);  ////////////////////////
+                    _mm_prefetch(vector_data_ptr, _MM_HINT_T0);
 #endif
-
-                    if ((!has_deletions || !isMarkedDeleted(candidate_id)) &&
-                        ((!is_id_allowed) ||
-                         is_id_allowed->CheckValid(getExternalLabel(candidate_id))))
-                        top_candidates.emplace(dist, candidate_id);
-
-                    if (not top_candidates.empty())
-                        lower_bound = top_candidates.top().first;
                 }
             }
         }
     }
-    while (not top_candidates.empty() &&
-           top_candidates.top().first > radius + vsag::THRESHOLD_ERROR) {
-        top_candidates.pop();
-    }
 
     visited_list_pool_->releaseVisitedList(vl);
-    return top_candidates;
+    if (result_limit > 0) {
+        return limited_results;
+    }
+    return MaxHeap(CompareByFirst(), std::move(buffer));
 }
 
 void
@@ -758,8 +757,7 @@ HierarchicalNSW::mutuallyConnectNewElement(InnerIdType cur_c,
             if (sz_link_list_other < m_curmax) {
                 appendNeigohbor(selectedNeighbor, level, cur_c, m_curmax);
                 if (use_reversed_edges_) {
-                    auto& cur_in_edges = getEdges(cur_c, level);
-                    cur_in_edges.insert(selectedNeighbor);
+                    reversed_edges_.Insert(cur_c, level, selectedNeighbor);
                 }
             } else {
                 // finding the "weakest" element to replace it with the new one
@@ -837,40 +835,12 @@ HierarchicalNSW::resizeIndex(size_t new_max_elements) {
         throw std::runtime_error("Not enough memory: resizeIndex failed to allocate base layer");
 
     if (use_reversed_edges_) {
-        auto reversed_level0_link_list_new = (reverselinklist**)allocator_->Reallocate(
-            reversed_level0_link_list_, new_max_elements * sizeof(reverselinklist*));
-        if (reversed_level0_link_list_new == nullptr) {
-            throw std::runtime_error(
-                "Not enough memory: resizeIndex failed to allocate reversed_level0_link_list_");
-        }
-        reversed_level0_link_list_ = reversed_level0_link_list_new;
-
-        memset(reversed_level0_link_list_ + max_elements_,
-               0,
-               (new_max_elements - max_elements_) * sizeof(reverselinklist*));
-
-        auto reversed_link_lists_new =
-            (vsag::UnorderedMap<int, reverselinklist>**)allocator_->Reallocate(
-                reversed_link_lists_,
-                new_max_elements * sizeof(vsag::UnorderedMap<int, reverselinklist>*));
-        if (reversed_link_lists_new == nullptr) {
-            throw std::runtime_error(
-                "Not enough memory: resizeIndex failed to allocate reversed_link_lists_");
-        }
-        reversed_link_lists_ = reversed_link_lists_new;
-        memset(
-            reversed_link_lists_ + max_elements_,
-            0,
-            (new_max_elements - max_elements_) * sizeof(vsag::UnorderedMap<int, reverselinklist>*));
+        reversed_edges_.Resize(new_max_elements);
     }
 
     // Reallocate all other layers
-    char** link_lists_new =
-        (char**)allocator_->Reallocate(link_lists_, sizeof(void*) * new_max_elements);
-    if (link_lists_new == nullptr)
-        throw std::runtime_error("Not enough memory: resizeIndex failed to allocate other layers");
-    link_lists_ = link_lists_new;
-    memset(link_lists_ + max_elements_, 0, (new_max_elements - max_elements_) * sizeof(void*));
+    upper_links_.Resize(new_max_elements);
+    deleted_slots_.Resize(new_max_elements);
     max_elements_ = new_max_elements;
 }
 
@@ -925,7 +895,7 @@ HierarchicalNSW::SerializeImpl(StreamWriter& writer) {
             element_levels_[i] > 0 ? size_links_per_element_ * element_levels_[i] : 0;
         WriteOne(writer, link_list_size);
         if (link_list_size) {
-            writer.Write(link_lists_[i], link_list_size);
+            writer.Write(upper_links_.Get(i), link_list_size);
         }
     }
     if (normalize_) {
@@ -986,14 +956,9 @@ HierarchicalNSW::DeserializeImpl(StreamReader& reader, SpaceInterface* s, size_t
         ReadOne(reader, link_list_size);
         if (link_list_size == 0) {
             element_levels_[i] = 0;
-            link_lists_[i] = nullptr;
         } else {
             element_levels_[i] = link_list_size / size_links_per_element_;
-            link_lists_[i] = (char*)allocator_->Allocate(link_list_size);
-            if (link_lists_[i] == nullptr)
-                throw std::runtime_error(
-                    "Not enough memory: loadIndex failed to allocate linklist");
-            reader.Read(link_lists_[i], link_list_size);
+            reader.Read(upper_links_.Allocate(i, link_list_size), link_list_size);
         }
     }
     if (normalize_) {
@@ -1010,19 +975,18 @@ HierarchicalNSW::DeserializeImpl(StreamReader& reader, SpaceInterface* s, size_t
                 auto link_list = data + 1;
                 auto size = getListCount(data);
                 for (int j = 0; j < size; ++j) {
-                    auto id = link_list[j];
-                    auto& in_edges = getEdges(id, level);
-                    in_edges.insert(internal_id);
+                    reversed_edges_.Insert(link_list[j], level, internal_id);
                 }
             }
         }
     }
 
     for (size_t i = 0; i < cur_element_count_; i++) {
-        if (isMarkedDeleted(i)) {
+        if (hasDeleteMark(i)) {
+            deleted_slots_.Mark(i);
             num_deleted_ += 1;
             if (allow_replace_deleted_)
-                deleted_elements_.insert(i);
+                deleted_slots_.Push(i);
         }
     }
 }
@@ -1078,20 +1042,37 @@ HierarchicalNSW::markDelete(LabelType label) {
 void
 HierarchicalNSW::markDeletedInternal(InnerIdType internalId) {
     assert(internalId < cur_element_count_);
-    if (!isMarkedDeleted(internalId)) {
-        unsigned char* ll_cur =
-            (unsigned char*)data_level0_memory_->GetElementPtr(internalId, offsetLevel0_) + 2;
-        *ll_cur |= DELETE_MARK;
+    if (deleted_slots_.Mark(internalId)) {
+        setDeleteMark(internalId, true);
         num_deleted_ += 1;
         if (allow_replace_deleted_) {
-            std::unique_lock<std::mutex> lock_deleted_elements(deleted_elements_lock_);
-            deleted_elements_.insert(internalId);
+            deleted_slots_.Push(internalId);
         }
     } else {
         throw std::runtime_error("The requested to delete element is already deleted");
     }
 }
 
+bool
+HierarchicalNSW::hasDeleteMark(InnerIdType internal_id) const {
+    std::shared_lock lock(points_locks_[internal_id]);
+    auto* ll_cur =
+        (unsigned char*)data_level0_memory_->GetElementPtr(internal_id, offsetLevel0_) + 2;
+    return *ll_cur & DELETE_MARK;
+}
+
+void
+HierarchicalNSW::setDeleteMark(InnerIdType internal_id, bool deleted) {
+    std::unique_lock lock(points_locks_[internal_id]);
+    auto* ll_cur =
+        (unsigned char*)data_level0_memory_->GetElementPtr(internal_id, offsetLevel0_) + 2;
+    if (deleted) {
+        *ll_cur |= DELETE_MARK;
+    } else {
+        *ll_cur &= ~DELETE_MARK;
+    }
+}
+
 /*
     * Adds point.
     */
@@ -1106,8 +1087,7 @@ HierarchicalNSW::addPoint(const void* data_point, LabelType label) {
 void
 HierarchicalNSW::modifyOutEdge(InnerIdType old_internal_id, InnerIdType new_internal_id) {
     for (int level = 0; level <= element_levels_[old_internal_id]; ++level) {
-        auto& edges = getEdges(old_internal_id, level);
-        for (const auto& in_node : edges) {
+        for (const auto& in_node : getEdges(old_internal_id, level)) {
             auto data = getLinklistAtLevel(in_node, level);
             size_t link_size = getListCount(data);
             auto* links = (InnerIdType*)(data + 1);
@@ -1130,11 +1110,10 @@ HierarchicalNSW::modifyInEdges(InnerIdType right_internal_id,
         size_t link_size = getListCount(data);
         auto* links = (InnerIdType*)(data + 1);
         for (int i = 0; i < link_size; ++i) {
-            auto& in_edges = getEdges(links[i], level);
             if (is_erase) {
-                in_edges.erase(wrong_internal_id);
+                reversed_edges_.Erase(links[i], level, wrong_internal_id);
             } else {
-                in_edges.insert(right_internal_id);
+                reversed_edges_.Insert(links[i], level, right_internal_id);
             }
         }
     }
@@ -1159,15 +1138,14 @@ HierarchicalNSW::swapConnections(InnerIdType pre_internal_id, InnerIdType post_i
         if (normalize_) {
             std::swap(molds_[pre_internal_id], molds_[post_internal_id]);
         }
-        std::swap(link_lists_[pre_internal_id], link_lists_[post_internal_id]);
+        upper_links_.Swap(pre_internal_id, post_internal_id);
+        deleted_slots_.Swap(pre_internal_id, post_internal_id);
         std::swap(element_levels_[pre_internal_id], element_levels_[post_internal_id]);
     }
 
     {
         // Repair the incorrect reverse edges caused by swapping two points.
-        std::swap(reversed_level0_link_list_[pre_internal_id],
-                  reversed_level0_link_list_[post_internal_id]);
-        std::swap(reversed_link_lists_[pre_internal_id], reversed_link_lists_[post_internal_id]);
+        reversed_edges_.Swap(pre_internal_id, post_internal_id);
 
         // First, remove the incorrect connectivity relationships in the reverse edges and then
         // proceed with the insertion. This avoids losing edges when a point simultaneously
@@ -1194,7 +1172,6 @@ HierarchicalNSW::dealNoInEdge(InnerIdType id, int level, int m_curmax, int skip_
     auto alone_data = getLinklistAtLevel(id, level);
     int alone_size = getListCount(alone_data);
     auto alone_link = (unsigned int*)(alone_data + 1);
-    auto& in_edges = getEdges(id, level);
     for (int j = 0; j < alone_size; ++j) {
         if (alone_link[j] == skip_c) {
             continue;
@@ -1205,11 +1182,63 @@ HierarchicalNSW::dealNoInEdge(InnerIdType id, int level, int m_curmax, int skip_
         if (to_edge_size_cur < m_curmax) {
             to_edge_data_link_cur[to_edge_size_cur] = id;
             setListCount(to_edge_data_cur, to_edge_size_cur + 1);
-            in_edges.insert(alone_link[j]);
+            reversed_edges_.Insert(id, level, alone_link[j]);
         }
     }
 }
 
+void
+HierarchicalNSW::repairNeighborsOfReplaced(InnerIdType cur_c, int level) {
+    // the old out-neighbors of the slot, and all its in-neighbors when reverse edges are kept,
+    //  choose their edges again among their two-hop neighborhood, as upstream updatePoint does
+    vsag::UnorderedSet<InnerIdType> neighbors(allocator_);
+    vsag::UnorderedSet<InnerIdType> candidates(allocator_);
+    std::shared_ptr<char[]> link_data = std::shared_ptr<char[]>(new char[size_links_level0_]);
+    auto* list = (linklistsizeint*)link_data.get();
+    getLinklistAtLevel(cur_c, level, link_data.get());
+    auto* links = (InnerIdType*)(list + 1);
+    for (int i = 0; i < getListCount(list); ++i) {
+        neighbors.insert(links[i]);
+    }
+    if (use_reversed_edges_) {
+        const auto& in_edges = getEdges(cur_c, level);
+        neighbors.insert(in_edges.begin(), in_edges.end());
+    }
+    candidates.insert(cur_c);
+    for (auto neighbor : neighbors) {
+        candidates.insert(neighbor);
+        getLinklistAtLevel(neighbor, level, link_data.get());
+        for (int i = 0; i < getListCount(list); ++i) {
+            candidates.insert(links[i]);
+        }
+    }
+
+    size_t m_curmax = level ? maxM_ : maxM0_;
+    vsag::Vector<InnerIdType> new_links(allocator_);
+    for (auto neighbor : neighbors) {
+        MaxHeap heap(allocator_);
+        for (auto candidate : candidates) {
+            if (candidate == neighbor) {
+                continue;
+            }
+            heap.emplace(fstdistfunc_(getDataByInternalId(neighbor),
+                                      getDataByInternalId(candidate),
+                                      dist_func_param_),
+                         candidate);
+            if (heap.size() > ef_construction_) {
+                heap.pop();
+            }
+        }
+        getNeighborsByHeuristic2(heap, m_curmax);
+        new_links.clear();
+        while (not heap.empty()) {
+            new_links.push_back(heap.top().second);
+            heap.pop();
+        }
+        updateConnections(neighbor, new_links, level, true);
+    }
+}
+
 void
 HierarchicalNSW::updateVector(LabelType label, const void* data_point) {
     std::unique_lock lock(label_lookup_lock_);
@@ -1270,7 +1299,10 @@ HierarchicalNSW::removePoint(LabelType label) {
 
         if (cur_c == 0) {
             for (int level = 0; level < element_levels_[cur_c]; ++level) {
-                getEdges(cur_c, level).clear();
+                reversed_edges_.Clear(cur_c, level);
+            }
+            if (deleted_slots_.Unmark(cur_c)) {
+                num_deleted_ -= 1;
             }
             enterpoint_node_ = -1;
             max_level_ = -1;
@@ -1279,6 +1311,10 @@ HierarchicalNSW::removePoint(LabelType label) {
             label_lookup_[getExternalLabel(cur_c)] = internal_id;
             swapConnections(cur_c, internal_id);
         }
+        // the removed point now sits in the dropped slot, whose stack entry turns stale
+        if (deleted_slots_.Unmark(cur_c)) {
+            num_deleted_ -= 1;
+        }
     }
 
     // If the node to be deleted is an entry node, find another top-level node.
@@ -1298,7 +1334,9 @@ HierarchicalNSW::removePoint(LabelType label) {
     // level. We connect each indegree node with each outdegree node, and then prune the
     // indegree nodes.
     for (int level = 0; level <= element_levels_[cur_c]; ++level) {
-        const auto in_edges_cur = getEdges(cur_c, level);
+        // copied since the repair below rewrites the in-edges of cur_c
+        const auto& edges_cur = getEdges(cur_c, level);
+        vsag::Vector<InnerIdType> in_edges_cur(edges_cur.begin(), edges_cur.end(), allocator_);
         auto data_cur = getLinklistAtLevel(cur_c, level);
         int size_cur = getListCount(data_cur);
         auto data_link_cur = (unsigned int*)(data_cur + 1);
@@ -1337,7 +1375,7 @@ HierarchicalNSW::removePoint(LabelType label) {
 
             if (candidates.empty()) {
                 setListCount(in_edge_data_cur, 0);
-                getEdges(cur_c, level).erase(in_edge);
+                reversed_edges_.Erase(cur_c, level, in_edge);
                 continue;
             }
             mutuallyConnectNewElement(in_edge, candidates, level, true);
@@ -1353,7 +1391,7 @@ HierarchicalNSW::removePoint(LabelType label) {
         }
 
         for (int i = 0; i < size_cur; ++i) {
-            getEdges(data_link_cur[i], level).erase(cur_c);
+            reversed_edges_.Erase(data_link_cur[i], level, cur_c);
         }
     }
 }
@@ -1362,6 +1400,7 @@ InnerIdType
 HierarchicalNSW::addPoint(const void* data_point, LabelType label, int level) {
     InnerIdType cur_c = 0;
     int curlevel;
+    bool reuse_slot = false;
     std::shared_ptr<float[]> normalize_data;
     normalizeVector(data_point, normalize_data);
     {
@@ -1373,24 +1412,44 @@ HierarchicalNSW::addPoint(const void* data_point, LabelType label, int level) {
             return -1;
         }
 
-        if (cur_element_count_ >= max_elements_) {
-            size_t extend_size = std::min(max_elements_, data_element_per_block_);
-            resizeIndex(max_elements_ + extend_size);
+        // a slot popped from deleted_slots_ stays marked until it is linked again, and keeps its
+        // levels and in-edges, which are repaired for the new vector before it is relinked;
+        // entries left stale by removePoint are no longer marked and are skipped
+        while (allow_replace_deleted_ and deleted_slots_.Pop(cur_c)) {
+            if (cur_c < cur_element_count_ and isMarkedDeleted(cur_c)) {
+                reuse_slot = true;
+                break;
+            }
         }
 
-        cur_c = cur_element_count_;
-        label_lookup_[label] = cur_c;
+        if (reuse_slot) {
+            curlevel = element_levels_[cur_c];
+        } else {
+            if (cur_element_count_ >= max_elements_) {
+                size_t extend_size = std::min(max_elements_, data_element_per_block_);
+                resizeIndex(max_elements_ + extend_size);
+            }
 
-        curlevel = getRandomLevel(mult_);
-        if (level > 0)
-            curlevel = level;
-        element_levels_[cur_c] = curlevel;
-        memset(data_level0_memory_->GetElementPtr(cur_c, offsetLevel0_), 0, size_data_per_element_);
+            cur_c = cur_element_count_;
+            curlevel = getRandomLevel(mult_);
+            if (level > 0)
+                curlevel = level;
+            element_levels_[cur_c] = curlevel;
+            memset(data_level0_memory_->GetElementPtr(cur_c, offsetLevel0_),
+                   0,
+                   size_data_per_element_);
+        }
+        label_lookup_[label] = cur_c;
 
-        // Initialisation of the data and label
-        setExternalLabel(cur_c, label);
-        memcpy(getDataByInternalId(cur_c), data_point, data_size_);
-        cur_element_count_++;
+        {
+            // Initialisation of the data and label, a reused slot is still linked into the graph
+            std::unique_lock point_lock(points_locks_[cur_c]);
+            setExternalLabel(cur_c, label);
+            memcpy(getDataByInternalId(cur_c), data_point, data_size_);
+        }
+        if (not reuse_slot) {
+            cur_element_count_++;
+        }
     }
 
     std::shared_lock resize_lock(resize_mutex_);
@@ -1401,13 +1460,8 @@ HierarchicalNSW::addPoint(const void* data_point, LabelType label, int level) {
     int64_t currObj = enterpoint_node_;
     int64_t enterpoint_copy = enterpoint_node_;
 
-    if (curlevel) {
-        auto new_link_lists = (char*)allocator_->Reallocate(link_lists_[cur_c],
-                                                            size_links_per_element_ * curlevel + 1);
-        if (new_link_lists == nullptr)
-            throw std::runtime_error("Not enough memory: addPoint failed to allocate linklist");
-        link_lists_[cur_c] = new_link_lists;
-        memset(link_lists_[cur_c], 0, size_links_per_element_ * curlevel + 1);
+    if (curlevel and not reuse_slot) {
+        upper_links_.Allocate(cur_c, size_links_per_element_ * curlevel);
     }
 
     if ((signed)currObj != -1) {
@@ -1441,7 +1495,14 @@ HierarchicalNSW::addPoint(const void* data_point, LabelType label, int level) {
             }
         }
 
-        bool epDeleted = isMarkedDeleted(enterpoint_copy);
+        if (reuse_slot) {
+            // the in-edges of the slot were chosen for its old vector
+            for (int lev = std::min(curlevel, maxlevelcopy); lev >= 0; lev--) {
+                repairNeighborsOfReplaced(cur_c, lev);
+            }
+        }
+
+        bool epDeleted = isMarkedDeleted(enterpoint_copy) and enterpoint_copy != cur_c;
         for (int lev = std::min(curlevel, maxlevelcopy); lev >= 0; lev--) {
             if (lev > maxlevelcopy)  // possible?
                 throw std::runtime_error("Level error");
@@ -1455,7 +1516,8 @@ HierarchicalNSW::addPoint(const void* data_point, LabelType label, int level) {
                 if (top_candidates.size() > ef_construction_)
                     top_candidates.pop();
             }
-            currObj = mutuallyConnectNewElement(cur_c, top_candidates, lev, false);
+            // a reused slot replaces its old out-edges and doesn't duplicate existing in-edges
+            currObj = mutuallyConnectNewElement(cur_c, top_candidates, lev, reuse_slot);
         }
     } else {
         // Do nothing for the first element
@@ -1463,6 +1525,12 @@ HierarchicalNSW::addPoint(const void* data_point, LabelType label, int level) {
         max_level_ = curlevel;
     }
 
+    if (reuse_slot) {
+        setDeleteMark(cur_c, false);
+        deleted_slots_.Unmark(cur_c);
+        num_deleted_ -= 1;
+    }
+
     // Releasing lock for the maximum level
     if (curlevel > maxlevelcopy) {
         enterpoint_node_ = cur_c;
@@ -1577,7 +1645,8 @@ std::priority_queue<std::pair<float, LabelType>>
 HierarchicalNSW::searchRange(const void* query_data,
                              float radius,
                              uint64_t ef,
-                             const vsag::FilterPtr is_id_allowed) const {
+                             const vsag::FilterPtr is_id_allowed,
+                             int64_t limited_size) const {
     std::shared_lock resize_lock(resize_mutex_);
     std::priority_queue<std::pair<float, LabelType>> result;
     if (cur_element_count_ == 0)
@@ -1621,11 +1690,11 @@ HierarchicalNSW::searchRange(const void* query_data,
 
     MaxHeap top_candidates(allocator_);
     if (num_deleted_ == 0) {
-        top_candidates =
-            searchBaseLayerST<false, true>(currObj, query_data, radius, ef, is_id_allowed);
+        top_candidates = searchBaseLayerST<false, true>(
+            currObj, query_data, radius, ef, is_id_allowed, limited_size);
     } else {
-        top_candidates =
-            searchBaseLayerST<true, true>(currObj, query_data, radius, ef, is_id_allowed);
+        top_candidates = searchBaseLayerST<true, true>(
+            currObj, query_data, radius, ef, is_id_allowed, limited_size);
     }
 
     while (not top_candidates.empty()) {
@@ -1638,6 +1707,68 @@ HierarchicalNSW::searchRange(const void* query_data,
     return result;
 }
 
+InnerIdType
+HierarchicalNSW::searchUpperLevels(const void* query_data) const {
+    std::shared_lock resize_lock(resize_mutex_);
+    InnerIdType currObj;
+    int max_level;
+    {
+        std::shared_lock data_loc(max_level_mutex_);
+        currObj = enterpoint_node_;
+        max_level = max_level_;
+    }
+    float curdist = fstdistfunc_(query_data, getDataByInternalId(currObj), dist_func_param_);
+
+    std::shared_ptr<char[]> link_data = std::shared_ptr<char[]>(new char[size_links_level0_]);
+    for (int level = max_level; level > 0; level--) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            getLinklistAtLevel(currObj, level, link_data.get());
+            auto* data = (unsigned int*)link_data.get();
+            int size = getListCount(data);
+
+            auto* datal = (InnerIdType*)(data + 1);
+            for (int i = 0; i < size; i++) {
+                InnerIdType cand = datal[i];
+                if (cand > max_elements_)
+                    throw std::runtime_error("cand error");
+                float d = fstdistfunc_(query_data, getDataByInternalId(cand), dist_func_param_);
+
+                if (d < curdist) {
+                    curdist = d;
+                    currObj = cand;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return currObj;
+}
+
+void
+HierarchicalNSW::getNeighborsAtLevel0(InnerIdType internal_id,
+                                      vsag::Vector<InnerIdType>& neighbors) const {
+    std::shared_lock resize_lock(resize_mutex_);
+    std::shared_lock lock(points_locks_[internal_id]);
+    auto* data = (linklistsizeint*)data_level0_memory_->GetElementPtr(internal_id, offsetLevel0_);
+    auto size = getListCount(data);
+    auto* datal = (InnerIdType*)(data + 1);
+    neighbors.assign(datal, datal + size);
+}
+
+void
+HierarchicalNSW::calcDistancesByInternalIds(const void* query_data,
+                                            const InnerIdType* internal_ids,
+                                            size_t count,
+                                            float* dists) const {
+    std::shared_lock resize_lock(resize_mutex_);
+    for (size_t i = 0; i < count; ++i) {
+        dists[i] =
+            fstdistfunc_(query_data, getDataByInternalId(internal_ids[i]), dist_func_param_);
+    }
+}
+
 void
 HierarchicalNSW::setDataAndGraph(vsag::FlattenInterfacePtr& data,
                                  vsag::GraphInterfacePtr& graph,
@@ -1676,5 +1807,6 @@ HierarchicalNSW::searchBaseLayerST<false, false>(InnerIdType ep_id,
                                                  const void* data_point,
                                                  float radius,
                                                  int64_t ef,
-                                                 const vsag::FilterPtr is_id_allowed) const;
+                                                 const vsag::FilterPtr is_id_allowed,
+                                                 int64_t limited_size) const;
 }  // namespace hnswlib
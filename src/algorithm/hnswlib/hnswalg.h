@@ -37,16 +37,18 @@
 #include "data_cell/flatten_interface.h"
 #include "data_cell/graph_interface.h"
 #include "default_allocator.h"
+#include "deleted_slots.h"
 #include "index/iterator_filter.h"
 #include "prefetch.h"
+#include "reverse_edges.h"
 #include "simd/simd.h"
+#include "upper_links.h"
 #include "visited_list_pool.h"
 #include "vsag/dataset.h"
 #include "vsag/iterator_context.h"
 namespace hnswlib {
 using InnerIdType = vsag::InnerIdType;
 using linklistsizeint = unsigned int;
-using reverselinklist = vsag::UnorderedSet<uint32_t>;
 struct CompareByFirst {
     constexpr bool
     operator()(std::pair<float, InnerIdType> const& a,
@@ -98,12 +100,11 @@ private:
     float* molds_{nullptr};
 
     std::shared_ptr<BlockManager> data_level0_memory_{nullptr};
-    char** link_lists_{nullptr};
+    UpperLinks upper_links_;
     int* element_levels_{nullptr};  // keeps level of each element
 
     bool use_reversed_edges_{false};
-    reverselinklist** reversed_level0_link_list_{nullptr};
-    vsag::UnorderedMap<int, reverselinklist>** reversed_link_lists_{nullptr};
+    ReverseEdges reversed_edges_;
 
     size_t data_size_{0};
     size_t prefetch_jump_code_size_{1};
@@ -128,8 +129,8 @@ private:
     // flag to replace deleted elements (marked as deleted) during insertion
     bool allow_replace_deleted_{false};
 
-    std::mutex deleted_elements_lock_{};                // lock for deleted_elements_
-    vsag::UnorderedSet<InnerIdType> deleted_elements_;  // contains internal ids of deleted elements
+    // deleted marks, and the reclaimable slots when allow_replace_deleted_ is set
+    DeletedSlots deleted_slots_;
 
 public:
     HierarchicalNSW(SpaceInterface* s,
@@ -153,6 +154,13 @@ public:
 
     tl::expected<vsag::DatasetPtr, vsag::Error>
     getBatchDistanceByLabel(const int64_t* ids, const void* data_point, int64_t count) override;
+
+    void
+    getDistancesByLabel(const int64_t* labels,
+                        int64_t count,
+                        const void* data_point,
+                        float* distances) override;
+
     std::pair<int64_t, int64_t>
     getMinAndMaxId() override;
     bool
@@ -187,25 +195,9 @@ public:
                     sizeof(LabelType));
     }
 
-    inline reverselinklist&
-    getEdges(InnerIdType internal_id, int level = 0) {
-        if (level != 0) {
-            auto& edge_map_ptr = reversed_link_lists_[internal_id];
-            if (edge_map_ptr == nullptr) {
-                edge_map_ptr = new vsag::UnorderedMap<int, reverselinklist>(allocator_);
-            }
-            auto& edge_map = *edge_map_ptr;
-            if (edge_map.find(level) == edge_map.end()) {
-                edge_map.insert(std::make_pair(level, reverselinklist(allocator_)));
-            }
-            return edge_map.at(level);
-        } else {
-            auto& edge_ptr = reversed_level0_link_list_[internal_id];
-            if (edge_ptr == nullptr) {
-                edge_ptr = new reverselinklist(allocator_);
-            }
-            return *edge_ptr;
-        }
+    inline const ReverseEdgeList&
+    getEdges(InnerIdType internal_id, int level = 0) const {
+        return reversed_edges_.Get(internal_id, level);
     }
 
     void
@@ -263,7 +255,8 @@ public:
                       const void* data_point,
                       float radius,
                       int64_t ef,
-                      const vsag::FilterPtr is_id_allowed = nullptr) const;
+                      const vsag::FilterPtr is_id_allowed = nullptr,
+                      int64_t limited_size = -1) const;
 
     void
     getNeighborsByHeuristic2(MaxHeap& top_candidates, size_t M);
@@ -284,7 +277,8 @@ public:
 
     linklistsizeint*
     getLinklist(InnerIdType internal_id, int level) const {
-        return (linklistsizeint*)(link_lists_[internal_id] + (level - 1) * size_links_per_element_);
+        return (linklistsizeint*)(upper_links_.Get(internal_id) +
+                                  (level - 1) * size_links_per_element_);
     }
 
     linklistsizeint*
@@ -301,7 +295,7 @@ public:
         } else {
             std::shared_lock lock(points_locks_[internal_id]);
             std::memcpy(neighbors,
-                        link_lists_[internal_id] + (level - 1) * size_links_per_element_,
+                        upper_links_.Get(internal_id) + (level - 1) * size_links_per_element_,
                         size_links_per_element_);
         }
     }
@@ -355,14 +349,18 @@ public:
     markDeletedInternal(InnerIdType internal_id);
 
     /*
-    * Checks the first 16 bits of the memory to see if the element is marked deleted.
+    * The mark stored next to the level 0 list size, which is what gets serialized. Searches
+    * check deleted_slots_ instead.
     */
+    bool
+    hasDeleteMark(InnerIdType internal_id) const;
+
+    void
+    setDeleteMark(InnerIdType internal_id, bool deleted);
+
     bool
     isMarkedDeleted(InnerIdType internal_id) const {
-        std::shared_ptr<char[]> data = std::shared_ptr<char[]>(new char[size_links_level0_]);
-        getLinklistAtLevel(internal_id, 0, data.get());
-        unsigned char* ll_cur = ((unsigned char*)data.get()) + 2;
-        return *ll_cur & DELETE_MARK;
+        return deleted_slots_.IsMarked(internal_id);
     }
 
     static inline unsigned short int
@@ -393,6 +391,10 @@ public:
     void
     dealNoInEdge(InnerIdType id, int level, int m_curmax, int skip_c);
 
+    // reselect the edges of the nodes that may link to the old vector of a reused slot
+    void
+    repairNeighborsOfReplaced(InnerIdType cur_c, int level);
+
     void
     updateLabel(LabelType old_label, LabelType new_label);
 
@@ -418,7 +420,22 @@ public:
     searchRange(const void* query_data,
                 float radius,
                 uint64_t ef,
-                const vsag::FilterPtr is_id_allowed = nullptr) const override;
+                const vsag::FilterPtr is_id_allowed = nullptr,
+                int64_t limited_size = -1) const override;
+
+    // greedy descent through the upper levels, returns the level 0 entry point of a
+    //  normalized query
+    InnerIdType
+    searchUpperLevels(const void* query_data) const;
+
+    void
+    getNeighborsAtLevel0(InnerIdType internal_id, vsag::Vector<InnerIdType>& neighbors) const;
+
+    void
+    calcDistancesByInternalIds(const void* query_data,
+                               const InnerIdType* internal_ids,
+                               size_t count,
+                               float* dists) const;
 
     void
     reset();
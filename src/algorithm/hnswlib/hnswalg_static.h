@@ -1544,7 +1544,8 @@ public:
     searchRange(const void* query_data,
                 float radius,
                 uint64_t ef,
-                const vsag::FilterPtr is_id_allowed = nullptr) const override {
+                const vsag::FilterPtr is_id_allowed = nullptr,
+                int64_t limited_size = -1) const override {
         std::runtime_error("static hnsw does not support range search");
         //        std::priority_queue<std::pair<float, LabelType>> result;
         //        if (cur_element_count_ == 0)
@@ -1614,6 +1615,9 @@ public:
                const vsag::FilterPtr is_id_allowed) const override {
         std::priority_queue<std::pair<float, LabelType>> results;
         for (uint32_t i = 0; i < cur_element_count_; i++) {
+            if (isMarkedDeleted(i)) {
+                continue;
+            }
             if (is_id_allowed && not is_id_allowed->CheckValid(getExternalLabel(i))) {
                 continue;
             }
@@ -0,0 +1,169 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "reverse_edges.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace hnswlib {
+
+static constexpr uint32_t INITIAL_LIST_CAPACITY = 4;
+
+bool
+ReverseEdgeList::Contains(InnerIdType id) const {
+    return std::find(begin(), end(), id) != end();
+}
+
+ReverseEdges::ReverseEdges(vsag::Allocator* allocator) : allocator_(allocator) {
+}
+
+ReverseEdges::~ReverseEdges() {
+    Reset();
+}
+
+void
+ReverseEdges::Resize(uint64_t new_max_elements) {
+    if (new_max_elements <= max_elements_) {
+        return;
+    }
+    auto* new_level0 = (ReverseEdgeList*)allocator_->Reallocate(
+        level0_, new_max_elements * sizeof(ReverseEdgeList));
+    if (new_level0 == nullptr) {
+        throw std::runtime_error("Not enough memory: failed to allocate reversed edges");
+    }
+    level0_ = new_level0;
+    auto* new_upper =
+        (UpperLevels*)allocator_->Reallocate(upper_, new_max_elements * sizeof(UpperLevels));
+    if (new_upper == nullptr) {
+        throw std::runtime_error("Not enough memory: failed to allocate reversed edges");
+    }
+    upper_ = new_upper;
+    std::fill(level0_ + max_elements_, level0_ + new_max_elements, ReverseEdgeList());
+    std::fill(upper_ + max_elements_, upper_ + new_max_elements, UpperLevels());
+    max_elements_ = new_max_elements;
+}
+
+void
+ReverseEdges::Reset() {
+    for (uint64_t i = 0; i < max_elements_; ++i) {
+        release(level0_[i]);
+        auto& upper = upper_[i];
+        for (uint32_t level = 0; level < upper.level_count; ++level) {
+            release(upper.lists[level]);
+        }
+        allocator_->Deallocate(upper.lists);
+    }
+    allocator_->Deallocate(level0_);
+    level0_ = nullptr;
+    allocator_->Deallocate(upper_);
+    upper_ = nullptr;
+    max_elements_ = 0;
+}
+
+const ReverseEdgeList&
+ReverseEdges::Get(InnerIdType id, int level) const {
+    static const ReverseEdgeList EMPTY_LIST;
+    if (level == 0) {
+        return level0_[id];
+    }
+    const auto& upper = upper_[id];
+    if (static_cast<uint32_t>(level) > upper.level_count) {
+        return EMPTY_LIST;
+    }
+    return upper.lists[level - 1];
+}
+
+bool
+ReverseEdges::Insert(InnerIdType id, int level, InnerIdType from) {
+    auto* list = get_mutable(id, level, true);
+    if (list->Contains(from)) {
+        return false;
+    }
+    if (list->size == list->capacity) {
+        uint32_t new_capacity = std::max(INITIAL_LIST_CAPACITY, list->capacity * 2);
+        auto* new_ids =
+            (InnerIdType*)allocator_->Reallocate(list->ids, new_capacity * sizeof(InnerIdType));
+        if (new_ids == nullptr) {
+            throw std::runtime_error("Not enough memory: failed to grow reversed edges");
+        }
+        list->ids = new_ids;
+        list->capacity = new_capacity;
+    }
+    list->ids[list->size++] = from;
+    return true;
+}
+
+bool
+ReverseEdges::Erase(InnerIdType id, int level, InnerIdType from) {
+    auto* list = get_mutable(id, level, false);
+    if (list == nullptr) {
+        return false;
+    }
+    auto* end = list->ids + list->size;
+    auto* pos = std::find(list->ids, end, from);
+    if (pos == end) {
+        return false;
+    }
+    *pos = *(end - 1);
+    --list->size;
+    return true;
+}
+
+void
+ReverseEdges::Clear(InnerIdType id, int level) {
+    auto* list = get_mutable(id, level, false);
+    if (list != nullptr) {
+        list->size = 0;
+    }
+}
+
+void
+ReverseEdges::Swap(InnerIdType a, InnerIdType b) {
+    std::swap(level0_[a], level0_[b]);
+    std::swap(upper_[a], upper_[b]);
+}
+
+ReverseEdgeList*
+ReverseEdges::get_mutable(InnerIdType id, int level, bool create) {
+    if (level == 0) {
+        return level0_ + id;
+    }
+    auto& upper = upper_[id];
+    if (static_cast<uint32_t>(level) > upper.level_count) {
+        if (not create) {
+            return nullptr;
+        }
+        auto* new_lists =
+            (ReverseEdgeList*)allocator_->Reallocate(upper.lists, level * sizeof(ReverseEdgeList));
+        if (new_lists == nullptr) {
+            throw std::runtime_error("Not enough memory: failed to grow reversed edges");
+        }
+        std::fill(new_lists + upper.level_count, new_lists + level, ReverseEdgeList());
+        upper.lists = new_lists;
+        upper.level_count = level;
+    }
+    return upper.lists + level - 1;
+}
+
+void
+ReverseEdges::release(ReverseEdgeList& list) {
+    allocator_->Deallocate(list.ids);
+    list = ReverseEdgeList();
+}
+
+}  // namespace hnswlib
@@ -0,0 +1,107 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "typing.h"
+#include "vsag/allocator.h"
+
+namespace hnswlib {
+
+using InnerIdType = vsag::InnerIdType;
+
+// In-edges of one point on one level: an unordered id array grown by doubling.
+struct ReverseEdgeList {
+    InnerIdType* ids{nullptr};
+    uint32_t size{0};
+    uint32_t capacity{0};
+
+    const InnerIdType*
+    begin() const {
+        return ids;
+    }
+
+    const InnerIdType*
+    end() const {
+        return ids + size;
+    }
+
+    bool
+    empty() const {
+        return size == 0;
+    }
+
+    bool
+    Contains(InnerIdType id) const;
+};
+
+// Reverse adjacency of an HNSW graph. Level 0 lists are stored flat, one 16-byte header per
+// point; upper levels get a per-point header array only once a point has an in-edge there.
+// Compared with a hash set per (point, level) this costs 4 bytes per edge plus the header.
+class ReverseEdges {
+public:
+    explicit ReverseEdges(vsag::Allocator* allocator);
+
+    ~ReverseEdges();
+
+    // grows the number of points, keeps the existing edges
+    void
+    Resize(uint64_t new_max_elements);
+
+    // releases all lists and the point arrays
+    void
+    Reset();
+
+    const ReverseEdgeList&
+    Get(InnerIdType id, int level) const;
+
+    // returns false if the edge is already present
+    bool
+    Insert(InnerIdType id, int level, InnerIdType from);
+
+    // returns false if the edge is absent
+    bool
+    Erase(InnerIdType id, int level, InnerIdType from);
+
+    // drops the edges of one list but keeps its buffer for reuse
+    void
+    Clear(InnerIdType id, int level);
+
+    // exchanges every level of two points, used when internal ids are swapped
+    void
+    Swap(InnerIdType a, InnerIdType b);
+
+private:
+    struct UpperLevels {
+        ReverseEdgeList* lists{nullptr};  // lists[i] holds level i + 1
+        uint32_t level_count{0};
+    };
+
+    ReverseEdgeList*
+    get_mutable(InnerIdType id, int level, bool create);
+
+    void
+    release(ReverseEdgeList& list);
+
+private:
+    uint64_t max_elements_{0};
+    ReverseEdgeList* level0_{nullptr};
+    UpperLevels* upper_{nullptr};
+    vsag::Allocator* const allocator_{nullptr};
+};
+
+}  // namespace hnswlib
@@ -0,0 +1,77 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "reverse_edges.h"
+
+#include <set>
+
+#include "catch2/catch_test_macros.hpp"
+#include "default_allocator.h"
+
+using namespace hnswlib;
+
+static std::set<InnerIdType>
+to_set(const ReverseEdgeList& list) {
+    return {list.begin(), list.end()};
+}
+
+TEST_CASE("ReverseEdges Basic Test", "[ut][ReverseEdges]") {
+    auto allocator = std::make_shared<vsag::DefaultAllocator>();
+    ReverseEdges edges(allocator.get());
+    edges.Resize(10);
+
+    SECTION("insert & erase") {
+        for (InnerIdType from = 1; from < 10; ++from) {
+            REQUIRE(edges.Insert(0, 0, from));
+        }
+        REQUIRE_FALSE(edges.Insert(0, 0, 3));
+        REQUIRE(edges.Get(0, 0).size == 9);
+
+        REQUIRE(edges.Erase(0, 0, 3));
+        REQUIRE_FALSE(edges.Erase(0, 0, 3));
+        REQUIRE_FALSE(edges.Get(0, 0).Contains(3));
+        REQUIRE(to_set(edges.Get(0, 0)) == std::set<InnerIdType>{1, 2, 4, 5, 6, 7, 8, 9});
+
+        edges.Clear(0, 0);
+        REQUIRE(edges.Get(0, 0).empty());
+    }
+
+    SECTION("upper levels are created on demand") {
+        REQUIRE(edges.Get(1, 3).empty());
+        REQUIRE_FALSE(edges.Erase(1, 3, 2));
+        REQUIRE(edges.Insert(1, 3, 2));
+        REQUIRE(edges.Insert(1, 1, 4));
+        REQUIRE(to_set(edges.Get(1, 3)) == std::set<InnerIdType>{2});
+        REQUIRE(to_set(edges.Get(1, 1)) == std::set<InnerIdType>{4});
+        REQUIRE(edges.Get(1, 2).empty());
+        REQUIRE(edges.Get(1, 0).empty());
+    }
+
+    SECTION("swap & resize keep the edges") {
+        edges.Insert(2, 0, 5);
+        edges.Insert(2, 2, 6);
+        edges.Insert(3, 0, 7);
+        edges.Swap(2, 3);
+        REQUIRE(to_set(edges.Get(3, 0)) == std::set<InnerIdType>{5});
+        REQUIRE(to_set(edges.Get(3, 2)) == std::set<InnerIdType>{6});
+        REQUIRE(to_set(edges.Get(2, 0)) == std::set<InnerIdType>{7});
+        REQUIRE(edges.Get(2, 2).empty());
+
+        edges.Resize(1000);
+        REQUIRE(to_set(edges.Get(3, 2)) == std::set<InnerIdType>{6});
+        REQUIRE(edges.Get(999, 0).empty());
+        REQUIRE(edges.Insert(999, 1, 3));
+    }
+}
@@ -0,0 +1,122 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "upper_links.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace hnswlib {
+
+static constexpr uint64_t MIN_BLOCK_SIZE = 64 * 1024;
+static constexpr uint64_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+UpperLinks::UpperLinks(vsag::Allocator* allocator) : allocator_(allocator) {
+}
+
+UpperLinks::~UpperLinks() {
+    Reset();
+}
+
+void
+UpperLinks::Resize(uint64_t new_max_elements) {
+    if (new_max_elements <= max_elements_) {
+        return;
+    }
+    auto* new_spans = (char**)allocator_->Reallocate(spans_, new_max_elements * sizeof(char*));
+    if (new_spans == nullptr) {
+        throw std::runtime_error("Not enough memory: failed to allocate upper links");
+    }
+    spans_ = new_spans;
+    auto* new_capacities =
+        (uint32_t*)allocator_->Reallocate(capacities_, new_max_elements * sizeof(uint32_t));
+    if (new_capacities == nullptr) {
+        throw std::runtime_error("Not enough memory: failed to allocate upper links");
+    }
+    capacities_ = new_capacities;
+    std::fill(spans_ + max_elements_, spans_ + new_max_elements, nullptr);
+    std::fill(capacities_ + max_elements_, capacities_ + new_max_elements, 0);
+    max_elements_ = new_max_elements;
+}
+
+void
+UpperLinks::Reset() {
+    for (uint64_t i = 0; i < block_count_; ++i) {
+        allocator_->Deallocate(blocks_[i]);
+    }
+    allocator_->Deallocate(blocks_);
+    blocks_ = nullptr;
+    block_count_ = 0;
+    block_capacity_ = 0;
+    block_size_ = 0;
+    block_used_ = 0;
+
+    allocator_->Deallocate(spans_);
+    spans_ = nullptr;
+    allocator_->Deallocate(capacities_);
+    capacities_ = nullptr;
+    max_elements_ = 0;
+}
+
+char*
+UpperLinks::Allocate(InnerIdType id, uint64_t size) {
+    if (size > capacities_[id]) {
+        // a smaller span left behind by a removed point stays in its block until Reset
+        spans_[id] = bump(size);
+        capacities_[id] = static_cast<uint32_t>(size);
+    }
+    std::memset(spans_[id], 0, size);
+    return spans_[id];
+}
+
+void
+UpperLinks::Swap(InnerIdType a, InnerIdType b) {
+    std::swap(spans_[a], spans_[b]);
+    std::swap(capacities_[a], capacities_[b]);
+}
+
+char*
+UpperLinks::bump(uint64_t size) {
+    std::lock_guard lock(block_mutex_);
+    if (block_count_ == 0 or block_used_ + size > block_size_) {
+        // blocks grow with the arena, so large graphs end up with few of them
+        auto new_block_size = std::clamp(block_size_ * 2, MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+        new_block_size = std::max(new_block_size, size);
+        if (block_count_ == block_capacity_) {
+            auto new_capacity = std::max(block_capacity_ * 2, static_cast<uint64_t>(8));
+            auto* new_blocks =
+                (char**)allocator_->Reallocate(blocks_, new_capacity * sizeof(char*));
+            if (new_blocks == nullptr) {
+                throw std::runtime_error("Not enough memory: failed to grow upper links");
+            }
+            blocks_ = new_blocks;
+            block_capacity_ = new_capacity;
+        }
+        auto* block = (char*)allocator_->Allocate(new_block_size);
+        if (block == nullptr) {
+            throw std::runtime_error("Not enough memory: failed to grow upper links");
+        }
+        blocks_[block_count_++] = block;
+        block_size_ = new_block_size;
+        block_used_ = 0;
+    }
+    char* span = blocks_[block_count_ - 1] + block_used_;
+    block_used_ += size;
+    return span;
+}
+
+}  // namespace hnswlib
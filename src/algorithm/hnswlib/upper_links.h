@@ -0,0 +1,78 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+#include "typing.h"
+#include "vsag/allocator.h"
+
+namespace hnswlib {
+
+using InnerIdType = vsag::InnerIdType;
+
+// Upper level link lists of an HNSW graph. Every point above level 0 owns one contiguous span
+// holding all of its upper levels; spans are bump allocated from a few large blocks, so loading
+// an index costs a handful of allocations instead of one per point. Blocks never move, so the
+// span table can hand out plain pointers while other threads keep inserting.
+class UpperLinks {
+public:
+    explicit UpperLinks(vsag::Allocator* allocator);
+
+    ~UpperLinks();
+
+    // grows the span table, keeps the existing spans
+    void
+    Resize(uint64_t new_max_elements);
+
+    // releases the span table and all blocks
+    void
+    Reset();
+
+    char*
+    Get(InnerIdType id) const {
+        return spans_[id];
+    }
+
+    // returns a zeroed span of size bytes for id, reusing its current span when large enough
+    char*
+    Allocate(InnerIdType id, uint64_t size);
+
+    // exchanges the spans of two points, used when internal ids are swapped
+    void
+    Swap(InnerIdType a, InnerIdType b);
+
+private:
+    char*
+    bump(uint64_t size);
+
+private:
+    uint64_t max_elements_{0};
+    char** spans_{nullptr};
+    uint32_t* capacities_{nullptr};
+
+    char** blocks_{nullptr};
+    uint64_t block_count_{0};
+    uint64_t block_capacity_{0};
+    uint64_t block_size_{0};
+    uint64_t block_used_{0};
+    std::mutex block_mutex_;
+
+    vsag::Allocator* const allocator_{nullptr};
+};
+
+}  // namespace hnswlib
@@ -0,0 +1,81 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "upper_links.h"
+
+#include <cstring>
+
+#include "catch2/catch_test_macros.hpp"
+#include "default_allocator.h"
+
+using namespace hnswlib;
+
+static bool
+is_zero(const char* span, uint64_t size) {
+    for (uint64_t i = 0; i < size; ++i) {
+        if (span[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("UpperLinks Basic Test", "[ut][UpperLinks]") {
+    auto allocator = std::make_shared<vsag::DefaultAllocator>();
+    UpperLinks links(allocator.get());
+    links.Resize(10);
+
+    SECTION("spans are packed and zeroed") {
+        auto* first = links.Allocate(0, 68);
+        auto* second = links.Allocate(1, 136);
+        REQUIRE(links.Get(0) == first);
+        REQUIRE(links.Get(1) == second);
+        REQUIRE(second == first + 68);
+        REQUIRE(is_zero(first, 68));
+        REQUIRE(is_zero(second, 136));
+    }
+
+    SECTION("a span is reused when large enough") {
+        auto* span = links.Allocate(2, 136);
+        std::memset(span, 1, 136);
+        REQUIRE(links.Allocate(2, 68) == span);
+        REQUIRE(is_zero(span, 68));
+        auto* larger = links.Allocate(2, 204);
+        REQUIRE(larger != span);
+        REQUIRE(is_zero(larger, 204));
+    }
+
+    SECTION("swap & resize keep the spans") {
+        auto* span = links.Allocate(3, 68);
+        span[0] = 7;
+        links.Swap(3, 4);
+        REQUIRE(links.Get(4) == span);
+        REQUIRE(links.Get(3) == nullptr);
+
+        links.Resize(100000);
+        REQUIRE(links.Get(4) == span);
+        REQUIRE(links.Get(4)[0] == 7);
+        REQUIRE(links.Get(99999) == nullptr);
+    }
+
+    SECTION("spans larger than a block") {
+        uint64_t size = 32 * 1024 * 1024;
+        auto* small = links.Allocate(5, 68);
+        auto* large = links.Allocate(6, size);
+        REQUIRE(is_zero(large, size));
+        REQUIRE(links.Get(5) == small);
+        REQUIRE(links.Allocate(7, 68) != nullptr);
+    }
+}
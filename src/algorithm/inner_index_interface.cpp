@@ -29,6 +29,52 @@ InnerIndexInterface::InnerIndexInterface(ParamPtr index_param, const IndexCommon
       data_type_(common_param.data_type_) {
     this->label_table_ = std::make_shared<LabelTable>(allocator_);
     this->index_feature_list_ = std::make_shared<IndexFeatureList>();
+    this->bitmap_cache_ = std::make_shared<InnerIdBitmapCache>(allocator_);
+    if (common_param.query_cache_size_ > 0) {
+        this->query_cache_ =
+            std::make_shared<QueryResultCache>(common_param.query_cache_size_,
+                                               common_param.extra_info_size_,
+                                               allocator_);
+    }
+}
+
+DatasetPtr
+InnerIndexInterface::CachedKnnSearch(const DatasetPtr& query,
+                                     int64_t k,
+                                     const std::string& parameters,
+                                     const FilterPtr& filter) const {
+    QueryResultCache::Key key(allocator_);
+    if (this->query_cache_ == nullptr or
+        not this->query_cache_->MakeKey(query, k, parameters, filter, key)) {
+        return this->KnnSearch(query, k, parameters, filter);
+    }
+    auto epoch = this->query_cache_->Epoch();
+    auto result = this->query_cache_->Get(key);
+    if (result == nullptr) {
+        result = this->KnnSearch(query, k, parameters, filter);
+        this->query_cache_->Put(key, epoch, result);
+    }
+    return result;
+}
+
+DatasetPtr
+InnerIndexInterface::CachedKnnSearch(const DatasetPtr& query,
+                                     int64_t k,
+                                     const SearchParamPtr& param,
+                                     const FilterPtr& filter) const {
+    CHECK_ARGUMENT(param != nullptr, "search param is nullptr");
+    QueryResultCache::Key key(allocator_);
+    if (this->query_cache_ == nullptr or
+        not this->query_cache_->MakeKey(query, k, param->GetParameters(), filter, key)) {
+        return this->KnnSearch(query, k, param, filter);
+    }
+    auto epoch = this->query_cache_->Epoch();
+    auto result = this->query_cache_->Get(key);
+    if (result == nullptr) {
+        result = this->KnnSearch(query, k, param, filter);
+        this->query_cache_->Put(key, epoch, result);
+    }
+    return result;
 }
 
 std::vector<int64_t>
@@ -36,6 +82,20 @@ InnerIndexInterface::Build(const DatasetPtr& base) {
     return this->Add(base);
 }
 
+std::vector<int64_t>
+InnerIndexInterface::AddStream(const DatasetStream& next_chunk) {
+    CHECK_ARGUMENT(next_chunk != nullptr, "next_chunk is nullptr");
+    std::vector<int64_t> failed_ids;
+    DatasetPtr chunk = nullptr;
+    // the previous chunk is released before the next one is pulled
+    while ((chunk = next_chunk()) != nullptr) {
+        auto chunk_failed_ids = this->Add(chunk);
+        failed_ids.insert(failed_ids.end(), chunk_failed_ids.begin(), chunk_failed_ids.end());
+        chunk.reset();
+    }
+    return failed_ids;
+}
+
 DatasetPtr
 InnerIndexInterface::KnnSearch(const DatasetPtr& query,
                                int64_t k,
@@ -86,6 +146,68 @@ InnerIndexInterface::RangeSearch(const DatasetPtr& query,
     return this->RangeSearch(query, radius, parameters, filter_ptr, limited_size);
 }
 
+DatasetPtr
+InnerIndexInterface::KnnSearch(const DatasetPtr& query,
+                               int64_t k,
+                               const SearchParamPtr& param,
+                               const std::function<bool(int64_t)>& filter) const {
+    FilterPtr filter_ptr = nullptr;
+    if (filter != nullptr) {
+        filter_ptr = std::make_shared<UniqueFilter>(filter);
+    }
+    return this->KnnSearch(query, k, param, filter_ptr);
+}
+
+DatasetPtr
+InnerIndexInterface::KnnSearch(const DatasetPtr& query,
+                               int64_t k,
+                               const SearchParamPtr& param,
+                               const BitsetPtr& invalid) const {
+    FilterPtr filter_ptr = nullptr;
+    if (invalid != nullptr) {
+        filter_ptr = std::make_shared<UniqueFilter>(invalid);
+    }
+    return this->KnnSearch(query, k, param, filter_ptr);
+}
+
+DatasetPtr
+InnerIndexInterface::RangeSearch(const DatasetPtr& query,
+                                 float radius,
+                                 const SearchParamPtr& param,
+                                 const BitsetPtr& invalid,
+                                 int64_t limited_size) const {
+    FilterPtr filter_ptr = nullptr;
+    if (invalid != nullptr) {
+        filter_ptr = std::make_shared<UniqueFilter>(invalid);
+    }
+    return this->RangeSearch(query, radius, param, filter_ptr, limited_size);
+}
+
+DatasetPtr
+InnerIndexInterface::RangeSearch(const DatasetPtr& query,
+                                 float radius,
+                                 const SearchParamPtr& param,
+                                 const std::function<bool(int64_t)>& filter,
+                                 int64_t limited_size) const {
+    FilterPtr filter_ptr = nullptr;
+    if (filter != nullptr) {
+        filter_ptr = std::make_shared<UniqueFilter>(filter);
+    }
+    return this->RangeSearch(query, radius, param, filter_ptr, limited_size);
+}
+
+FilterPtr
+InnerIndexInterface::make_inner_id_filter(const FilterPtr& filter, InnerIdType total_count) const {
+    if (filter == nullptr) {
+        return nullptr;
+    }
+    auto bitmap = this->bitmap_cache_->Get(filter, *this->label_table_, total_count);
+    if (bitmap != nullptr) {
+        return bitmap;
+    }
+    return std::make_shared<CommonInnerIdFilter>(filter, *this->label_table_);
+}
+
 BinarySet
 InnerIndexInterface::Serialize() const {
     if (GetNumElements() == 0) {
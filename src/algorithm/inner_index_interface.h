@@ -18,6 +18,8 @@
 #include <vector>
 
 #include "dataset_impl.h"
+#include "impl/inner_id_bitmap_filter.h"
+#include "impl/query_result_cache.h"
 #include "index/index_common_param.h"
 #include "index_feature_list.h"
 #include "label_table.h"
@@ -48,6 +50,10 @@ public:
     virtual std::vector<int64_t>
     Add(const DatasetPtr& base) = 0;
 
+    // adds the chunks one after another, every Add is parallel inside the chunk already
+    virtual std::vector<int64_t>
+    AddStream(const DatasetStream& next_chunk);
+
     [[nodiscard]] virtual DatasetPtr
     KnnSearch(const DatasetPtr& query,
               int64_t k,
@@ -122,6 +128,75 @@ public:
         return this->RangeSearch(query, radius, parameters, filter, limited_size);
     }
 
+    [[nodiscard]] virtual SearchCursorPtr
+    OpenSearchCursor(const DatasetPtr& query,
+                     const std::string& parameters,
+                     const FilterPtr& filter) const {
+        throw std::runtime_error("Index doesn't support OpenSearchCursor");
+    }
+
+    /**
+     * @brief parse the search parameters once, the default handle only keeps the json string
+     */
+    [[nodiscard]] virtual SearchParamPtr
+    CompileSearchParam(const std::string& parameters) const {
+        return std::make_shared<SearchParam>(parameters);
+    }
+
+    [[nodiscard]] virtual DatasetPtr
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const FilterPtr& filter) const {
+        CHECK_ARGUMENT(param != nullptr, "search param is nullptr");
+        return this->KnnSearch(query, k, param->GetParameters(), filter);
+    }
+
+    [[nodiscard]] virtual DatasetPtr
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const BitsetPtr& invalid) const;
+
+    [[nodiscard]] virtual DatasetPtr
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const std::function<bool(int64_t)>& filter) const;
+
+    [[nodiscard]] virtual DatasetPtr
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const FilterPtr& filter,
+                int64_t limited_size = -1) const {
+        CHECK_ARGUMENT(param != nullptr, "search param is nullptr");
+        return this->RangeSearch(query, radius, param->GetParameters(), filter, limited_size);
+    }
+
+    [[nodiscard]] virtual DatasetPtr
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const BitsetPtr& invalid,
+                int64_t limited_size = -1) const;
+
+    [[nodiscard]] virtual DatasetPtr
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const std::function<bool(int64_t)>& filter,
+                int64_t limited_size = -1) const;
+
+    [[nodiscard]] virtual DatasetPtr
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                int64_t limited_size = -1) const {
+        FilterPtr filter = nullptr;
+        return this->RangeSearch(query, radius, param, filter, limited_size);
+    }
+
     virtual Index::Checkpoint
     ContinueBuild(const DatasetPtr& base, const BinarySet& binary_set) {
         throw std::runtime_error("Index doesn't support ContinueBuild");
@@ -155,6 +230,14 @@ public:
         throw std::runtime_error("Index doesn't support Feedback");
     }
 
+    virtual uint32_t
+    BatchFeedback(const DatasetPtr& queries,
+                  int64_t k,
+                  const std::string& parameters,
+                  const std::vector<int64_t>& global_optimum_tag_ids) {
+        throw std::runtime_error("Index doesn't support BatchFeedback");
+    }
+
     virtual float
     CalcDistanceById(const float* query, int64_t id) const {
         throw std::runtime_error("Index doesn't support calculate distance by id");
@@ -237,6 +320,30 @@ public:
         return this->label_table_->CheckLabel(id);
     }
 
+    /**
+     * @brief a knn search answered by the query result cache when the index has one
+     */
+    [[nodiscard]] DatasetPtr
+    CachedKnnSearch(const DatasetPtr& query,
+                    int64_t k,
+                    const std::string& parameters,
+                    const FilterPtr& filter) const;
+
+    [[nodiscard]] DatasetPtr
+    CachedKnnSearch(const DatasetPtr& query,
+                    int64_t k,
+                    const SearchParamPtr& param,
+                    const FilterPtr& filter) const;
+
+protected:
+    /**
+     * @brief wrap a label-space filter into an inner-id filter; a bitset filter is
+     * translated once into a cached inner-id bitmap instead of looking up the label
+     * of every candidate
+     */
+    [[nodiscard]] FilterPtr
+    make_inner_id_filter(const FilterPtr& filter, InnerIdType total_count) const;
+
 public:
     LabelTablePtr label_table_{nullptr};
 
@@ -244,7 +351,12 @@ public:
 
     IndexFeatureListPtr index_feature_list_{nullptr};
 
-    mutable std::shared_mutex label_lookup_mutex_{};  // lock for label_lookup_ & labels_
+    InnerIdBitmapCachePtr bitmap_cache_{nullptr};
+
+    // nullptr unless the index is created with a query_cache_size
+    QueryResultCachePtr query_cache_{nullptr};
+
+    mutable std::shared_mutex label_lookup_mutex_{};  // serializes the label writers
 
     const ParamPtr create_param_ptr_{nullptr};
 
@@ -16,9 +16,10 @@
 #include "ivf.h"
 
 #include "impl/basic_searcher.h"
+#include "impl/compiled_search_param.h"
+#include "impl/reorder.h"
 #include "inner_string_params.h"
 #include "ivf_partition/ivf_nearest_partition.h"
-#include "utils/standard_heap.h"
 #include "utils/util_functions.h"
 
 namespace vsag {
@@ -192,15 +193,43 @@ IVF::Add(const DatasetPtr& base) {
 
 DatasetPtr
 IVF::KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const std::string& parameters,
+              const FilterPtr& filter) const {
+    auto params = IVFSearchParameters::FromJson(parameters);
+    return this->knn_search(query, k, params, filter);
+}
+
+SearchParamPtr
+IVF::CompileSearchParam(const std::string& parameters) const {
+    return CompiledSearchParam<IVFSearchParameters>::Compile(parameters);
+}
+
+DatasetPtr
+IVF::KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const FilterPtr& filter) const {
+    auto params = CompiledSearchParam<IVFSearchParameters>::Resolve(param);
+    return this->knn_search(query, k, params, filter);
+}
+
+DatasetPtr
+IVF::knn_search(const DatasetPtr& query,
                int64_t k,
-               const std::string& parameters,
+               const IVFSearchParameters& params,
                const FilterPtr& filter) const {
-    auto param = this->create_search_param(parameters, filter);
+    auto param = this->create_search_param(params, filter);
     param.search_mode = KNN_SEARCH;
     param.topk = k;
     if (use_reorder_) {
         param.topk = static_cast<int64_t>(param.factor * static_cast<float>(k));
     }
+    auto plan = this->plan_search(param);
+    this->search_plan_stats_.Record(plan);
+    if (plan == SearchPlan::EXACT_SCAN) {
+        param.scan_bucket_size = bucket_->bucket_count_;
+    }
     auto search_result = this->search<KNN_SEARCH>(query, param);
     if (use_reorder_) {
         return reorder(k, search_result, query->GetFloat32Vectors());
@@ -217,11 +246,31 @@ IVF::KnnSearch(const DatasetPtr& query,
 
 DatasetPtr
 IVF::RangeSearch(const DatasetPtr& query,
+                float radius,
+                const std::string& parameters,
+                const FilterPtr& filter,
+                int64_t limited_size) const {
+    auto params = IVFSearchParameters::FromJson(parameters);
+    return this->range_search(query, radius, params, filter, limited_size);
+}
+
+DatasetPtr
+IVF::RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const FilterPtr& filter,
+                int64_t limited_size) const {
+    auto params = CompiledSearchParam<IVFSearchParameters>::Resolve(param);
+    return this->range_search(query, radius, params, filter, limited_size);
+}
+
+DatasetPtr
+IVF::range_search(const DatasetPtr& query,
                  float radius,
-                 const std::string& parameters,
+                 const IVFSearchParameters& params,
                  const FilterPtr& filter,
                  int64_t limited_size) const {
-    auto param = this->create_search_param(parameters, filter);
+    auto param = this->create_search_param(params, filter);
     param.search_mode = RANGE_SEARCH;
     param.radius = radius;
     param.range_search_limit_size = static_cast<int>(limited_size);
@@ -273,36 +322,58 @@ IVF::Deserialize(StreamReader& reader) {
     }
 }
 InnerSearchParam
-IVF::create_search_param(const std::string& parameters, const FilterPtr& filter) const {
+IVF::create_search_param(const IVFSearchParameters& search_param, const FilterPtr& filter) const {
     InnerSearchParam param;
-    std::shared_ptr<CommonInnerIdFilter> ft = nullptr;
-    if (filter != nullptr) {
-        ft = std::make_shared<CommonInnerIdFilter>(filter, *this->label_table_);
-    }
-    param.is_inner_id_allowed = ft;
-    auto search_param = IVFSearchParameters::FromJson(parameters);
+    param.is_inner_id_allowed =
+        this->make_inner_id_filter(filter, static_cast<InnerIdType>(total_elements_));
     param.scan_bucket_size = std::min(static_cast<BucketIdType>(search_param.scan_buckets_count),
                                       bucket_->bucket_count_);
     param.factor = search_param.topk_factor;
     return std::move(param);
 }
 
+SearchPlan
+IVF::plan_search(const InnerSearchParam& param) const {
+    const auto& ft = param.is_inner_id_allowed;
+    if (ft == nullptr or bucket_->bucket_count_ == 0) {
+        return SearchPlan::GRAPH_SEARCH;
+    }
+    auto valid_ratio = SearchPlanner::EstimateValidRatio(ft);
+    auto total = static_cast<uint64_t>(total_elements_);
+    // the probed buckets hold about scan_bucket_size / bucket_count of the vectors; when they are
+    //  not expected to contain topk valid ones, only scanning every bucket gives a full result
+    auto scanned = static_cast<double>(total) * static_cast<double>(param.scan_bucket_size) /
+                   static_cast<double>(bucket_->bucket_count_);
+    auto exact_cost = SearchPlanner::ExactScanCost(ft, valid_ratio, total);
+    auto approximate_cost = scanned;
+    if (scanned * static_cast<double>(valid_ratio) < static_cast<double>(param.topk)) {
+        approximate_cost = std::numeric_limits<double>::max();
+    }
+    return SearchPlanner::Plan(ft, valid_ratio, approximate_cost, exact_cost, false);
+}
+
+std::string
+IVF::GetStats() const {
+    JsonType stats;
+    stats[STATSTIC_DATA_NUM] = this->GetNumElements();
+    stats[STATSTIC_INDEX_NAME] = this->GetName();
+    this->search_plan_stats_.ToJson(stats);
+    if (this->query_cache_ != nullptr) {
+        this->query_cache_->ToJson(stats);
+    }
+    return stats.dump();
+}
+
 DatasetPtr
 IVF::reorder(int64_t topk, MaxHeap& input, const float* query) const {
-    auto [dataset_results, dists, labels] = CreateFastDataset(topk, allocator_);
-    StandardHeap<true, true> reorder_heap(allocator_, topk);
-    auto computer = this->reorder_codes_->FactoryComputer(query);
-    while (not input.empty()) {
-        auto [dist, id] = input.top();
-        this->reorder_codes_->Query(&dist, computer, &id, 1);
-        reorder_heap.Push(dist, id);
+    reorder_candidates(query, this->reorder_codes_, input, topk, allocator_);
+    auto count = static_cast<const int64_t>(input.size());
+    auto [dataset_results, dists, labels] = CreateFastDataset(count, allocator_);
+    for (int64_t j = count - 1; j >= 0; --j) {
+        dists[j] = input.top().first;
+        labels[j] = label_table_->GetLabelById(input.top().second);
         input.pop();
     }
-    for (int64_t j = topk - 1; j >= 0; --j) {
-        dists[j] = reorder_heap.Top().first;
-        labels[j] = label_table_->GetLabelById(reorder_heap.Top().second);
-        reorder_heap.Pop();
-    }
     return std::move(dataset_results);
 }
 
@@ -334,6 +405,7 @@ IVF::search(const DatasetPtr& query, const InnerSearchParam& param) const {
         }
     }
     const auto& ft = param.is_inner_id_allowed;
+    const auto* bitmap = dynamic_cast<const InnerIdBitmapFilter*>(ft.get());
     for (auto& bucket_id : candidate_buckets) {
         auto bucket_size = bucket_->GetBucketSize(bucket_id);
         const auto* ids = bucket_->GetInnerIds(bucket_id);
@@ -342,7 +414,8 @@ IVF::search(const DatasetPtr& query, const InnerSearchParam& param) const {
         }
         bucket_->ScanBucketById(dist.data(), computer, bucket_id);
         for (int j = 0; j < bucket_size; ++j) {
-            if (ft == nullptr or ft->CheckValid(ids[j])) {
+            if (ft == nullptr or
+                (bitmap != nullptr ? bitmap->Test(ids[j]) : ft->CheckValid(ids[j]))) {
                 if constexpr (mode == KNN_SEARCH) {
                     if (search_result.size() < topk or dist[j] < cur_heap_top) {
                         search_result.emplace(dist[j], ids[j]);
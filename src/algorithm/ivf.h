@@ -18,6 +18,7 @@
 #include "data_cell/bucket_datacell.h"
 #include "data_cell/flatten_interface.h"
 #include "impl/basic_searcher.h"
+#include "impl/search_planner.h"
 #include "index/index_common_param.h"
 #include "inner_index_interface.h"
 #include "ivf_parameter.h"
@@ -80,6 +81,22 @@ public:
                 const FilterPtr& filter,
                 int64_t limited_size = -1) const override;
 
+    [[nodiscard]] SearchParamPtr
+    CompileSearchParam(const std::string& parameters) const override;
+
+    DatasetPtr
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const FilterPtr& filter) const override;
+
+    DatasetPtr
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const FilterPtr& filter,
+                int64_t limited_size = -1) const override;
+
     void
     Serialize(StreamWriter& writer) const override;
 
@@ -89,9 +106,28 @@ public:
     int64_t
     GetNumElements() const override;
 
+    [[nodiscard]] std::string
+    GetStats() const override;
+
 private:
+    DatasetPtr
+    knn_search(const DatasetPtr& query,
+               int64_t k,
+               const IVFSearchParameters& params,
+               const FilterPtr& filter) const;
+
+    DatasetPtr
+    range_search(const DatasetPtr& query,
+                 float radius,
+                 const IVFSearchParameters& params,
+                 const FilterPtr& filter,
+                 int64_t limited_size) const;
+
     InnerSearchParam
-    create_search_param(const std::string& parameters, const FilterPtr& filter) const;
+    create_search_param(const IVFSearchParameters& search_param, const FilterPtr& filter) const;
+
+    SearchPlan
+    plan_search(const InnerSearchParam& param) const;
 
     template <InnerSearchMode mode = KNN_SEARCH>
     MaxHeap
@@ -110,5 +146,7 @@ private:
     bool use_reorder_{false};
 
     FlattenInterfacePtr reorder_codes_{nullptr};
+
+    mutable SearchPlanStats search_plan_stats_;
 };
 }  // namespace vsag
@@ -75,14 +75,15 @@ IVFNearestPartition::ClassifyDatas(const void* datas,
                                    int64_t count,
                                    BucketIdType buckets_per_data) {
     Vector<BucketIdType> result(buckets_per_data * count, this->allocator_);
+    // compiled once, the route index does not parse the parameters of every vector
+    auto search_param = this->route_index_ptr_->CompileSearchParam(fmt::format(
+        SEARCH_PARAM_TEMPLATE_STR, std::max(10L, static_cast<int64_t>(buckets_per_data * 1.2))));
     for (int64_t i = 0; i < count; ++i) {
         auto query = Dataset::Make();
         query->Dim(this->dim_)
             ->Float32Vectors(reinterpret_cast<const float*>(datas) + i * this->dim_)
             ->NumElements(1)
             ->Owner(false);
-        auto search_param = fmt::format(
-            SEARCH_PARAM_TEMPLATE_STR, std::max(10L, static_cast<int64_t>(buckets_per_data * 1.2)));
         FilterPtr filter = nullptr;
         auto search_result =
             this->route_index_ptr_->KnnSearch(query, buckets_per_data, search_param, filter);
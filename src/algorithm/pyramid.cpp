@@ -17,6 +17,7 @@
 
 #include "data_cell/flatten_interface.h"
 #include "empty_index_binary_set.h"
+#include "impl/compiled_search_param.h"
 #include "impl/odescent_graph_builder.h"
 #include "impl/pruning_strategy.h"
 #include "io/memory_io_parameter.h"
@@ -199,12 +200,34 @@ Pyramid::Build(const DatasetPtr& base) {
 
 DatasetPtr
 Pyramid::KnnSearch(const DatasetPtr& query,
+                  int64_t k,
+                  const std::string& parameters,
+                  const FilterPtr& filter) const {
+    auto params = PyramidSearchParameters::FromJson(parameters);
+    return this->knn_search(query, k, params, filter);
+}
+
+SearchParamPtr
+Pyramid::CompileSearchParam(const std::string& parameters) const {
+    return CompiledSearchParam<PyramidSearchParameters>::Compile(parameters);
+}
+
+DatasetPtr
+Pyramid::KnnSearch(const DatasetPtr& query,
+                  int64_t k,
+                  const SearchParamPtr& param,
+                  const FilterPtr& filter) const {
+    auto params = CompiledSearchParam<PyramidSearchParameters>::Resolve(param);
+    return this->knn_search(query, k, params, filter);
+}
+
+DatasetPtr
+Pyramid::knn_search(const DatasetPtr& query,
                    int64_t k,
-                   const std::string& parameters,
+                   const PyramidSearchParameters& params,
                    const FilterPtr& filter) const {
-    auto parsed_param = PyramidSearchParameters::FromJson(parameters);
     InnerSearchParam search_param;
-    search_param.ef = parsed_param.ef_search;
+    search_param.ef = params.ef_search;
     search_param.topk = k;
     search_param.search_mode = KNN_SEARCH;
     if (filter != nullptr) {
@@ -225,13 +248,32 @@ Pyramid::KnnSearch(const DatasetPtr& query,
 
 DatasetPtr
 Pyramid::RangeSearch(const DatasetPtr& query,
+                    float radius,
+                    const std::string& parameters,
+                    const FilterPtr& filter,
+                    int64_t limited_size) const {
+    auto params = PyramidSearchParameters::FromJson(parameters);
+    return this->range_search(query, radius, params, filter, limited_size);
+}
+
+DatasetPtr
+Pyramid::RangeSearch(const DatasetPtr& query,
+                    float radius,
+                    const SearchParamPtr& param,
+                    const FilterPtr& filter,
+                    int64_t limited_size) const {
+    auto params = CompiledSearchParam<PyramidSearchParameters>::Resolve(param);
+    return this->range_search(query, radius, params, filter, limited_size);
+}
+
+DatasetPtr
+Pyramid::range_search(const DatasetPtr& query,
                      float radius,
-                     const std::string& parameters,
+                     const PyramidSearchParameters& params,
                      const FilterPtr& filter,
                      int64_t limited_size) const {
-    auto parsed_param = PyramidSearchParameters::FromJson(parameters);
     InnerSearchParam search_param;
-    search_param.ef = parsed_param.ef_search;
+    search_param.ef = params.ef_search;
     search_param.radius = radius;
     search_param.search_mode = RANGE_SEARCH;
     if (filter != nullptr) {
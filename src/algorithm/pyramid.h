@@ -124,6 +124,23 @@ public:
                 const std::string& parameters,
                 const FilterPtr& filter,
                 int64_t limited_size = -1) const override;
+
+    [[nodiscard]] SearchParamPtr
+    CompileSearchParam(const std::string& parameters) const override;
+
+    DatasetPtr
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const FilterPtr& filter) const override;
+
+    DatasetPtr
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const FilterPtr& filter,
+                int64_t limited_size = -1) const override;
+
     void
     Serialize(StreamWriter& writer) const override;
 
@@ -140,6 +157,19 @@ public:
     InitFeatures() override;
 
 private:
+    DatasetPtr
+    knn_search(const DatasetPtr& query,
+               int64_t k,
+               const PyramidSearchParameters& params,
+               const FilterPtr& filter) const;
+
+    DatasetPtr
+    range_search(const DatasetPtr& query,
+                 float radius,
+                 const PyramidSearchParameters& params,
+                 const FilterPtr& filter,
+                 int64_t limited_size) const;
+
     void
     resize(int64_t new_max_capacity);
 
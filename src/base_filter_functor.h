@@ -20,6 +20,7 @@
 #include "bitset_impl.h"
 #include "common.h"
 #include "data_cell/extra_info_interface.h"
+#include "impl/tombstone_table.h"
 #include "label_table.h"
 #include "typing.h"
 #include "vsag/filter.h"
@@ -43,6 +44,22 @@ public:
         }
     }
 
+    [[nodiscard]] BitsetPtr
+    InvalidBitset() const override {
+        return bitset_;
+    }
+
+    [[nodiscard]] BitsetSpace
+    InvalidBitsetSpace() const override {
+        return is_bitset_filter_ ? BitsetSpace::LABEL : BitsetSpace::NONE;
+    }
+
+    // the caller may change the bitset between searches without telling
+    [[nodiscard]] uint64_t
+    Version() const override {
+        return UNSTABLE_VERSION;
+    }
+
 private:
     std::function<bool(int64_t)> fallback_func_{nullptr};
     const BitsetPtr bitset_{nullptr};
@@ -74,6 +91,32 @@ private:
     const LabelTable& label_table_;
 };
 
+// hides deleted inner ids, in front of an optional inner id filter
+class TombstoneFilter : public Filter {
+public:
+    TombstoneFilter(const FilterPtr filter_impl, TombstoneTablePtr tombstones, float live_ratio)
+        : filter_impl_(filter_impl), tombstones_(std::move(tombstones)), live_ratio_(live_ratio){};
+
+    [[nodiscard]] bool
+    CheckValid(int64_t inner_id) const override {
+        return tombstones_->IsLive(static_cast<InnerIdType>(inner_id)) and
+               (filter_impl_ == nullptr or filter_impl_->CheckValid(inner_id));
+    }
+
+    [[nodiscard]] float
+    ValidRatio() const override {
+        if (filter_impl_ == nullptr) {
+            return live_ratio_;
+        }
+        return filter_impl_->ValidRatio() * live_ratio_;
+    }
+
+private:
+    const FilterPtr filter_impl_;
+    const TombstoneTablePtr tombstones_;
+    const float live_ratio_{1.0F};
+};
+
 class CommonExtraInfoFilter : public Filter {
 public:
     CommonExtraInfoFilter(const FilterPtr filter_impl, const ExtraInfoInterfacePtr& extra_infos)
@@ -58,6 +58,7 @@ const char* const BLANK_INDEX = "blank_index";
 const char* const PARAMETER_DTYPE = "dtype";
 const char* const PARAMETER_DIM = "dim";
 const char* const PARAMETER_METRIC_TYPE = "metric_type";
+const char* const PARAMETER_QUERY_CACHE_SIZE = "query_cache_size";
 const char* const PARAMETER_USE_CONJUGATE_GRAPH = "use_conjugate_graph";
 const char* const PARAMETER_USE_CONJUGATE_GRAPH_SEARCH = "use_conjugate_graph_search";
 
@@ -76,6 +77,8 @@ const char* const DISKANN_PARAMETER_IO_LIMIT = "io_limit";
 const char* const DISKANN_PARAMETER_EF_SEARCH = "ef_search";
 const char* const DISKANN_PARAMETER_REORDER = "use_reorder";
 const char* const DISKANN_PARAMETER_GRAPH_TYPE = "graph_type";
+const char* const DISKANN_PARAMETER_LAYOUT_PATH = "layout_path";
+const char* const DISKANN_PARAMETER_BUILD_MEMORY_BUDGET = "build_memory_budget_gb";
 const char* const ODESCENT_PARAMETER_ALPHA = "alpha";
 const char* const ODESCENT_PARAMETER_GRAPH_ITER_TURN = "graph_iter_turn";
 const char* const ODESCENT_PARAMETER_NEIGHBOR_SAMPLE_RATE = "neighbor_sample_rate";
@@ -113,6 +116,11 @@ const char* const STATSTIC_RANGE_IO = "range_io";
 const char* const STATSTIC_RANGE_HOP = "range_hop";
 const char* const STATSTIC_RANGE_CACHE_HIT = "range_cache_hit";
 const char* const STATSTIC_RANGE_IO_TIME = "range_io_time";
+const char* const STATSTIC_SEARCH_PLAN_GRAPH = "search_plan_graph";
+const char* const STATSTIC_SEARCH_PLAN_FILTERED_EXPANSION = "search_plan_filtered_expansion";
+const char* const STATSTIC_SEARCH_PLAN_EXACT_SCAN = "search_plan_exact_scan";
+const char* const STATSTIC_QUERY_CACHE_HIT = "query_cache_hit";
+const char* const STATSTIC_QUERY_CACHE_MISS = "query_cache_miss";
 
 //Error message
 const char* const MESSAGE_PARAMETER = "invalid parameter";
@@ -139,6 +147,10 @@ const char* const HGRAPH_PRECISE_FILE_PATH = "precise_file_path";
 const char* const HGRAPH_PARAMETER_EF_RUNTIME = "ef_search";
 const char* const HGRAPH_EXTRA_INFO_SIZE = "extra_info_size";
 const char* const HGRAPH_USE_EXTRA_INFO_FILTER = "use_extra_info_filter";
+const char* const HGRAPH_GRAPH_TYPE = "graph_type";
+const char* const HGRAPH_PARAMETER_TARGET_RECALL = "target_recall";
+const char* const HGRAPH_PARAMETER_ENTRY_POINT_COUNT = "entry_point_count";
+const char* const HGRAPH_PARAMETER_USE_FILTERED_EXPANSION = "use_filtered_expansion";
 
 const char* const BRUTE_FORCE_QUANTIZATION_TYPE = "quantization_type";
 const char* const BRUTE_FORCE_IO_TYPE = "io_type";
@@ -108,6 +108,21 @@ public:
         ptr->quantizer_->Deserialize(reader);
     }
 
+    [[nodiscard]] bool
+    SameModel(const FlattenInterfacePtr& other) const override {
+        auto ptr = std::dynamic_pointer_cast<FlattenDataCell<QuantTmpl, IOTmpl>>(other);
+        if (ptr == nullptr) {
+            return false;
+        }
+        std::stringstream ss;
+        IOStreamWriter writer(ss);
+        this->quantizer_->Serialize(writer);
+        std::stringstream other_ss;
+        IOStreamWriter other_writer(other_ss);
+        ptr->quantizer_->Serialize(other_writer);
+        return ss.str() == other_ss.str();
+    }
+
     [[nodiscard]] std::string
     GetQuantizerName() override;
 
@@ -129,6 +144,25 @@ public:
     bool
     GetCodesById(InnerIdType id, uint8_t* codes) const override;
 
+    [[nodiscard]] bool
+    SupportPairCodes() const override {
+        return true;
+    }
+
+    bool
+    ComputePairCodes(const uint8_t* codes1,
+                     uint64_t count,
+                     const uint8_t* codes2,
+                     float* result_dists) override {
+        for (uint64_t i = 0; i < count; ++i) {
+            result_dists[i] = this->quantizer_->Compute(codes1 + i * code_size_, codes2);
+        }
+        return true;
+    }
+
+    bool
+    InsertCodes(const uint8_t* codes, InnerIdType idx) override;
+
     void
     Serialize(StreamWriter& writer) override;
 
@@ -258,6 +292,23 @@ FlattenDataCell<QuantTmpl, IOTmpl>::InsertVector(const void* vector, InnerIdType
     }
 }
 
+template <typename QuantTmpl, typename IOTmpl>
+bool
+FlattenDataCell<QuantTmpl, IOTmpl>::InsertCodes(const uint8_t* codes, InnerIdType idx) {
+    {
+        std::lock_guard lock(mutex_);
+        total_count_ = std::max(total_count_, idx + 1);
+    }
+    if (this->force_in_memory_) {
+        force_in_memory_io_->Write(
+            codes, code_size_, static_cast<uint64_t>(idx) * static_cast<uint64_t>(code_size_));
+    } else {
+        io_->Write(
+            codes, code_size_, static_cast<uint64_t>(idx) * static_cast<uint64_t>(code_size_));
+    }
+    return true;
+}
+
 template <typename QuantTmpl, typename IOTmpl>
 void
 FlattenDataCell<QuantTmpl, IOTmpl>::BatchInsertVector(const void* vectors,
@@ -330,7 +381,7 @@ FlattenDataCell<QuantTmpl, IOTmpl>::query(float* result_dists,
         Vector<uint64_t> sizes(id_count, this->code_size_, allocator_);
         Vector<uint64_t> offsets(id_count, this->code_size_, allocator_);
         for (int64_t i = 0; i < id_count; ++i) {
-            offsets[i] = idx[i] * code_size_;
+            offsets[i] = static_cast<uint64_t>(idx[i]) * static_cast<uint64_t>(code_size_);
         }
         this->io_->MultiRead(codes.data, sizes.data(), offsets.data(), id_count);
         computer->ComputeBatchDists(id_count, codes.data, result_dists);
@@ -74,6 +74,13 @@ public:
     virtual void
     ExportModel(const FlattenInterfacePtr& other) const = 0;
 
+    // whether other encodes with the same quantizer trained into the same model, so that codes
+    // can be copied between the two without decoding
+    [[nodiscard]] virtual bool
+    SameModel(const FlattenInterfacePtr& other) const {
+        return false;
+    }
+
 public:
     virtual void
     SetMaxCapacity(InnerIdType capacity) {
@@ -90,6 +97,28 @@ public:
         return false;
     }
 
+    // whether ComputePairCodes compares codes copied out by GetCodesById
+    [[nodiscard]] virtual bool
+    SupportPairCodes() const {
+        return false;
+    }
+
+    // distances between each of the count codes stored back to back in codes1 and codes2, for
+    // codes copied out by GetCodesById; returns false if the codes cannot be compared directly
+    virtual bool
+    ComputePairCodes(const uint8_t* codes1,
+                     uint64_t count,
+                     const uint8_t* codes2,
+                     float* result_dists) {
+        return false;
+    }
+
+    // write codes encoded by the same quantizer at idx, used to merge indexes without decoding
+    virtual bool
+    InsertCodes(const uint8_t* codes, InnerIdType idx) {
+        return false;
+    }
+
     [[nodiscard]] virtual InnerIdType
     TotalCount() const {
         return this->total_count_;
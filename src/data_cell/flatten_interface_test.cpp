@@ -69,6 +69,22 @@ FlattenInterfaceTest::BasicTest(int64_t dim, uint64_t base_count, float error) {
         }
         REQUIRE(std::abs(gt - value) < error);
     }
+
+    if (flatten_->SupportPairCodes()) {
+        uint64_t pair_count = std::min(base_count, static_cast<uint64_t>(16));
+        auto code_size = flatten_->code_size_;
+        std::vector<uint8_t> codes((pair_count + 1) * code_size);
+        for (uint64_t i = 0; i <= pair_count; ++i) {
+            REQUIRE(flatten_->GetCodesById(idx[i % base_count], codes.data() + i * code_size));
+        }
+        std::vector<float> pair_dists(pair_count);
+        REQUIRE(flatten_->ComputePairCodes(
+            codes.data(), pair_count, codes.data() + pair_count * code_size, pair_dists.data()));
+        for (uint64_t i = 0; i < pair_count; ++i) {
+            auto value = flatten_->ComputePairVectors(idx[i], idx[pair_count % base_count]);
+            REQUIRE(pair_dists[i] == value);
+        }
+    }
 }
 void
 FlattenInterfaceTest::TestSerializeAndDeserialize(int64_t dim,
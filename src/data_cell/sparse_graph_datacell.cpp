@@ -66,6 +66,15 @@ SparseGraphDataCell::GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_
     }
 }
 void
+SparseGraphDataCell::GetIds(Vector<InnerIdType>& ids) const {
+    std::shared_lock<std::shared_mutex> rlock(this->neighbors_map_mutex_);
+    ids.clear();
+    ids.reserve(this->neighbors_.size());
+    for (const auto& pair : this->neighbors_) {
+        ids.emplace_back(pair.first);
+    }
+}
+void
 SparseGraphDataCell::Serialize(StreamWriter& writer) {
     GraphInterface::Serialize(writer);
     StreamWriter::WriteObj(writer, this->code_line_size_);
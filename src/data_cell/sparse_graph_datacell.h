@@ -43,6 +43,10 @@ public:
     void
     Resize(InnerIdType new_size) override;
 
+    // the ids that hold a neighbor list, i.e. the members of a route graph
+    void
+    GetIds(Vector<InnerIdType>& ids) const;
+
     /****
      * prefetch neighbors of a base point with id
      * @param id of base point
@@ -30,6 +30,7 @@ BasicSearcher::visit(const GraphInterfacePtr& graph,
                      const VisitedListPtr& vl,
                      const std::pair<float, uint64_t>& current_node_pair,
                      const FilterPtr& filter,
+                     const InnerIdBitmapFilter* bitmap,
                      float skip_ratio,
                      Vector<InnerIdType>& to_be_visited_rid,
                      Vector<InnerIdType>& to_be_visited_id,
@@ -55,7 +56,8 @@ BasicSearcher::visit(const GraphInterfacePtr& graph,
         }
         if (not vl->Get(neighbors[i])) {
             if (not filter || count_no_visited == 0 || generator.NextFloat() > skip_threshold ||
-                filter->CheckValid(neighbors[i])) {
+                (bitmap != nullptr ? bitmap->Test(neighbors[i])
+                                   : filter->CheckValid(neighbors[i]))) {
                 to_be_visited_rid[count_no_visited] = i;
                 to_be_visited_id[count_no_visited] = neighbors[i];
                 count_no_visited++;
@@ -66,6 +68,57 @@ BasicSearcher::visit(const GraphInterfacePtr& graph,
     return count_no_visited;
 }
 
+uint32_t
+BasicSearcher::visit_two_hop(const GraphInterfacePtr& graph,
+                             const VisitedListPtr& vl,
+                             const std::pair<float, uint64_t>& current_node_pair,
+                             const FilterPtr& filter,
+                             const InnerIdBitmapFilter* bitmap,
+                             float skip_ratio,
+                             Vector<InnerIdType>& to_be_visited_id,
+                             Vector<InnerIdType>& neighbors,
+                             Vector<InnerIdType>& second_neighbors) const {
+    LinearCongruentialGenerator generator;
+    auto get_neighbors = [&](InnerIdType id, Vector<InnerIdType>& result) {
+        if (this->mutex_array_ != nullptr) {
+            SharedLock lock(this->mutex_array_, id);
+            graph->GetNeighbors(id, result);
+        } else {
+            graph->GetNeighbors(id, result);
+        }
+    };
+    auto check_valid = [&](InnerIdType id) -> bool {
+        return bitmap != nullptr ? bitmap->Test(id) : filter->CheckValid(id);
+    };
+
+    // the same threshold as visit, an invalid neighbor it would keep is kept here too
+    float skip_threshold =
+        filter->ValidRatio() == 1.0F ? 0 : (1 - ((1 - filter->ValidRatio()) * skip_ratio));
+
+    uint32_t count_no_visited = 0;
+    get_neighbors(current_node_pair.second, neighbors);
+    for (const auto& neighbor : neighbors) {
+        if (vl->Get(neighbor)) {
+            continue;
+        }
+        vl->Set(neighbor);
+        // the first neighbor is always kept so that the search can go on
+        if (count_no_visited == 0 or generator.NextFloat() > skip_threshold or
+            check_valid(neighbor)) {
+            to_be_visited_id[count_no_visited++] = neighbor;
+            continue;
+        }
+        get_neighbors(neighbor, second_neighbors);
+        for (const auto& second_neighbor : second_neighbors) {
+            if (not vl->Get(second_neighbor) and check_valid(second_neighbor)) {
+                vl->Set(second_neighbor);
+                to_be_visited_id[count_no_visited++] = second_neighbor;
+            }
+        }
+    }
+    return count_no_visited;
+}
+
 MaxHeap
 BasicSearcher::Search(const GraphInterfacePtr& graph,
                       const FlattenInterfacePtr& flatten,
@@ -75,7 +128,7 @@ BasicSearcher::Search(const GraphInterfacePtr& graph,
     if (inner_search_param.search_mode == KNN_SEARCH) {
         return this->search_impl<KNN_SEARCH>(graph, flatten, vl, query, inner_search_param);
     }
-    return this->search_impl<RANGE_SEARCH>(graph, flatten, vl, query, inner_search_param);
+    return this->range_search_impl(graph, flatten, vl, query, inner_search_param);
 }
 
 MaxHeap
@@ -106,6 +159,13 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
     auto computer = flatten->FactoryComputer(query);
 
     auto is_id_allowed = inner_search_param.is_inner_id_allowed;
+    const auto* bitmap = dynamic_cast<const InnerIdBitmapFilter*>(is_id_allowed.get());
+    auto check_valid = [&](InnerIdType inner_id) -> bool {
+        if (bitmap != nullptr) {
+            return bitmap->Test(inner_id);
+        }
+        return not is_id_allowed || is_id_allowed->CheckValid(inner_id);
+    };
     auto ep = inner_search_param.ep;
     auto ef = inner_search_param.ef;
 
@@ -144,7 +204,7 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
         }
     } else {
         flatten->Query(&dist, computer, &ep, 1);
-        if (not is_id_allowed || is_id_allowed->CheckValid(ep)) {
+        if (check_valid(ep)) {
             top_candidates.emplace(dist, ep);
             lower_bound = top_candidates.top().first;
         }
@@ -171,6 +231,7 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
                                  vl,
                                  current_node_pair,
                                  inner_search_param.is_inner_id_allowed,
+                                 bitmap,
                                  inner_search_param.skip_ratio,
                                  to_be_visited_rid,
                                  to_be_visited_id,
@@ -189,7 +250,7 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
                 }
                 candidate_set.emplace(-dist, to_be_visited_id[i]);
                 flatten->Prefetch(candidate_set.top().second);
-                if (not is_id_allowed || is_id_allowed->CheckValid(to_be_visited_id[i])) {
+                if (check_valid(to_be_visited_id[i])) {
                     top_candidates.emplace(dist, to_be_visited_id[i]);
                 }
 
@@ -240,6 +301,13 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
     auto computer = flatten->FactoryComputer(query);
 
     auto is_id_allowed = inner_search_param.is_inner_id_allowed;
+    const auto* bitmap = dynamic_cast<const InnerIdBitmapFilter*>(is_id_allowed.get());
+    auto check_valid = [&](InnerIdType inner_id) -> bool {
+        if (bitmap != nullptr) {
+            return bitmap->Test(inner_id);
+        }
+        return not is_id_allowed || is_id_allowed->CheckValid(inner_id);
+    };
     auto ep = inner_search_param.ep;
     auto ef = inner_search_param.ef;
 
@@ -249,15 +317,42 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
     uint32_t hops = 0;
     uint32_t dist_cmp = 0;
     uint32_t count_no_visited = 0;
+    bool use_expansion = inner_search_param.filtered_expansion and is_id_allowed != nullptr;
+    uint64_t visit_capacity = graph->MaximumDegree();
+    if (use_expansion) {
+        visit_capacity *= graph->MaximumDegree() + 1;
+    }
     Vector<InnerIdType> to_be_visited_rid(graph->MaximumDegree(), allocator_);
-    Vector<InnerIdType> to_be_visited_id(graph->MaximumDegree(), allocator_);
+    Vector<InnerIdType> to_be_visited_id(visit_capacity, allocator_);
     Vector<InnerIdType> neighbors(graph->MaximumDegree(), allocator_);
-    Vector<float> line_dists(graph->MaximumDegree(), allocator_);
+    Vector<InnerIdType> second_neighbors(allocator_);
+    Vector<float> line_dists(visit_capacity, allocator_);
+
+    // adaptive termination keeps the best early_stop_k results apart from the ef candidates
+    auto patience = inner_search_param.early_stop_patience;
+    auto early_stop_k =
+        static_cast<uint64_t>(std::max<int64_t>(inner_search_param.early_stop_k, 0));
+    bool use_early_stop = mode == KNN_SEARCH and patience > 0 and early_stop_k > 0;
+    MaxHeap best_k(allocator_);
+    uint64_t stall_count = 0;
+    bool improved = false;
+    auto update_best_k = [&](float cur_dist, InnerIdType inner_id) {
+        if (best_k.size() < early_stop_k or cur_dist < best_k.top().first) {
+            best_k.emplace(cur_dist, inner_id);
+            if (best_k.size() > early_stop_k) {
+                best_k.pop();
+            }
+            improved = true;
+        }
+    };
 
     flatten->Query(&dist, computer, &ep, 1);
-    if (not is_id_allowed || is_id_allowed->CheckValid(ep)) {
+    if (check_valid(ep)) {
         top_candidates.emplace(dist, ep);
         lower_bound = top_candidates.top().first;
+        if (use_early_stop) {
+            update_best_k(dist, ep);
+        }
     }
     if constexpr (mode == InnerSearchMode::RANGE_SEARCH) {
         if (dist > inner_search_param.radius and not top_candidates.empty()) {
@@ -267,6 +362,25 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
     candidate_set.emplace(-dist, ep);
     vl->Set(ep);
 
+    Vector<InnerIdType> seeds(allocator_);
+    Vector<float> seed_dists(allocator_);
+    auto seed_count =
+        this->seed_extra_eps(flatten, computer, vl, inner_search_param, seeds, seed_dists);
+    for (uint64_t i = 0; i < seed_count; ++i) {
+        candidate_set.emplace(-seed_dists[i], seeds[i]);
+        if (not check_valid(seeds[i])) {
+            continue;
+        }
+        top_candidates.emplace(seed_dists[i], seeds[i]);
+        if (top_candidates.size() > ef) {
+            top_candidates.pop();
+        }
+        lower_bound = top_candidates.top().first;
+        if (use_early_stop) {
+            update_best_k(seed_dists[i], seeds[i]);
+        }
+    }
+
     while (not candidate_set.empty()) {
         hops++;
         auto current_node_pair = candidate_set.top();
@@ -282,27 +396,44 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
             graph->Prefetch(candidate_set.top().second, 0);
         }
 
-        count_no_visited = visit(graph,
-                                 vl,
-                                 current_node_pair,
-                                 inner_search_param.is_inner_id_allowed,
-                                 inner_search_param.skip_ratio,
-                                 to_be_visited_rid,
-                                 to_be_visited_id,
-                                 neighbors);
+        if (use_expansion) {
+            count_no_visited = visit_two_hop(graph,
+                                             vl,
+                                             current_node_pair,
+                                             is_id_allowed,
+                                             bitmap,
+                                             inner_search_param.skip_ratio,
+                                             to_be_visited_id,
+                                             neighbors,
+                                             second_neighbors);
+        } else {
+            count_no_visited = visit(graph,
+                                     vl,
+                                     current_node_pair,
+                                     is_id_allowed,
+                                     bitmap,
+                                     inner_search_param.skip_ratio,
+                                     to_be_visited_rid,
+                                     to_be_visited_id,
+                                     neighbors);
+        }
 
         dist_cmp += count_no_visited;
 
         flatten->Query(line_dists.data(), computer, to_be_visited_id.data(), count_no_visited);
 
+        improved = false;
         for (uint32_t i = 0; i < count_no_visited; i++) {
             dist = line_dists[i];
             if (top_candidates.size() < ef || lower_bound > dist ||
                 (mode == RANGE_SEARCH && dist <= inner_search_param.radius)) {
                 candidate_set.emplace(-dist, to_be_visited_id[i]);
                 //                flatten->Prefetch(candidate_set.top().second);
-                if (not is_id_allowed || is_id_allowed->CheckValid(to_be_visited_id[i])) {
+                if (check_valid(to_be_visited_id[i])) {
                     top_candidates.emplace(dist, to_be_visited_id[i]);
+                    if (use_early_stop) {
+                        update_best_k(dist, to_be_visited_id[i]);
+                    }
                 }
 
                 if constexpr (mode == KNN_SEARCH) {
@@ -316,6 +447,13 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
                 }
             }
         }
+
+        if (use_early_stop) {
+            stall_count = improved ? 0 : stall_count + 1;
+            if (best_k.size() == early_stop_k and stall_count >= patience) {
+                break;
+            }
+        }
     }
 
     if constexpr (mode == KNN_SEARCH) {
@@ -337,4 +475,149 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
     return top_candidates;
 }
 
+uint64_t
+BasicSearcher::seed_extra_eps(const FlattenInterfacePtr& flatten,
+                              const ComputerInterfacePtr& computer,
+                              const VisitedListPtr& vl,
+                              const InnerSearchParam& inner_search_param,
+                              Vector<InnerIdType>& seeds,
+                              Vector<float>& dists) const {
+    seeds.clear();
+    if (inner_search_param.extra_eps == nullptr) {
+        return 0;
+    }
+    for (uint64_t i = 0; i < inner_search_param.extra_ep_count; ++i) {
+        auto seed = inner_search_param.extra_eps[i];
+        if (not vl->Get(seed)) {
+            vl->Set(seed);
+            seeds.emplace_back(seed);
+        }
+    }
+    dists.resize(seeds.size());
+    if (not seeds.empty()) {
+        flatten->Query(dists.data(), computer, seeds.data(), seeds.size());
+    }
+    return seeds.size();
+}
+
+MaxHeap
+BasicSearcher::range_search_impl(const GraphInterfacePtr& graph,
+                                 const FlattenInterfacePtr& flatten,
+                                 const VisitedListPtr& vl,
+                                 const float* query,
+                                 const InnerSearchParam& inner_search_param) const {
+    if (not graph or not flatten) {
+        return MaxHeap(allocator_);
+    }
+
+    auto computer = flatten->FactoryComputer(query);
+
+    auto is_id_allowed = inner_search_param.is_inner_id_allowed;
+    const auto* bitmap = dynamic_cast<const InnerIdBitmapFilter*>(is_id_allowed.get());
+    auto check_valid = [&](InnerIdType inner_id) -> bool {
+        if (bitmap != nullptr) {
+            return bitmap->Test(inner_id);
+        }
+        return not is_id_allowed || is_id_allowed->CheckValid(inner_id);
+    };
+    auto ep = inner_search_param.ep;
+    auto ef = inner_search_param.ef;
+    auto radius = inner_search_param.radius + THRESHOLD_ERROR;
+    auto expand_radius =
+        inner_search_param.radius * (1.0F + inner_search_param.range_slack) + THRESHOLD_ERROR;
+    uint64_t limited_size = 0;
+    if (inner_search_param.range_search_limit_size > 0) {
+        limited_size = static_cast<uint64_t>(inner_search_param.range_search_limit_size);
+    }
+
+    // the beam holds the ef closest nodes seen so far, valid or not, and only leads the
+    //  search towards the radius; it never becomes part of the result
+    MaxHeap beam(allocator_);
+    // results are streamed into a flat buffer, a heap is only kept to honor limited_size
+    Vector<std::pair<float, InnerIdType>> buffer(allocator_);
+    MaxHeap limited_results(allocator_);
+    MaxHeap candidate_set(allocator_);
+
+    auto emit = [&](float dist, InnerIdType inner_id) {
+        if (dist > radius or not check_valid(inner_id)) {
+            return;
+        }
+        if (limited_size == 0) {
+            buffer.emplace_back(dist, inner_id);
+        } else if (limited_results.size() < limited_size or dist < limited_results.top().first) {
+            limited_results.emplace(dist, inner_id);
+            if (limited_results.size() > limited_size) {
+                limited_results.pop();
+            }
+        }
+    };
+    auto push = [&](float dist, InnerIdType inner_id) {
+        candidate_set.emplace(-dist, inner_id);
+        beam.emplace(dist, inner_id);
+        if (beam.size() > ef) {
+            beam.pop();
+        }
+        emit(dist, inner_id);
+    };
+
+    uint32_t count_no_visited = 0;
+    Vector<InnerIdType> to_be_visited_rid(graph->MaximumDegree(), allocator_);
+    Vector<InnerIdType> to_be_visited_id(graph->MaximumDegree(), allocator_);
+    Vector<InnerIdType> neighbors(graph->MaximumDegree(), allocator_);
+    Vector<float> line_dists(graph->MaximumDegree(), allocator_);
+
+    float dist = 0.0F;
+    flatten->Query(&dist, computer, &ep, 1);
+    vl->Set(ep);
+    push(dist, ep);
+
+    Vector<InnerIdType> seeds(allocator_);
+    Vector<float> seed_dists(allocator_);
+    auto seed_count =
+        this->seed_extra_eps(flatten, computer, vl, inner_search_param, seeds, seed_dists);
+    for (uint64_t i = 0; i < seed_count; ++i) {
+        push(seed_dists[i], seeds[i]);
+    }
+
+    while (not candidate_set.empty()) {
+        auto current_node_pair = candidate_set.top();
+        auto current_dist = -current_node_pair.first;
+        // the frontier is ordered by distance, once its closest node is out of the
+        //  expansion radius and behind the beam, no other node can be expanded
+        if (current_dist > expand_radius and beam.size() == ef and
+            current_dist > beam.top().first) {
+            break;
+        }
+        candidate_set.pop();
+
+        if (not candidate_set.empty()) {
+            graph->Prefetch(candidate_set.top().second, 0);
+        }
+
+        count_no_visited = visit(graph,
+                                 vl,
+                                 current_node_pair,
+                                 is_id_allowed,
+                                 bitmap,
+                                 inner_search_param.skip_ratio,
+                                 to_be_visited_rid,
+                                 to_be_visited_id,
+                                 neighbors);
+
+        flatten->Query(line_dists.data(), computer, to_be_visited_id.data(), count_no_visited);
+
+        for (uint32_t i = 0; i < count_no_visited; i++) {
+            dist = line_dists[i];
+            if (dist <= expand_radius or beam.size() < ef or dist < beam.top().first) {
+                push(dist, to_be_visited_id[i]);
+            }
+        }
+    }
+
+    if (limited_size > 0) {
+        return limited_results;
+    }
+    return MaxHeap(CompareByFirst(), std::move(buffer));
+}
+
 }  // namespace vsag
@@ -19,6 +19,7 @@
 #include "common.h"
 #include "data_cell/flatten_interface.h"
 #include "data_cell/graph_interface.h"
+#include "impl/inner_id_bitmap_filter.h"
 #include "index/index_common_param.h"
 #include "index/iterator_filter.h"
 #include "lock_strategy.h"
@@ -28,16 +29,31 @@ namespace vsag {
 
 enum InnerSearchMode { KNN_SEARCH = 1, RANGE_SEARCH = 2 };
 
+constexpr float RANGE_SEARCH_SLACK = 0.1F;
+
 class InnerSearchParam {
 public:
     int64_t topk{0};
     float radius{0.0f};
     InnerIdType ep{0};
+    // more entry points seeded into the frontier together with ep, e.g. the top hits of a
+    //  wider search on the lowest route graph
+    const InnerIdType* extra_eps{nullptr};
+    uint64_t extra_ep_count{0};
     uint64_t ef{10};
     FilterPtr is_inner_id_allowed{nullptr};
     float skip_ratio{0.8F};
     InnerSearchMode search_mode{KNN_SEARCH};
     int range_search_limit_size{-1};
+    // range only: nodes within radius * (1 + range_slack) are expanded even when they are
+    //  out of the ef beam, so the traversal can walk across the border of the radius
+    float range_slack{RANGE_SEARCH_SLACK};
+    // look through filtered-out neighbors to their own neighbors (two-hop expansion)
+    bool filtered_expansion{false};
+    // knn only: stop once the best early_stop_k results have not changed for
+    //  early_stop_patience expansions, 0 searches until ef converges
+    uint64_t early_stop_patience{0};
+    int64_t early_stop_k{0};
 
     // for ivf
     int scan_bucket_size{1};
@@ -74,11 +90,25 @@ private:
           const VisitedListPtr& vl,
           const std::pair<float, uint64_t>& current_node_pair,
           const FilterPtr& filter,
+          const InnerIdBitmapFilter* bitmap,
           float skip_ratio,
           Vector<InnerIdType>& to_be_visited_rid,
           Vector<InnerIdType>& to_be_visited_id,
           Vector<InnerIdType>& neighbors) const;
 
+    // like visit, but a filtered-out neighbor that visit would skip is replaced by its valid
+    //  neighbors, so the buffers must hold MaximumDegree() * (MaximumDegree() + 1) ids
+    uint32_t
+    visit_two_hop(const GraphInterfacePtr& graph,
+                  const VisitedListPtr& vl,
+                  const std::pair<float, uint64_t>& current_node_pair,
+                  const FilterPtr& filter,
+                  const InnerIdBitmapFilter* bitmap,
+                  float skip_ratio,
+                  Vector<InnerIdType>& to_be_visited_id,
+                  Vector<InnerIdType>& neighbors,
+                  Vector<InnerIdType>& second_neighbors) const;
+
     template <InnerSearchMode mode = KNN_SEARCH>
     MaxHeap
     search_impl(const GraphInterfacePtr& graph,
@@ -96,6 +126,22 @@ private:
                 const InnerSearchParam& inner_search_param,
                 IteratorFilterContext* iter_ctx) const;
 
+    // mark the extra entry points visited and compute their distances, ep is left out
+    uint64_t
+    seed_extra_eps(const FlattenInterfacePtr& flatten,
+                   const ComputerInterfacePtr& computer,
+                   const VisitedListPtr& vl,
+                   const InnerSearchParam& inner_search_param,
+                   Vector<InnerIdType>& seeds,
+                   Vector<float>& dists) const;
+
+    MaxHeap
+    range_search_impl(const GraphInterfacePtr& graph,
+                      const FlattenInterfacePtr& flatten,
+                      const VisitedListPtr& vl,
+                      const float* query,
+                      const InnerSearchParam& inner_search_param) const;
+
 private:
     Allocator* allocator_{nullptr};
 
@@ -270,3 +270,169 @@ TEST_CASE("Search with HNSW", "[ut][BasicSearcher]") {
         }
     }
 }
+
+// an hnsw graph over base_vectors and the fp32 codes of the same vectors
+struct HNSWTestGraph {
+    std::shared_ptr<hnswlib::L2Space> space;
+    std::shared_ptr<hnswlib::HierarchicalNSW> alg_hnsw;
+    GraphInterfacePtr graph;
+    FlattenInterfacePtr flatten;
+};
+
+static HNSWTestGraph
+build_test_graph(const std::vector<float>& base_vectors,
+                 uint32_t base_size,
+                 const IndexCommonParam& common) {
+    HNSWTestGraph result;
+    auto* allocator = common.allocator_.get();
+    std::vector<InnerIdType> ids(base_size);
+    std::iota(ids.begin(), ids.end(), 0);
+
+    result.space = std::make_shared<hnswlib::L2Space>(common.dim_);
+    result.alg_hnsw = std::make_shared<hnswlib::HierarchicalNSW>(
+        result.space.get(), base_size, allocator, 16, 100, Options::Instance().block_size_limit());
+    result.alg_hnsw->init_memory_space();
+    for (int64_t i = 0; i < base_size; ++i) {
+        result.alg_hnsw->addPoint((const void*)(base_vectors.data() + i * common.dim_), ids[i]);
+    }
+    result.graph = std::make_shared<AdaptGraphDataCell>(result.alg_hnsw);
+
+    constexpr const char* param_temp = R"({{"type": "{}"}})";
+    auto fp32_param = QuantizerParameter::GetQuantizerParameterByJson(
+        JsonType::parse(fmt::format(param_temp, "fp32")));
+    auto io_param =
+        IOParameter::GetIOParameterByJson(JsonType::parse(fmt::format(param_temp, "memory_io")));
+    auto vector_data_cell = std::make_shared<
+        FlattenDataCell<FP32Quantizer<vsag::MetricType::METRIC_TYPE_L2SQR>, MemoryIO>>(
+        fp32_param, io_param, common);
+    vector_data_cell->SetQuantizer(
+        std::make_shared<FP32Quantizer<vsag::MetricType::METRIC_TYPE_L2SQR>>(common.dim_,
+                                                                             allocator));
+    vector_data_cell->SetIO(std::make_unique<MemoryIO>(allocator));
+    vector_data_cell->Train(base_vectors.data(), base_size);
+    vector_data_cell->BatchInsertVector(base_vectors.data(), base_size, ids.data());
+    result.flatten = vector_data_cell;
+    return result;
+}
+
+TEST_CASE("Range Search Beyond ef", "[ut][BasicSearcher]") {
+    uint32_t base_size = 1000;
+    uint64_t dim = 32;
+    uint32_t in_radius_count = 200;
+    uint32_t ef_search = 10;
+    InnerIdType fixed_entry_point_id = 0;
+
+    auto base_vectors = fixtures::generate_vectors(base_size, dim, true);
+    IndexCommonParam common;
+    common.dim_ = dim;
+    common.allocator_ = SafeAllocator::FactoryDefaultAllocator();
+    common.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    auto test_graph = build_test_graph(base_vectors, base_size, common);
+
+    auto* allocator = common.allocator_.get();
+    auto pool = std::make_shared<VisitedListPool>(1, allocator, base_size, allocator);
+    auto searcher = std::make_shared<BasicSearcher>(common);
+
+    for (uint32_t i = 0; i < 10; ++i) {
+        const float* query = base_vectors.data() + i * dim;
+        // the radius covers in_radius_count vectors, far more than ef
+        std::vector<float> dists(base_size);
+        for (uint32_t j = 0; j < base_size; ++j) {
+            dists[j] = 0;
+            for (uint64_t d = 0; d < dim; ++d) {
+                auto diff = query[d] - base_vectors[j * dim + d];
+                dists[j] += diff * diff;
+            }
+        }
+        auto sorted_dists = dists;
+        std::nth_element(
+            sorted_dists.begin(), sorted_dists.begin() + in_radius_count, sorted_dists.end());
+        float radius = sorted_dists[in_radius_count];
+
+        InnerSearchParam search_param;
+        search_param.ep = fixed_entry_point_id;
+        search_param.ef = ef_search;
+        search_param.radius = radius;
+        search_param.search_mode = RANGE_SEARCH;
+        auto vl = pool->TakeOne();
+        auto result =
+            searcher->Search(test_graph.graph, test_graph.flatten, vl, query, search_param);
+        pool->ReturnOne(vl);
+        auto hnsw_result = test_graph.alg_hnsw->searchBaseLayerST<false, false>(
+            fixed_entry_point_id, query, radius, ef_search, nullptr);
+
+        std::unordered_set<InnerIdType> result_set, hnsw_result_set;
+        while (not result.empty()) {
+            result_set.insert(result.top().second);
+            result.pop();
+        }
+        while (not hnsw_result.empty()) {
+            hnsw_result_set.insert(hnsw_result.top().second);
+            hnsw_result.pop();
+        }
+        REQUIRE(result_set.size() >= in_radius_count);
+        for (uint32_t j = 0; j < base_size; ++j) {
+            if (dists[j] <= radius) {
+                REQUIRE(result_set.count(j) == 1);
+                REQUIRE(hnsw_result_set.count(j) == 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("Search with Early Stop", "[ut][BasicSearcher]") {
+    uint32_t base_size = 1000;
+    uint32_t query_size = 20;
+    uint64_t dim = 32;
+    uint32_t ef_search = 400;
+    int64_t k = 10;
+
+    auto base_vectors = fixtures::generate_vectors(base_size, dim, true);
+    IndexCommonParam common;
+    common.dim_ = dim;
+    common.allocator_ = SafeAllocator::FactoryDefaultAllocator();
+    common.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    auto test_graph = build_test_graph(base_vectors, base_size, common);
+
+    auto* allocator = common.allocator_.get();
+    auto pool = std::make_shared<VisitedListPool>(1, allocator, base_size, allocator);
+    auto searcher = std::make_shared<BasicSearcher>(common);
+
+    InnerSearchParam search_param;
+    search_param.ep = 0;
+    search_param.ef = ef_search;
+    search_param.topk = k;
+    InnerSearchParam early_stop_param = search_param;
+    early_stop_param.early_stop_patience = 20;
+    early_stop_param.early_stop_k = k;
+
+    // every visited node costs one distance computation
+    auto search = [&](const float* query, const InnerSearchParam& param, uint64_t& visited) {
+        auto vl = pool->TakeOne();
+        auto result = searcher->Search(test_graph.graph, test_graph.flatten, vl, query, param);
+        for (InnerIdType id = 0; id < base_size; ++id) {
+            visited += static_cast<uint64_t>(vl->Get(id));
+        }
+        pool->ReturnOne(vl);
+        return result;
+    };
+
+    uint64_t full_visited = 0;
+    uint64_t early_stop_visited = 0;
+    for (uint32_t i = 0; i < query_size; ++i) {
+        const float* query = base_vectors.data() + i * dim;
+        auto full_result = search(query, search_param, full_visited);
+        auto early_stop_result = search(query, early_stop_param, early_stop_visited);
+        REQUIRE(full_result.size() == static_cast<uint64_t>(k));
+        REQUIRE(early_stop_result.size() == static_cast<uint64_t>(k));
+
+        // the query is a base vector, so both searches must still find it
+        bool found = false;
+        while (not early_stop_result.empty()) {
+            found = found or early_stop_result.top().second == i;
+            early_stop_result.pop();
+        }
+        REQUIRE(found);
+    }
+    REQUIRE(early_stop_visited < full_visited);
+}
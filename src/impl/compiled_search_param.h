@@ -0,0 +1,54 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "common.h"
+#include "vsag/search_param.h"
+
+namespace vsag {
+
+// a search param handle holding the parsed search parameters (T) of one index type
+template <typename T>
+class CompiledSearchParam : public SearchParam {
+public:
+    CompiledSearchParam(const std::string& parameters, const T& params)
+        : SearchParam(parameters), params_(params) {
+    }
+
+    static SearchParamPtr
+    Compile(const std::string& parameters) {
+        return std::make_shared<CompiledSearchParam<T>>(parameters, T::FromJson(parameters));
+    }
+
+    /**
+     * @brief get the parsed parameters of a handle, handles compiled by another index type
+     *        are parsed from their json string
+     */
+    static T
+    Resolve(const SearchParamPtr& param) {
+        CHECK_ARGUMENT(param != nullptr, "search param is nullptr");
+        const auto* compiled = dynamic_cast<const CompiledSearchParam<T>*>(param.get());
+        if (compiled != nullptr) {
+            return compiled->params_;
+        }
+        return T::FromJson(param->GetParameters());
+    }
+
+private:
+    const T params_;
+};
+
+}  // namespace vsag
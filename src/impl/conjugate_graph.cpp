@@ -15,10 +15,19 @@
 
 #include "conjugate_graph.h"
 
+#include <algorithm>
+#include <numeric>
+
 namespace vsag {
 
+static const size_t DELTA_COMPACT_MIN_ROWS = 1024;
+
 ConjugateGraph::ConjugateGraph(Allocator* allocator)
-    : allocator_(allocator), conjugate_graph_(allocator) {
+    : allocator_(allocator),
+      csr_tag_ids_(allocator),
+      csr_offsets_(allocator),
+      csr_neighbors_(allocator),
+      delta_graph_(allocator) {
     clear();
 }
 
@@ -28,15 +37,7 @@ ConjugateGraph::AddNeighbor(int64_t from_tag_id, int64_t to_tag_id) {
         return false;
     }
 
-    std::shared_ptr<UnorderedSet<int64_t>> neighbor_set;
-    auto search_key = conjugate_graph_.find(from_tag_id);
-    if (search_key == conjugate_graph_.end()) {
-        neighbor_set = std::make_shared<UnorderedSet<int64_t>>(allocator_);
-        conjugate_graph_.emplace(from_tag_id, neighbor_set);
-    } else {
-        neighbor_set = search_key->second;
-    }
-
+    auto neighbor_set = get_or_create_delta(from_tag_id);
     if (neighbor_set->size() >= MAXIMUM_DEGREE) {
         return false;
     }
@@ -50,61 +51,179 @@ ConjugateGraph::AddNeighbor(int64_t from_tag_id, int64_t to_tag_id) {
         memory_usage_ += sizeof(neighbor_set->size());
     }
     memory_usage_ += sizeof(to_tag_id);
+
+    // fold the delta back once it is no longer small next to the compacted rows
+    if (delta_graph_.size() > std::max(DELTA_COMPACT_MIN_ROWS, csr_tag_ids_.size() / 8)) {
+        compact();
+    }
     return true;
 }
 
 std::shared_ptr<UnorderedSet<int64_t>>
-ConjugateGraph::get_neighbors(int64_t from_tag_id) const {
-    auto iter = conjugate_graph_.find(from_tag_id);
-    if (iter == conjugate_graph_.end()) {
-        return nullptr;
+ConjugateGraph::get_or_create_delta(int64_t from_tag_id) {
+    auto iter = delta_graph_.find(from_tag_id);
+    if (iter != delta_graph_.end()) {
+        return iter->second;
+    }
+    // a row moves out of the CSR part on its first change and shadows it from then on
+    auto neighbor_set = std::make_shared<UnorderedSet<int64_t>>(allocator_);
+    const int64_t* neighbors = nullptr;
+    uint32_t count = 0;
+    if (get_csr_neighbors(from_tag_id, neighbors, count)) {
+        neighbor_set->insert(neighbors, neighbors + count);
+    }
+    delta_graph_.emplace(from_tag_id, neighbor_set);
+    return neighbor_set;
+}
+
+bool
+ConjugateGraph::get_csr_neighbors(int64_t from_tag_id,
+                                  const int64_t*& neighbors,
+                                  uint32_t& count) const {
+    auto iter = std::lower_bound(csr_tag_ids_.begin(), csr_tag_ids_.end(), from_tag_id);
+    if (iter == csr_tag_ids_.end() or *iter != from_tag_id) {
+        return false;
+    }
+    auto row = iter - csr_tag_ids_.begin();
+    neighbors = csr_neighbors_.data() + csr_offsets_[row];
+    count = csr_offsets_[row + 1] - csr_offsets_[row];
+    return true;
+}
+
+void
+ConjugateGraph::append_neighbors(int64_t from_tag_id, Vector<int64_t>& out) const {
+    if (not delta_graph_.empty()) {
+        auto iter = delta_graph_.find(from_tag_id);
+        if (iter != delta_graph_.end()) {
+            out.insert(out.end(), iter->second->begin(), iter->second->end());
+            return;
+        }
+    }
+    const int64_t* neighbors = nullptr;
+    uint32_t count = 0;
+    if (get_csr_neighbors(from_tag_id, neighbors, count)) {
+        out.insert(out.end(), neighbors, neighbors + count);
     }
-    return iter->second;
+}
+
+template <typename Func>
+void
+ConjugateGraph::for_each_row(Func func) const {
+    for (size_t row = 0; row < csr_tag_ids_.size(); ++row) {
+        auto tag_id = csr_tag_ids_[row];
+        if (delta_graph_.count(tag_id) != 0) {
+            continue;
+        }
+        func(tag_id,
+             csr_neighbors_.begin() + csr_offsets_[row],
+             csr_neighbors_.begin() + csr_offsets_[row + 1]);
+    }
+    for (const auto& [tag_id, neighbor_set] : delta_graph_) {
+        if (not neighbor_set->empty()) {
+            func(tag_id, neighbor_set->begin(), neighbor_set->end());
+        }
+    }
+}
+
+void
+ConjugateGraph::compact() {
+    Vector<std::pair<int64_t, Vector<int64_t>>> rows(allocator_);
+    uint64_t total = 0;
+    for_each_row([&](int64_t tag_id, auto begin, auto end) {
+        rows.emplace_back(tag_id, Vector<int64_t>(begin, end, allocator_));
+        total += rows.back().second.size();
+    });
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    Vector<int64_t> tag_ids(allocator_);
+    Vector<uint32_t> offsets(allocator_);
+    Vector<int64_t> neighbors(allocator_);
+    tag_ids.reserve(rows.size());
+    offsets.reserve(rows.size() + 1);
+    neighbors.reserve(total);
+    offsets.push_back(0);
+    for (const auto& [tag_id, row] : rows) {
+        tag_ids.push_back(tag_id);
+        neighbors.insert(neighbors.end(), row.begin(), row.end());
+        offsets.push_back(static_cast<uint32_t>(neighbors.size()));
+    }
+    csr_tag_ids_.swap(tag_ids);
+    csr_offsets_.swap(offsets);
+    csr_neighbors_.swap(neighbors);
+    delta_graph_.clear();
 }
 
 tl::expected<uint32_t, Error>
 ConjugateGraph::EnhanceResult(std::priority_queue<std::pair<float, LabelType>>& results,
-                              const std::function<float(int64_t)>& distance_of_tag) const {
+                              const BatchDistanceFunc& distances_of_tags) const {
     if (this->is_empty()) {
         return 0;
     }
 
     auto k = static_cast<int64_t>(results.size());
     int64_t look_at_k = std::min(LOOK_AT_K, k);
-    std::priority_queue<std::pair<float, LabelType>> old_results(results);
-    Vector<int64_t> to_be_visited(look_at_k, allocator_);
-    UnorderedSet<int64_t> visited_set(allocator_);
-    uint32_t successfully_enhanced = 0;
-    float distance = 0;
 
-    // initialize visited_set
-    for (auto j = static_cast<int64_t>(old_results.size() - 1); j >= 0; j--) {
-        visited_set.insert(old_results.top().second);
-        if (j < look_at_k) {
-            to_be_visited[j] = old_results.top().second;
+    // read the results from the heap storage instead of draining a copy of the queue
+    struct HeapAccess : std::priority_queue<std::pair<float, LabelType>> {
+        static const container_type&
+        Get(const std::priority_queue<std::pair<float, LabelType>>& queue) {
+            return queue.*&HeapAccess::c;
         }
-        old_results.pop();
+    };
+    Vector<std::pair<float, LabelType>> old_results(
+        HeapAccess::Get(results).begin(), HeapAccess::Get(results).end(), allocator_);
+    std::partial_sort(old_results.begin(), old_results.begin() + look_at_k, old_results.end());
+    Vector<int64_t> result_tag_ids(allocator_);
+    result_tag_ids.reserve(k);
+    for (const auto& item : old_results) {
+        result_tag_ids.push_back(item.second);
     }
 
-    // add neighbors in conjugate graph to enhance result
-    for (int j = 0; j < look_at_k; j++) {
-        auto neighbors = get_neighbors(to_be_visited[j]);
+    // gather the conjugate neighbors of the closest results, closest first
+    Vector<int64_t> candidates(allocator_);
+    for (int64_t j = 0; j < look_at_k; j++) {
+        append_neighbors(result_tag_ids[j], candidates);
+    }
+    if (candidates.empty()) {
+        return 0;
+    }
 
-        if (neighbors == nullptr) {
+    // drop the tags already in the result and repeated tags, keeping the first occurrence
+    std::sort(result_tag_ids.begin(), result_tag_ids.end());
+    Vector<uint32_t> order(candidates.size(), allocator_);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&candidates](uint32_t a, uint32_t b) {
+        return candidates[a] < candidates[b];
+    });
+    Vector<bool> keep(candidates.size(), false, allocator_);
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto tag_id = candidates[order[i]];
+        if (i > 0 and tag_id == candidates[order[i - 1]]) {
             continue;
         }
+        keep[order[i]] =
+            not std::binary_search(result_tag_ids.begin(), result_tag_ids.end(), tag_id);
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (keep[i]) {
+            candidates[count++] = candidates[i];
+        }
+    }
+    candidates.resize(count);
 
-        for (auto neighbor_tag_id : *neighbors) {
-            if (not visited_set.insert(neighbor_tag_id).second) {
-                continue;
-            }
-            distance = distance_of_tag(neighbor_tag_id);
-            // insert into results
-            if (distance < results.top().first) {
-                results.emplace(distance, neighbor_tag_id);
-                results.pop();
-                successfully_enhanced++;
-            }
+    Vector<float> distances(count, allocator_);
+    distances_of_tags(candidates.data(), static_cast<int64_t>(count), distances.data());
+
+    uint32_t successfully_enhanced = 0;
+    for (size_t i = 0; i < count; ++i) {
+        // insert into results
+        if (distances[i] < results.top().first) {
+            results.emplace(distances[i], candidates[i]);
+            results.pop();
+            successfully_enhanced++;
         }
     }
 
@@ -126,7 +245,10 @@ read_var_from_stream(StreamReader& in_stream, uint32_t* offset, T* dest) {
 void
 ConjugateGraph::clear() {
     memory_usage_ = sizeof(memory_usage_) + FOOTER_SIZE;
-    conjugate_graph_.clear();
+    csr_tag_ids_.clear();
+    csr_offsets_.assign(1, 0);
+    csr_neighbors_.clear();
+    delta_graph_.clear();
     footer_.Clear();
 }
 
@@ -153,17 +275,17 @@ tl::expected<void, Error>
 ConjugateGraph::Serialize(std::ostream& out_stream) const {
     out_stream.write((char*)&memory_usage_, sizeof(memory_usage_));
 
-    for (auto item : conjugate_graph_) {
-        auto neighbor_set = *item.second;
-        size_t neighbor_set_size = neighbor_set.size();
+    for_each_row([&out_stream](int64_t tag_id, auto begin, auto end) {
+        size_t neighbor_set_size = std::distance(begin, end);
 
-        out_stream.write((char*)&item.first, sizeof(item.first));
+        out_stream.write((char*)&tag_id, sizeof(tag_id));
         out_stream.write((char*)&neighbor_set_size, sizeof(neighbor_set_size));
 
-        for (auto neighbor_tag_id : neighbor_set) {
+        for (auto iter = begin; iter != end; ++iter) {
+            int64_t neighbor_tag_id = *iter;
             out_stream.write((char*)&neighbor_tag_id, sizeof(neighbor_tag_id));
         }
-    }
+    });
 
     footer_.Serialize(out_stream);
 
@@ -195,7 +317,7 @@ ConjugateGraph::Deserialize(StreamReader& in_stream) {
         int64_t from_tag_id = 0;
         int64_t to_tag_id = 0;
 
-        conjugate_graph_.clear();
+        clear();
 
         auto cur_pos = in_stream.GetCursor();
 
@@ -212,17 +334,15 @@ ConjugateGraph::Deserialize(StreamReader& in_stream) {
         in_stream.Seek(cur_pos + offset);
         while (offset != memory_usage_ - FOOTER_SIZE) {
             read_var_from_stream(in_stream, &offset, &from_tag_id);
-            if (conjugate_graph_.count(from_tag_id) == 0) {
-                conjugate_graph_.emplace(from_tag_id,
-                                         std::make_shared<UnorderedSet<int64_t>>(allocator_));
-            }
+            auto neighbor_set = get_or_create_delta(from_tag_id);
 
             read_var_from_stream(in_stream, &offset, &neighbor_size);
             for (int i = 0; i < neighbor_size; i++) {
                 read_var_from_stream(in_stream, &offset, &to_tag_id);
-                conjugate_graph_[from_tag_id]->insert(to_tag_id);
+                neighbor_set->insert(to_tag_id);
             }
         }
+        compact();
 
         return {};
     } catch (const std::runtime_error& e) {
@@ -242,26 +362,38 @@ ConjugateGraph::UpdateId(int64_t old_tag_id, int64_t new_tag_id) {
         return true;
     }
 
-    // 1. update key
-    bool updated = false;
-    auto it_old_key = conjugate_graph_.find(old_tag_id);
-    if (it_old_key != conjugate_graph_.end()) {
-        auto it_new_key = conjugate_graph_.find(new_tag_id);
-        if (it_new_key != conjugate_graph_.end()) {
+    const int64_t* neighbors = nullptr;
+    uint32_t count = 0;
+    bool old_in_delta = delta_graph_.count(old_tag_id) != 0;
+    bool old_in_csr = get_csr_neighbors(old_tag_id, neighbors, count);
+    if (old_in_delta or old_in_csr) {
+        if (delta_graph_.count(new_tag_id) != 0 or
+            get_csr_neighbors(new_tag_id, neighbors, count)) {
             // both two id exists in graph, note that this situation should be filtered out before use this function.
             return false;
         }
-        conjugate_graph_[new_tag_id] = std::move(it_old_key->second);
-        conjugate_graph_.erase(it_old_key);
+    }
+
+    // 1. update key
+    bool updated = false;
+    if (old_in_delta) {
+        auto it_old_key = delta_graph_.find(old_tag_id);
+        delta_graph_[new_tag_id] = std::move(it_old_key->second);
+        delta_graph_.erase(it_old_key);
         updated = true;
     }
 
-    // 2. update neighbors
-    for (auto& [key, neighbors] : conjugate_graph_) {
-        auto it_old_neighbor = neighbors->find(old_tag_id);
-        if (it_old_neighbor != neighbors->end()) {
-            neighbors->erase(it_old_neighbor);
-            neighbors->insert(new_tag_id);
+    // 2. update the compacted rows, the delta rows shadow theirs
+    updated = update_csr_id(old_tag_id, new_tag_id, old_in_delta) or updated;
+
+    // 3. update neighbors
+    for (auto& [key, neighbor_set] : delta_graph_) {
+        auto it_old_neighbor = neighbor_set->find(old_tag_id);
+        if (it_old_neighbor != neighbor_set->end()) {
+            neighbor_set->erase(it_old_neighbor);
+            if (not neighbor_set->insert(new_tag_id).second) {
+                memory_usage_ -= sizeof(new_tag_id);
+            }
             updated = true;
         }
     }
@@ -269,4 +401,68 @@ ConjugateGraph::UpdateId(int64_t old_tag_id, int64_t new_tag_id) {
     return updated;
 }
 
+bool
+ConjugateGraph::update_csr_id(int64_t old_tag_id, int64_t new_tag_id, bool drop_old_row) {
+    auto old_row = std::lower_bound(csr_tag_ids_.begin(), csr_tag_ids_.end(), old_tag_id);
+    bool has_old_row = old_row != csr_tag_ids_.end() and *old_row == old_tag_id;
+    if (not has_old_row and
+        std::find(csr_neighbors_.begin(), csr_neighbors_.end(), old_tag_id) ==
+            csr_neighbors_.end()) {
+        return false;
+    }
+
+    // the rows in their new order: the old row is renamed, or dropped when a delta row
+    //  has taken it over
+    Vector<std::pair<int64_t, uint32_t>> rows(allocator_);
+    rows.reserve(csr_tag_ids_.size());
+    for (uint32_t row = 0; row < csr_tag_ids_.size(); ++row) {
+        auto tag_id = csr_tag_ids_[row];
+        if (tag_id == old_tag_id) {
+            if (drop_old_row) {
+                continue;
+            }
+            tag_id = new_tag_id;
+        }
+        rows.emplace_back(tag_id, row);
+    }
+    if (has_old_row and not drop_old_row) {
+        std::sort(rows.begin(), rows.end());
+    }
+
+    bool updated = has_old_row and not drop_old_row;
+    Vector<int64_t> tag_ids(allocator_);
+    Vector<uint32_t> offsets(allocator_);
+    Vector<int64_t> neighbors(allocator_);
+    tag_ids.reserve(rows.size());
+    offsets.reserve(rows.size() + 1);
+    neighbors.reserve(csr_neighbors_.size());
+    offsets.push_back(0);
+    for (const auto& [tag_id, row] : rows) {
+        auto begin = csr_neighbors_.begin() + csr_offsets_[row];
+        auto end = csr_neighbors_.begin() + csr_offsets_[row + 1];
+        // a shadowed row is stale, its delta row is updated instead
+        bool shadowed = delta_graph_.count(tag_id) != 0;
+        bool has_new = std::find(begin, end, new_tag_id) != end;
+        for (auto iter = begin; iter != end; ++iter) {
+            if (shadowed or *iter != old_tag_id) {
+                neighbors.push_back(*iter);
+                continue;
+            }
+            updated = true;
+            if (has_new) {
+                // the row links to both ids, only one edge is left
+                memory_usage_ -= sizeof(new_tag_id);
+            } else {
+                neighbors.push_back(new_tag_id);
+            }
+        }
+        tag_ids.push_back(tag_id);
+        offsets.push_back(static_cast<uint32_t>(neighbors.size()));
+    }
+    csr_tag_ids_.swap(tag_ids);
+    csr_offsets_.swap(offsets);
+    csr_neighbors_.swap(neighbors);
+    return updated;
+}
+
 }  // namespace vsag
@@ -28,6 +28,10 @@ namespace vsag {
 static const int64_t LOOK_AT_K = 20;
 static const int64_t MAXIMUM_DEGREE = 128;
 
+// writes the distances of count tags to the query into distances, FLT_MAX for unknown tags
+using BatchDistanceFunc =
+    std::function<void(const int64_t* tag_ids, int64_t count, float* distances)>;
+
 class ConjugateGraph {
 public:
     ConjugateGraph(Allocator* allocator);
@@ -37,7 +41,7 @@ public:
 
     tl::expected<uint32_t, Error>
     EnhanceResult(std::priority_queue<std::pair<float, LabelType>>& results,
-                  const std::function<float(int64_t)>& distance_of_tag) const;
+                  const BatchDistanceFunc& distances_of_tags) const;
 
     tl::expected<bool, Error>
     UpdateId(int64_t old_tag_id, int64_t new_tag_id);
@@ -59,8 +63,26 @@ public:
     GetMemoryUsage() const;
 
 private:
+    bool
+    get_csr_neighbors(int64_t from_tag_id, const int64_t*& neighbors, uint32_t& count) const;
+
+    void
+    append_neighbors(int64_t from_tag_id, Vector<int64_t>& out) const;
+
+    template <typename Func>
+    void
+    for_each_row(Func func) const;
+
     std::shared_ptr<UnorderedSet<int64_t>>
-    get_neighbors(int64_t from_tag_id) const;
+    get_or_create_delta(int64_t from_tag_id);
+
+    void
+    compact();
+
+    // rewrites old_tag_id in the compacted rows and keeps them sorted, drop_old_row removes
+    //  the row of old_tag_id instead of renaming it
+    bool
+    update_csr_id(int64_t old_tag_id, int64_t new_tag_id, bool drop_old_row);
 
     void
     clear();
@@ -71,7 +93,14 @@ private:
 private:
     uint32_t memory_usage_;
 
-    UnorderedMap<int64_t, std::shared_ptr<UnorderedSet<int64_t>>> conjugate_graph_;
+    // Rows compacted into CSR form and sorted by tag id; row i spans
+    // csr_neighbors_[csr_offsets_[i], csr_offsets_[i + 1]).
+    Vector<int64_t> csr_tag_ids_;
+    Vector<uint32_t> csr_offsets_;
+    Vector<int64_t> csr_neighbors_;
+
+    // Rows added or changed since the last compaction, shadowing their CSR rows.
+    UnorderedMap<int64_t, std::shared_ptr<UnorderedSet<int64_t>>> delta_graph_;
 
     SerializationFooter footer_;
 
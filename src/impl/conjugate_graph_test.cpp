@@ -313,3 +313,96 @@ TEST_CASE("ConjugateGraph Update ID Test", "[ut][ConjugateGraph]") {
     REQUIRE(conjugate_graph->AddNeighbor(1, -1) == false);
     REQUIRE(conjugate_graph->AddNeighbor(5, -1) == false);
 }
+
+TEST_CASE("ConjugateGraph Update ID after Compaction", "[ut][ConjugateGraph]") {
+    auto allocator = vsag::SafeAllocator::FactoryDefaultAllocator();
+    std::shared_ptr<vsag::ConjugateGraph> conjugate_graph =
+        std::make_shared<vsag::ConjugateGraph>(allocator.get());
+
+    REQUIRE(conjugate_graph->AddNeighbor(0, 1) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(0, 2) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(1, 0) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(4, 0) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(3, 2) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(3, 4) == true);
+
+    // a deserialized graph keeps all its rows compacted
+    vsag::Binary binary = *conjugate_graph->Serialize();
+    REQUIRE(conjugate_graph->Deserialize(binary).has_value());
+    auto memory_usage = conjugate_graph->GetMemoryUsage();
+
+    REQUIRE(conjugate_graph->UpdateId(5, 4) == false);
+    REQUIRE(conjugate_graph->UpdateId(0, 4) == false);
+    REQUIRE(conjugate_graph->UpdateId(4, 5) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(5, 0) == false);
+
+    // row 3 links to both 2 and 5, only one edge is left
+    REQUIRE(conjugate_graph->UpdateId(2, 5) == true);
+    REQUIRE(conjugate_graph->GetMemoryUsage() == memory_usage - sizeof(int64_t));
+    REQUIRE(conjugate_graph->AddNeighbor(0, 5) == false);
+    REQUIRE(conjugate_graph->AddNeighbor(3, 5) == false);
+
+    binary = *conjugate_graph->Serialize();
+    REQUIRE(conjugate_graph->Deserialize(binary).has_value());
+    REQUIRE(conjugate_graph->GetMemoryUsage() == memory_usage - sizeof(int64_t));
+    REQUIRE(conjugate_graph->AddNeighbor(0, 2) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(3, 2) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(4, 0) == true);
+}
+
+TEST_CASE("ConjugateGraph Enhance Result", "[ut][ConjugateGraph]") {
+    auto allocator = vsag::SafeAllocator::FactoryDefaultAllocator();
+    std::shared_ptr<vsag::ConjugateGraph> conjugate_graph =
+        std::make_shared<vsag::ConjugateGraph>(allocator.get());
+
+    REQUIRE(conjugate_graph->AddNeighbor(0, 10) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(0, 11) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(0, 1) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(1, 12) == true);
+    REQUIRE(conjugate_graph->AddNeighbor(1, 10) == true);
+
+    std::unordered_map<int64_t, float> tag_distances{{10, 0.5}, {11, 5.0}, {12, 2.5}};
+    int64_t batch_calls = 0;
+    int64_t evaluated = 0;
+    auto distances_of_tags = [&](const int64_t* tag_ids, int64_t count, float* distances) {
+        batch_calls++;
+        evaluated += count;
+        for (int64_t i = 0; i < count; ++i) {
+            auto iter = tag_distances.find(tag_ids[i]);
+            distances[i] = iter == tag_distances.end() ? std::numeric_limits<float>::max()
+                                                       : iter->second;
+        }
+    };
+
+    auto check_enhance = [&](int64_t expected_evaluated) {
+        std::priority_queue<std::pair<float, vsag::LabelType>> results;
+        results.emplace(1.0, 0);
+        results.emplace(2.0, 1);
+        results.emplace(3.0, 2);
+        batch_calls = 0;
+        evaluated = 0;
+        REQUIRE(conjugate_graph->EnhanceResult(results, distances_of_tags).value() == 1);
+        // tag 1 is already in the result and tag 10 is reached twice
+        REQUIRE(batch_calls == 1);
+        REQUIRE(evaluated == expected_evaluated);
+
+        std::vector<std::pair<float, vsag::LabelType>> expected{{2.0, 1}, {1.0, 0}, {0.5, 10}};
+        for (const auto& item : expected) {
+            REQUIRE(results.top() == item);
+            results.pop();
+        }
+    };
+
+    check_enhance(3);
+
+    // deserialization compacts all rows into the CSR part
+    vsag::Binary binary = *conjugate_graph->Serialize();
+    REQUIRE(conjugate_graph->Deserialize(binary).has_value());
+    check_enhance(3);
+
+    // a compacted row stays deduplicated when it changes again
+    REQUIRE(conjugate_graph->AddNeighbor(0, 10) == false);
+    REQUIRE(conjugate_graph->AddNeighbor(0, 13) == true);
+    check_enhance(4);
+    REQUIRE(conjugate_graph->Serialize()->size == binary.size + sizeof(int64_t));
+}
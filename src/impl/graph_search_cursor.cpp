@@ -0,0 +1,295 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "graph_search_cursor.h"
+
+#include "common.h"
+#include "dataset_impl.h"
+#include "utils/util_functions.h"
+
+namespace vsag {
+
+static constexpr uint64_t CURSOR_SIZE_PER_EF = 8;
+static constexpr uint64_t MIN_CURSOR_SIZE = 1024;
+
+// keeps the size closest entries of a heap keyed by negative distance
+static void
+truncate_heap(MaxHeap& heap, uint64_t size, Allocator* allocator) {
+    if (heap.size() <= size) {
+        return;
+    }
+    MaxHeap kept(allocator);
+    while (kept.size() < size) {
+        kept.emplace(heap.top());
+        heap.pop();
+    }
+    heap.swap(kept);
+}
+
+GraphSearchCursor::GraphSearchCursor(uint64_t ef,
+                                     InnerIdType total_count,
+                                     Allocator* allocator,
+                                     uint64_t max_size)
+    : allocator_(allocator),
+      ef_(std::max<uint64_t>(ef, 1)),
+      total_count_(total_count),
+      max_size_(max_size == 0 ? std::max(ef_ * CURSOR_SIZE_PER_EF, MIN_CURSOR_SIZE)
+                              : std::max(max_size, ef_ * 2)),
+      visited_((static_cast<uint64_t>(total_count) + 63) / 64, 0, allocator),
+      frontier_(allocator),
+      pending_(allocator),
+      lookahead_(allocator),
+      window_(allocator),
+      neighbors_(allocator),
+      unvisited_(allocator),
+      dists_(allocator) {
+}
+
+tl::expected<DatasetPtr, Error>
+GraphSearchCursor::Next(int64_t n) {
+    SAFE_CALL(return this->next(n));
+}
+
+bool
+GraphSearchCursor::Exhausted() const {
+    return frontier_.empty() and pending_.empty() and window_.empty();
+}
+
+uint64_t
+GraphSearchCursor::HeldCount() const {
+    return frontier_.size() + pending_.size() + lookahead_.size() + window_.size();
+}
+
+void
+GraphSearchCursor::Seed(InnerIdType entry_point) {
+    if (entry_point >= total_count_ or not this->test_and_set_visited(entry_point)) {
+        return;
+    }
+    float dist = 0.0F;
+    this->compute_distances(&entry_point, 1, &dist);
+    frontier_.emplace(-dist, entry_point);
+    if (this->check_valid(entry_point)) {
+        pending_.emplace(-dist, entry_point);
+        lookahead_.emplace(dist, entry_point);
+    }
+}
+
+DatasetPtr
+GraphSearchCursor::next(int64_t n) {
+    CHECK_ARGUMENT(n > 0, fmt::format("n({}) must be greater than 0", n));
+    Vector<std::pair<float, InnerIdType>> results(allocator_);
+    std::pair<float, InnerIdType> result;
+    while (results.size() < static_cast<uint64_t>(n)) {
+        if (not this->use_rerank()) {
+            if (not this->take(result)) {
+                break;
+            }
+            results.emplace_back(result);
+            continue;
+        }
+        this->fill_window();
+        if (window_.empty()) {
+            break;
+        }
+        results.emplace_back(-window_.top().first, window_.top().second);
+        window_.pop();
+    }
+
+    if (results.empty()) {
+        return DatasetImpl::MakeEmptyDataset();
+    }
+    auto count = static_cast<int64_t>(results.size());
+    auto [dataset, dists, ids] = CreateFastDataset(count, allocator_);
+    for (int64_t i = 0; i < count; ++i) {
+        dists[i] = results[i].first;
+        ids[i] = this->get_label(results[i].second);
+    }
+    return dataset;
+}
+
+void
+GraphSearchCursor::expand() {
+    auto capacity = ef_ + taken_count_;
+    while (not frontier_.empty()) {
+        auto current_dist = -frontier_.top().first;
+        if (lookahead_.size() >= capacity and current_dist > lookahead_.top().first) {
+            break;
+        }
+        auto current_id = frontier_.top().second;
+        frontier_.pop();
+
+        this->get_neighbors(current_id, neighbors_);
+        unvisited_.clear();
+        for (const auto& neighbor : neighbors_) {
+            // nodes added after the cursor was opened are out of its visited set
+            if (neighbor < total_count_ and this->test_and_set_visited(neighbor)) {
+                unvisited_.emplace_back(neighbor);
+            }
+        }
+        if (unvisited_.empty()) {
+            continue;
+        }
+        dists_.resize(unvisited_.size());
+        this->compute_distances(unvisited_.data(), unvisited_.size(), dists_.data());
+        for (uint64_t i = 0; i < unvisited_.size(); ++i) {
+            auto dist = dists_[i];
+            auto inner_id = unvisited_[i];
+            frontier_.emplace(-dist, inner_id);
+            if (not this->check_valid(inner_id)) {
+                continue;
+            }
+            pending_.emplace(-dist, inner_id);
+            if (lookahead_.size() < capacity or dist < lookahead_.top().first) {
+                lookahead_.emplace(dist, inner_id);
+                if (lookahead_.size() > capacity) {
+                    lookahead_.pop();
+                }
+            }
+        }
+        if (frontier_.size() > max_size_ or pending_.size() > max_size_ or
+            lookahead_.size() > max_size_) {
+            this->compact();
+            capacity = ef_ + taken_count_;
+        }
+    }
+}
+
+void
+GraphSearchCursor::compact() {
+    auto size = max_size_ / 2;
+    truncate_heap(frontier_, size, allocator_);
+    truncate_heap(pending_, size, allocator_);
+
+    // the lookahead restarts from the closest results that are not taken yet
+    MaxHeap closest(pending_);
+    MaxHeap lookahead(allocator_);
+    while (not closest.empty() and lookahead.size() < ef_) {
+        lookahead.emplace(-closest.top().first, closest.top().second);
+        closest.pop();
+    }
+    lookahead_.swap(lookahead);
+    taken_count_ = 0;
+}
+
+bool
+GraphSearchCursor::take(std::pair<float, InnerIdType>& result) {
+    this->expand();
+    if (pending_.empty()) {
+        return false;
+    }
+    result = {-pending_.top().first, pending_.top().second};
+    pending_.pop();
+    ++taken_count_;
+    return true;
+}
+
+void
+GraphSearchCursor::fill_window() {
+    if (window_.size() >= ef_) {
+        return;
+    }
+    Vector<InnerIdType> ids(allocator_);
+    std::pair<float, InnerIdType> result;
+    while (window_.size() + ids.size() < ef_ and this->take(result)) {
+        ids.emplace_back(result.second);
+    }
+    if (ids.empty()) {
+        return;
+    }
+    Vector<float> dists(ids.size(), allocator_);
+    this->rerank(ids.data(), ids.size(), dists.data());
+    for (uint64_t i = 0; i < ids.size(); ++i) {
+        window_.emplace(-dists[i], ids[i]);
+    }
+}
+
+bool
+GraphSearchCursor::test_and_set_visited(InnerIdType inner_id) {
+    auto& word = visited_[inner_id >> 6];
+    auto mask = 1ULL << (inner_id & 63);
+    if ((word & mask) != 0) {
+        return false;
+    }
+    word |= mask;
+    return true;
+}
+
+FlattenGraphSearchCursor::FlattenGraphSearchCursor(const float* query,
+                                                   uint64_t ef,
+                                                   GraphInterfacePtr graph,
+                                                   FlattenInterfacePtr flatten,
+                                                   FlattenInterfacePtr precise_flatten,
+                                                   FilterPtr filter,
+                                                   LabelTablePtr label_table,
+                                                   MutexArrayPtr neighbors_mutex,
+                                                   std::shared_mutex& index_mutex,
+                                                   Allocator* allocator)
+    : GraphSearchCursor(ef, static_cast<InnerIdType>(flatten->TotalCount()), allocator),
+      graph_(std::move(graph)),
+      flatten_(std::move(flatten)),
+      precise_flatten_(std::move(precise_flatten)),
+      filter_(std::move(filter)),
+      label_table_(std::move(label_table)),
+      neighbors_mutex_(std::move(neighbors_mutex)),
+      index_mutex_(index_mutex) {
+    // the computers keep their own copy of the encoded query
+    computer_ = flatten_->FactoryComputer(query);
+    if (precise_flatten_ != nullptr) {
+        precise_computer_ = precise_flatten_->FactoryComputer(query);
+    }
+}
+
+tl::expected<DatasetPtr, Error>
+FlattenGraphSearchCursor::Next(int64_t n) {
+    std::shared_lock lock(index_mutex_);
+    return GraphSearchCursor::Next(n);
+}
+
+void
+FlattenGraphSearchCursor::get_neighbors(InnerIdType inner_id,
+                                        Vector<InnerIdType>& neighbors) const {
+    if (neighbors_mutex_ != nullptr) {
+        SharedLock lock(neighbors_mutex_, inner_id);
+        graph_->GetNeighbors(inner_id, neighbors);
+    } else {
+        graph_->GetNeighbors(inner_id, neighbors);
+    }
+}
+
+void
+FlattenGraphSearchCursor::compute_distances(const InnerIdType* inner_ids,
+                                            uint64_t count,
+                                            float* dists) const {
+    flatten_->Query(dists, computer_, inner_ids, count);
+}
+
+bool
+FlattenGraphSearchCursor::check_valid(InnerIdType inner_id) const {
+    return filter_ == nullptr or filter_->CheckValid(inner_id);
+}
+
+LabelType
+FlattenGraphSearchCursor::get_label(InnerIdType inner_id) const {
+    return label_table_->GetLabelById(inner_id);
+}
+
+void
+FlattenGraphSearchCursor::rerank(const InnerIdType* inner_ids,
+                                 uint64_t count,
+                                 float* dists) const {
+    precise_flatten_->Query(dists, precise_computer_, inner_ids, count);
+}
+
+}  // namespace vsag
@@ -0,0 +1,202 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <shared_mutex>
+
+#include "data_cell/flatten_interface.h"
+#include "data_cell/graph_interface.h"
+#include "label_table.h"
+#include "lock_strategy.h"
+#include "typing.h"
+#include "vsag/filter.h"
+#include "vsag/search_cursor.h"
+
+namespace vsag {
+
+/**
+ * @brief a best-first traversal of a graph that is resumed page by page
+ *
+ * Discovered nodes wait in the frontier and valid ones in the pending results between pages.
+ * A page stops expanding once the closest frontier node is farther than the ef-th closest
+ * pending result, the same rule as a knn search with ef; the lookahead grows by one for every
+ * result taken out, so each page only explores what it needs. With a precise rerank, taken
+ * results wait in a window of ef and leave it in the order of their precise distances.
+ *
+ * The heaps are bounded by max_size: once one of them grows beyond it, the frontier and the
+ * pending results keep their closest half and the farther nodes are dropped, like the
+ * candidates beyond ef in a knn search. A deep pagination therefore may miss far results.
+ * The visited set is a bitmap of total_count bits, allocated once per cursor.
+ */
+class GraphSearchCursor : public SearchCursor {
+public:
+    // max_size 0 picks a bound from ef
+    GraphSearchCursor(uint64_t ef,
+                      InnerIdType total_count,
+                      Allocator* allocator,
+                      uint64_t max_size = 0);
+
+    tl::expected<DatasetPtr, Error>
+    Next(int64_t n) override;
+
+    [[nodiscard]] bool
+    Exhausted() const override;
+
+    /**
+     * @brief start the traversal from an entry point, called once before the first page
+     */
+    void
+    Seed(InnerIdType entry_point);
+
+    /**
+     * @brief the number of candidates held between pages, bounded by about 3 * max_size
+     */
+    [[nodiscard]] uint64_t
+    HeldCount() const;
+
+protected:
+    virtual void
+    get_neighbors(InnerIdType inner_id, Vector<InnerIdType>& neighbors) const = 0;
+
+    virtual void
+    compute_distances(const InnerIdType* inner_ids, uint64_t count, float* dists) const = 0;
+
+    [[nodiscard]] virtual bool
+    check_valid(InnerIdType inner_id) const = 0;
+
+    [[nodiscard]] virtual LabelType
+    get_label(InnerIdType inner_id) const = 0;
+
+    [[nodiscard]] virtual bool
+    use_rerank() const {
+        return false;
+    }
+
+    // the precise distances of taken results, only called when use_rerank() is true
+    virtual void
+    rerank(const InnerIdType* inner_ids, uint64_t count, float* dists) const {
+    }
+
+private:
+    DatasetPtr
+    next(int64_t n);
+
+    // expand the frontier until the closest pending result is settled
+    void
+    expand();
+
+    // take the closest settled result out of the pending ones
+    bool
+    take(std::pair<float, InnerIdType>& result);
+
+    void
+    fill_window();
+
+    // drop the farther half of the frontier and the pending results
+    void
+    compact();
+
+    bool
+    test_and_set_visited(InnerIdType inner_id);
+
+private:
+    Allocator* const allocator_{nullptr};
+
+    const uint64_t ef_{0};
+
+    const InnerIdType total_count_{0};
+
+    const uint64_t max_size_{0};
+
+    Vector<uint64_t> visited_;
+
+    // nodes not expanded yet and results not taken yet, both keyed by negative distance
+    MaxHeap frontier_;
+    MaxHeap pending_;
+
+    // the closest valid distances found since the last compaction, bounded by
+    //  ef_ + taken_count_
+    MaxHeap lookahead_;
+
+    // taken results keyed by negative precise distance, only used with a rerank
+    MaxHeap window_;
+
+    // results taken since the last compaction
+    uint64_t taken_count_{0};
+
+    Vector<InnerIdType> neighbors_;
+    Vector<InnerIdType> unvisited_;
+    Vector<float> dists_;
+};
+
+/**
+ * @brief a cursor over a graph data cell and the flatten codes it was built on, as used
+ *        by HGraph
+ *
+ * Every page holds index_mutex shared, so the index cannot resize or rewrite the cells while
+ * the page runs; the cursor refers to that mutex and must not outlive the index owning it.
+ */
+class FlattenGraphSearchCursor : public GraphSearchCursor {
+public:
+    FlattenGraphSearchCursor(const float* query,
+                             uint64_t ef,
+                             GraphInterfacePtr graph,
+                             FlattenInterfacePtr flatten,
+                             FlattenInterfacePtr precise_flatten,
+                             FilterPtr filter,
+                             LabelTablePtr label_table,
+                             MutexArrayPtr neighbors_mutex,
+                             std::shared_mutex& index_mutex,
+                             Allocator* allocator);
+
+    tl::expected<DatasetPtr, Error>
+    Next(int64_t n) override;
+
+protected:
+    void
+    get_neighbors(InnerIdType inner_id, Vector<InnerIdType>& neighbors) const override;
+
+    void
+    compute_distances(const InnerIdType* inner_ids, uint64_t count, float* dists) const override;
+
+    [[nodiscard]] bool
+    check_valid(InnerIdType inner_id) const override;
+
+    [[nodiscard]] LabelType
+    get_label(InnerIdType inner_id) const override;
+
+    [[nodiscard]] bool
+    use_rerank() const override {
+        return precise_flatten_ != nullptr;
+    }
+
+    void
+    rerank(const InnerIdType* inner_ids, uint64_t count, float* dists) const override;
+
+private:
+    const GraphInterfacePtr graph_{nullptr};
+    const FlattenInterfacePtr flatten_{nullptr};
+    const FlattenInterfacePtr precise_flatten_{nullptr};
+    const FilterPtr filter_{nullptr};
+    const LabelTablePtr label_table_{nullptr};
+    const MutexArrayPtr neighbors_mutex_{nullptr};
+    std::shared_mutex& index_mutex_;
+
+    ComputerInterfacePtr computer_{nullptr};
+    ComputerInterfacePtr precise_computer_{nullptr};
+};
+
+}  // namespace vsag
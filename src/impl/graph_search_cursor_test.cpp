@@ -0,0 +1,174 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "graph_search_cursor.h"
+
+#include <cmath>
+#include <unordered_set>
+
+#include "catch2/catch_test_macros.hpp"
+#include "default_allocator.h"
+
+using namespace vsag;
+
+// points on a line at x = id, each linked to its two neighbors and to id + 7
+class LineSearchCursor : public GraphSearchCursor {
+public:
+    LineSearchCursor(float query,
+                     uint64_t ef,
+                     InnerIdType count,
+                     Allocator* allocator,
+                     uint64_t max_size = 0)
+        : GraphSearchCursor(ef, count, allocator, max_size), query_(query), count_(count) {
+    }
+
+    bool only_even{false};
+    bool reverse_rerank{false};
+
+protected:
+    void
+    get_neighbors(InnerIdType inner_id, Vector<InnerIdType>& neighbors) const override {
+        neighbors.clear();
+        if (inner_id > 0) {
+            neighbors.emplace_back(inner_id - 1);
+        }
+        if (inner_id + 1 < count_) {
+            neighbors.emplace_back(inner_id + 1);
+        }
+        if (inner_id + 7 < count_) {
+            neighbors.emplace_back(inner_id + 7);
+        }
+    }
+
+    void
+    compute_distances(const InnerIdType* inner_ids, uint64_t count, float* dists) const override {
+        for (uint64_t i = 0; i < count; ++i) {
+            dists[i] = std::abs(static_cast<float>(inner_ids[i]) - query_);
+        }
+    }
+
+    [[nodiscard]] bool
+    check_valid(InnerIdType inner_id) const override {
+        return not only_even or inner_id % 2 == 0;
+    }
+
+    [[nodiscard]] LabelType
+    get_label(InnerIdType inner_id) const override {
+        return static_cast<LabelType>(inner_id) + 1000;
+    }
+
+    [[nodiscard]] bool
+    use_rerank() const override {
+        return reverse_rerank;
+    }
+
+    void
+    rerank(const InnerIdType* inner_ids, uint64_t count, float* dists) const override {
+        for (uint64_t i = 0; i < count; ++i) {
+            dists[i] = -static_cast<float>(inner_ids[i]);
+        }
+    }
+
+private:
+    float query_;
+    InnerIdType count_;
+};
+
+TEST_CASE("GraphSearchCursor Pagination Test", "[ut][GraphSearchCursor]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    InnerIdType count = 200;
+    LineSearchCursor cursor(30.2F, 8, count, allocator.get());
+    cursor.Seed(150);
+
+    std::unordered_set<int64_t> returned;
+    float last_dist = -1.0F;
+    while (not cursor.Exhausted()) {
+        auto page = cursor.Next(16);
+        REQUIRE(page.has_value());
+        auto size = page.value()->GetDim();
+        REQUIRE(size <= 16);
+        for (int64_t i = 0; i < size; ++i) {
+            auto dist = page.value()->GetDistances()[i];
+            REQUIRE(dist >= last_dist);
+            last_dist = dist;
+            REQUIRE(returned.insert(page.value()->GetIds()[i]).second);
+        }
+    }
+    REQUIRE(returned.size() == count);
+    REQUIRE(returned.count(1030) == 1);
+
+    auto empty = cursor.Next(16);
+    REQUIRE(empty.has_value());
+    REQUIRE(empty.value()->GetDim() == 0);
+    REQUIRE_FALSE(cursor.Next(0).has_value());
+}
+
+TEST_CASE("GraphSearchCursor Bounded Size Test", "[ut][GraphSearchCursor]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    InnerIdType count = 2000;
+    uint64_t max_size = 64;
+    LineSearchCursor cursor(30.2F, 8, count, allocator.get(), max_size);
+    cursor.Seed(1500);
+
+    std::unordered_set<int64_t> returned;
+    float last_dist = -1.0F;
+    while (not cursor.Exhausted()) {
+        auto page = cursor.Next(16);
+        REQUIRE(page.has_value());
+        REQUIRE(cursor.HeldCount() <= 3 * max_size);
+        for (int64_t i = 0; i < page.value()->GetDim(); ++i) {
+            auto dist = page.value()->GetDistances()[i];
+            REQUIRE(dist >= last_dist);
+            last_dist = dist;
+            REQUIRE(returned.insert(page.value()->GetIds()[i]).second);
+        }
+        // the first two pages are still exact: the ids 15 to 46 are the closest to 30.2
+        if (returned.size() == 32) {
+            for (int64_t id = 15; id <= 46; ++id) {
+                REQUIRE(returned.count(id + 1000) == 1);
+            }
+        }
+    }
+    // the far results are dropped instead of held until the end
+    REQUIRE(returned.size() < count);
+}
+
+TEST_CASE("GraphSearchCursor Filter And Rerank Test", "[ut][GraphSearchCursor]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    InnerIdType count = 100;
+
+    LineSearchCursor filtered(50.0F, 4, count, allocator.get());
+    filtered.only_even = true;
+    filtered.Seed(51);
+    auto page = filtered.Next(count);
+    REQUIRE(page.has_value());
+    REQUIRE(page.value()->GetDim() == count / 2);
+    REQUIRE(page.value()->GetIds()[0] == 1050);
+    for (int64_t i = 0; i < page.value()->GetDim(); ++i) {
+        REQUIRE(page.value()->GetIds()[i] % 2 == 0);
+    }
+
+    // the rerank prefers larger ids, the window of ef slides forward by one id per result
+    LineSearchCursor reranked(0.0F, 5, count, allocator.get());
+    reranked.reverse_rerank = true;
+    reranked.Seed(0);
+    auto first = reranked.Next(5);
+    REQUIRE(first.has_value());
+    REQUIRE(first.value()->GetDim() == 5);
+    for (int64_t i = 0; i < 5; ++i) {
+        REQUIRE(first.value()->GetIds()[i] == 1004 + i);
+        REQUIRE(first.value()->GetDistances()[i] == -static_cast<float>(4 + i));
+    }
+}
@@ -0,0 +1,131 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "inner_id_bitmap_filter.h"
+
+#include "common.h"
+
+namespace vsag {
+
+InnerIdBitmapFilter::InnerIdBitmapFilter(InnerIdType total_count, Allocator* allocator)
+    : bits_(std::make_shared<Vector<uint64_t>>(
+          (static_cast<uint64_t>(total_count) + WORD_MASK) >> WORD_SHIFT, 0, allocator)),
+      words_(bits_->data()),
+      total_count_(total_count) {
+}
+
+InnerIdBitmapFilter::InnerIdBitmapFilter(const InnerIdBitmapFilter& base,
+                                         TombstoneTablePtr tombstones,
+                                         float live_ratio)
+    : bits_(base.bits_),
+      words_(base.words_),
+      total_count_(base.total_count_),
+      valid_count_(base.valid_count_),
+      tombstones_(std::move(tombstones)),
+      live_ratio_(base.live_ratio_ * live_ratio) {
+}
+
+InnerIdBitmapCache::InnerIdBitmapCache(Allocator* allocator)
+    : allocator_(allocator), entries_(CACHE_SLOT_COUNT, allocator) {
+}
+
+InnerIdBitmapFilterPtr
+InnerIdBitmapCache::Get(const FilterPtr& filter,
+                        const LabelTable& label_table,
+                        InnerIdType total_count) {
+    if (filter == nullptr) {
+        return nullptr;
+    }
+    auto space = filter->InvalidBitsetSpace();
+    if (space == Filter::BitsetSpace::NONE) {
+        return nullptr;
+    }
+    auto bitset = filter->InvalidBitset();
+    if (bitset == nullptr) {
+        return nullptr;
+    }
+    auto version = filter->Version();
+    if (version == Filter::UNSTABLE_VERSION) {
+        // translating on every search costs more than testing the visited candidates
+        return nullptr;
+    }
+    auto matches = [&](const Entry& entry) {
+        return entry.bitset == bitset and entry.space == space and entry.version == version and
+               entry.total_count == total_count;
+    };
+
+    uint64_t generation = 0;
+    {
+        std::shared_lock lock(this->mutex_);
+        for (const auto& entry : this->entries_) {
+            if (matches(entry)) {
+                return entry.bitmap;
+            }
+        }
+        generation = this->generation_;
+    }
+
+    // translate outside the lock, so hits and other misses are not blocked by it
+    auto bitmap = this->translate(bitset, space, label_table, total_count);
+
+    std::unique_lock lock(this->mutex_);
+    if (this->generation_ != generation) {
+        // the labels changed while translating, the result is not cached
+        return bitmap;
+    }
+    for (const auto& entry : this->entries_) {
+        if (matches(entry)) {
+            // a concurrent query with the same filter cached it first
+            return entry.bitmap;
+        }
+    }
+    auto& slot = this->entries_[this->next_slot_];
+    this->next_slot_ = (this->next_slot_ + 1) % CACHE_SLOT_COUNT;
+    slot.bitset = bitset;
+    slot.space = space;
+    slot.version = version;
+    slot.total_count = total_count;
+    slot.bitmap = bitmap;
+    return bitmap;
+}
+
+void
+InnerIdBitmapCache::Clear() {
+    std::unique_lock lock(this->mutex_);
+    for (auto& entry : this->entries_) {
+        entry = Entry();
+    }
+    ++this->generation_;
+}
+
+InnerIdBitmapFilterPtr
+InnerIdBitmapCache::translate(const BitsetPtr& bitset,
+                              Filter::BitsetSpace space,
+                              const LabelTable& label_table,
+                              InnerIdType total_count) const {
+    auto bitmap = std::make_shared<InnerIdBitmapFilter>(total_count, allocator_);
+    for (InnerIdType inner_id = 0; inner_id < total_count; ++inner_id) {
+        int64_t bit_index = inner_id;
+        if (space == Filter::BitsetSpace::LABEL) {
+            bit_index = label_table.GetLabelById(inner_id) & ROW_ID_MASK;
+        }
+        if (not bitset->Test(bit_index)) {
+            bitmap->SetValid(inner_id);
+        }
+    }
+    return bitmap;
+}
+
+}  // namespace vsag
@@ -0,0 +1,147 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <shared_mutex>
+
+#include "impl/tombstone_table.h"
+#include "label_table.h"
+#include "typing.h"
+#include "vsag/filter.h"
+
+namespace vsag {
+
+// a flat bitmap of valid inner ids, tested without virtual calls in the search hot loop
+class InnerIdBitmapFilter : public Filter {
+public:
+    InnerIdBitmapFilter(InnerIdType total_count, Allocator* allocator);
+
+    // a view of base that also rejects the ids that are not live in tombstones, the words of
+    //  base are shared and must not be changed any more
+    InnerIdBitmapFilter(const InnerIdBitmapFilter& base,
+                        TombstoneTablePtr tombstones,
+                        float live_ratio);
+
+    inline void
+    SetValid(InnerIdType inner_id) {
+        auto& word = (*bits_)[inner_id >> WORD_SHIFT];
+        auto mask = 1ULL << (inner_id & WORD_MASK);
+        valid_count_ += static_cast<uint64_t>((word & mask) == 0);
+        word |= mask;
+    }
+
+    // ids added after the translation are out of range and treated as invalid
+    inline bool
+    Test(InnerIdType inner_id) const {
+        return inner_id < total_count_ and
+               ((words_[inner_id >> WORD_SHIFT] >> (inner_id & WORD_MASK)) & 1ULL) != 0 and
+               (tombstones_ == nullptr or tombstones_->IsLive(inner_id));
+    }
+
+    [[nodiscard]] bool
+    CheckValid(int64_t inner_id) const override {
+        return inner_id >= 0 and this->Test(static_cast<InnerIdType>(inner_id));
+    }
+
+    [[nodiscard]] float
+    ValidRatio() const override {
+        if (total_count_ == 0) {
+            return 0.0F;
+        }
+        return static_cast<float>(valid_count_) / static_cast<float>(total_count_) *
+               live_ratio_;
+    }
+
+    [[nodiscard]] inline uint64_t
+    ValidCount() const {
+        return valid_count_;
+    }
+
+    [[nodiscard]] inline InnerIdType
+    TotalCount() const {
+        return total_count_;
+    }
+
+private:
+    static constexpr uint32_t WORD_SHIFT = 6;
+    static constexpr uint32_t WORD_MASK = 63;
+
+    std::shared_ptr<Vector<uint64_t>> bits_{nullptr};
+    const uint64_t* words_{nullptr};
+
+    InnerIdType total_count_{0};
+
+    uint64_t valid_count_{0};
+
+    TombstoneTablePtr tombstones_{nullptr};
+    float live_ratio_{1.0F};
+};
+
+using InnerIdBitmapFilterPtr = std::shared_ptr<InnerIdBitmapFilter>;
+
+// translates bitset filters into inner-id bitmaps and keeps the last few results,
+// keyed by bitset, filter version and index size
+class InnerIdBitmapCache {
+public:
+    explicit InnerIdBitmapCache(Allocator* allocator);
+
+    /**
+     * @brief get the inner-id bitmap of a bitset filter
+     *
+     * @return nullptr if the filter does not provide a bitset
+     */
+    InnerIdBitmapFilterPtr
+    Get(const FilterPtr& filter, const LabelTable& label_table, InnerIdType total_count);
+
+    /**
+     * @brief drop all cached bitmaps, called when the label of an inner id changes
+     */
+    void
+    Clear();
+
+private:
+    InnerIdBitmapFilterPtr
+    translate(const BitsetPtr& bitset,
+              Filter::BitsetSpace space,
+              const LabelTable& label_table,
+              InnerIdType total_count) const;
+
+private:
+    struct Entry {
+        BitsetPtr bitset{nullptr};
+        Filter::BitsetSpace space{Filter::BitsetSpace::NONE};
+        uint64_t version{0};
+        InnerIdType total_count{0};
+        InnerIdBitmapFilterPtr bitmap{nullptr};
+    };
+
+    Allocator* const allocator_{nullptr};
+
+    std::shared_mutex mutex_;
+
+    Vector<Entry> entries_;
+
+    uint64_t next_slot_{0};
+
+    // bumped by Clear, a translation that started before it is not cached
+    uint64_t generation_{0};
+
+    static constexpr uint64_t CACHE_SLOT_COUNT = 4;
+};
+
+using InnerIdBitmapCachePtr = std::shared_ptr<InnerIdBitmapCache>;
+
+}  // namespace vsag
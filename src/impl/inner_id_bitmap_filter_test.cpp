@@ -0,0 +1,152 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "inner_id_bitmap_filter.h"
+
+#include "base_filter_functor.h"
+#include "catch2/catch_test_macros.hpp"
+#include "default_allocator.h"
+
+using namespace vsag;
+
+class TestBitsetFilter : public Filter {
+public:
+    TestBitsetFilter(BitsetPtr bitset, BitsetSpace space) : bitset_(bitset), space_(space) {
+    }
+
+    [[nodiscard]] bool
+    CheckValid(int64_t id) const override {
+        return not bitset_->Test(id);
+    }
+
+    [[nodiscard]] BitsetPtr
+    InvalidBitset() const override {
+        return bitset_;
+    }
+
+    [[nodiscard]] BitsetSpace
+    InvalidBitsetSpace() const override {
+        return space_;
+    }
+
+    [[nodiscard]] uint64_t
+    Version() const override {
+        return version_;
+    }
+
+    uint64_t version_{0};
+
+private:
+    BitsetPtr bitset_;
+    BitsetSpace space_;
+};
+
+TEST_CASE("InnerIdBitmapFilter Basic Test", "[ut][InnerIdBitmapFilter]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    InnerIdType total_count = 1000;
+    InnerIdBitmapFilter bitmap(total_count, allocator.get());
+    for (InnerIdType i = 0; i < total_count; i += 3) {
+        bitmap.SetValid(i);
+        bitmap.SetValid(i);
+    }
+    for (InnerIdType i = 0; i < total_count; ++i) {
+        REQUIRE(bitmap.Test(i) == (i % 3 == 0));
+        REQUIRE(bitmap.CheckValid(i) == (i % 3 == 0));
+    }
+    REQUIRE(bitmap.ValidCount() == (total_count + 2) / 3);
+    REQUIRE_FALSE(bitmap.Test(total_count));
+    REQUIRE_FALSE(bitmap.CheckValid(-1));
+}
+
+TEST_CASE("InnerIdBitmapFilter Tombstone View Test", "[ut][InnerIdBitmapFilter]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    InnerIdType total_count = 1000;
+    InnerIdBitmapFilter bitmap(total_count, allocator.get());
+    for (InnerIdType i = 0; i < total_count; i += 3) {
+        bitmap.SetValid(i);
+    }
+    auto tombstones = std::make_shared<TombstoneTable>(total_count, allocator.get());
+    for (InnerIdType i = 0; i < total_count; i += 2) {
+        tombstones->Set(i, TombstoneTable::DELETED);
+    }
+    InnerIdBitmapFilter view(bitmap, tombstones, 0.5F);
+    for (InnerIdType i = 0; i < total_count; ++i) {
+        REQUIRE(view.Test(i) == (i % 3 == 0 and i % 2 != 0));
+        REQUIRE(bitmap.Test(i) == (i % 3 == 0));
+    }
+    REQUIRE(view.ValidRatio() == bitmap.ValidRatio() * 0.5F);
+
+    tombstones->Set(0, TombstoneTable::LIVE);
+    REQUIRE(view.Test(0));
+}
+
+TEST_CASE("InnerIdBitmapCache Translate Test", "[ut][InnerIdBitmapFilter]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    InnerIdType total_count = 500;
+    LabelTable label_table(allocator.get());
+    for (InnerIdType i = 0; i < total_count; ++i) {
+        label_table.Insert(i, static_cast<LabelType>(i) * 2 + 7);
+    }
+    auto bitset = Bitset::Make();
+    for (int64_t label = 0; label < total_count * 2 + 7; label += 5) {
+        bitset->Set(label);
+    }
+    InnerIdBitmapCache cache(allocator.get());
+
+    SECTION("not a bitset filter") {
+        auto filter = std::make_shared<TestBitsetFilter>(bitset, Filter::BitsetSpace::NONE);
+        REQUIRE(cache.Get(filter, label_table, total_count) == nullptr);
+        REQUIRE(cache.Get(nullptr, label_table, total_count) == nullptr);
+    }
+
+    SECTION("label space") {
+        auto filter = std::make_shared<TestBitsetFilter>(bitset, Filter::BitsetSpace::LABEL);
+        auto bitmap = cache.Get(filter, label_table, total_count);
+        REQUIRE(bitmap != nullptr);
+        for (InnerIdType i = 0; i < total_count; ++i) {
+            REQUIRE(bitmap->Test(i) == filter->CheckValid(label_table.GetLabelById(i)));
+        }
+        REQUIRE(cache.Get(filter, label_table, total_count) == bitmap);
+
+        bitset->Set(7);
+        filter->version_++;
+        auto new_bitmap = cache.Get(filter, label_table, total_count);
+        REQUIRE(new_bitmap != bitmap);
+        REQUIRE_FALSE(new_bitmap->Test(0));
+    }
+
+    SECTION("inner id space") {
+        auto filter = std::make_shared<TestBitsetFilter>(bitset, Filter::BitsetSpace::INNER_ID);
+        auto bitmap = cache.Get(filter, label_table, total_count);
+        REQUIRE(bitmap != nullptr);
+        for (InnerIdType i = 0; i < total_count; ++i) {
+            REQUIRE(bitmap->Test(i) == (i % 5 != 0));
+        }
+        REQUIRE(cache.Get(filter, label_table, total_count + 1) != bitmap);
+    }
+
+    SECTION("legacy bitset filter") {
+        auto filter = std::make_shared<UniqueFilter>(bitset);
+        REQUIRE(filter->InvalidBitset() == bitset);
+        REQUIRE(filter->InvalidBitsetSpace() == Filter::BitsetSpace::LABEL);
+        // the bitset may change between searches, it is tested per candidate instead
+        REQUIRE(filter->Version() == Filter::UNSTABLE_VERSION);
+        REQUIRE(cache.Get(filter, label_table, total_count) == nullptr);
+
+        auto function_filter = std::make_shared<UniqueFilter>([](int64_t) { return false; });
+        REQUIRE(function_filter->InvalidBitsetSpace() == Filter::BitsetSpace::NONE);
+        REQUIRE(cache.Get(function_filter, label_table, total_count) == nullptr);
+    }
+}
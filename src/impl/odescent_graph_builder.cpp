@@ -38,15 +38,10 @@ ODescent::Build(const Vector<InnerIdType>& ids_sequence, const GraphInterfacePtr
         graph_.push_back(Linklist(allocator_));
         return true;
     }
-    Vector<std::mutex>(data_num_, allocator_).swap(points_lock_);
-    Vector<UnorderedSet<uint32_t>> old_neighbors(allocator_);
-    Vector<UnorderedSet<uint32_t>> new_neighbors(allocator_);
-    old_neighbors.resize(data_num_, UnorderedSet<uint32_t>(allocator_));
-    new_neighbors.resize(data_num_, UnorderedSet<uint32_t>(allocator_));
-    for (int i = 0; i < data_num_; ++i) {
-        old_neighbors[i].reserve(odescent_param_->max_degree);
-        new_neighbors[i].reserve(odescent_param_->max_degree);
-    }
+    SampledCandidates old_neighbors(allocator_);
+    SampledCandidates new_neighbors(allocator_);
+    old_neighbors.Reset(data_num_, static_cast<uint32_t>(odescent_param_->max_degree * 2));
+    new_neighbors.Reset(data_num_, static_cast<uint32_t>(odescent_param_->max_degree * 2));
     init_graph(graph_storage);
     {
         for (int i = 0; i < odescent_param_->turn; ++i) {
@@ -117,93 +112,102 @@ ODescent::init_graph(const GraphInterfacePtr& graph_storage) {
 }
 
 void
-ODescent::update_neighbors(Vector<UnorderedSet<uint32_t>>& old_neighbors,
-                           Vector<UnorderedSet<uint32_t>>& new_neighbors) {
-    Vector<std::future<void>> futures(allocator_);
+ODescent::update_neighbors(SampledCandidates& old_neighbors, SampledCandidates& new_neighbors) {
+    Vector<NeighborUpdates> updates(task_count(), NeighborUpdates(allocator_), allocator_);
     auto task = [&, this](int64_t start, int64_t end) {
+        auto& local_updates = updates[start / odescent_param_->block_size];
+        // greast_neighbor_distance only changes in apply_updates, so it is read without a lock
+        auto try_update = [&](uint32_t loc, uint32_t neighbor_id, float dist) {
+            if (dist < graph_[loc].greast_neighbor_distance) {
+                local_updates.emplace_back(loc, Node(neighbor_id, dist));
+            }
+        };
         for (int64_t i = start; i < end; ++i) {
-            Vector<uint32_t> new_neighbors_candidates(allocator_);
-            for (uint32_t node_id : new_neighbors[i]) {
-                for (unsigned int neighbor_id : new_neighbors_candidates) {
+            auto new_count = new_neighbors.Seal(i);
+            auto old_count = old_neighbors.Seal(i);
+            const auto* new_ids = new_neighbors.Data(i);
+            const auto* old_ids = old_neighbors.Data(i);
+            for (uint32_t j = 0; j < new_count; ++j) {
+                uint32_t node_id = new_ids[j];
+                for (uint32_t k = 0; k < j; ++k) {
+                    uint32_t neighbor_id = new_ids[k];
                     float dist = get_distance(node_id, neighbor_id);
-                    if (dist < graph_[node_id].greast_neighbor_distance) {
-                        std::lock_guard<std::mutex> lock(points_lock_[node_id]);
-                        graph_[node_id].neighbors.emplace_back(neighbor_id, dist);
-                    }
-                    if (dist < graph_[neighbor_id].greast_neighbor_distance) {
-                        std::lock_guard<std::mutex> lock(points_lock_[neighbor_id]);
-                        graph_[neighbor_id].neighbors.emplace_back(node_id, dist);
-                    }
+                    try_update(node_id, neighbor_id, dist);
+                    try_update(neighbor_id, node_id, dist);
                 }
-                new_neighbors_candidates.push_back(node_id);
-
-                for (uint32_t neighbor_id : old_neighbors[i]) {
+                for (uint32_t k = 0; k < old_count; ++k) {
+                    uint32_t neighbor_id = old_ids[k];
                     if (node_id == neighbor_id) {
                         continue;
                     }
                     float dist = get_distance(neighbor_id, node_id);
-                    if (dist < graph_[node_id].greast_neighbor_distance) {
-                        std::lock_guard<std::mutex> lock(points_lock_[node_id]);
-                        graph_[node_id].neighbors.emplace_back(neighbor_id, dist);
-                    }
-                    if (dist < graph_[neighbor_id].greast_neighbor_distance) {
-                        std::lock_guard<std::mutex> lock(points_lock_[neighbor_id]);
-                        graph_[neighbor_id].neighbors.emplace_back(node_id, dist);
-                    }
+                    try_update(node_id, neighbor_id, dist);
+                    try_update(neighbor_id, node_id, dist);
                 }
             }
-            old_neighbors[i].clear();
-            new_neighbors[i].clear();
+            old_neighbors.Clear(i);
+            new_neighbors.Clear(i);
         }
+        std::sort(local_updates.begin(), local_updates.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
     };
     parallelize_task(task);
+    apply_updates(updates);
+}
 
-    auto resize_task = [&, this](int64_t start, int64_t end) {
-        for (uint32_t i = start; i < end; ++i) {
-            auto& neighbors = graph_[i].neighbors;
-            std::sort(neighbors.begin(), neighbors.end());
-            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
-            if (neighbors.size() > odescent_param_->max_degree) {
-                neighbors.resize(odescent_param_->max_degree);
+void
+ODescent::add_reverse_edges() {
+    Vector<NeighborUpdates> updates(task_count(), NeighborUpdates(allocator_), allocator_);
+    auto task = [&, this](int64_t start, int64_t end) {
+        auto& local_updates = updates[start / odescent_param_->block_size];
+        for (int64_t i = start; i < end; ++i) {
+            for (const auto& node : graph_[i].neighbors) {
+                local_updates.emplace_back(node.id, Node(i, node.distance));
             }
-            graph_[i].greast_neighbor_distance = neighbors.back().distance;
         }
+        std::sort(local_updates.begin(), local_updates.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
     };
-    parallelize_task(resize_task);
+    parallelize_task(task);
+    apply_updates(updates);
 }
 
 void
-ODescent::add_reverse_edges() {
-    Vector<Linklist> reverse_graph(allocator_);
-    reverse_graph.resize(data_num_, Linklist(allocator_));
-    for (int i = 0; i < data_num_; ++i) {
-        reverse_graph[i].neighbors.reserve(odescent_param_->max_degree);
-    }
-    for (int i = 0; i < data_num_; ++i) {
-        for (const auto& node : graph_[i].neighbors) {
-            reverse_graph[node.id].neighbors.emplace_back(i, node.distance);
-        }
-    }
-
+ODescent::apply_updates(Vector<NeighborUpdates>& updates) {
     auto task = [&, this](int64_t start, int64_t end) {
+        // every task owns the lists in [start, end) and picks their updates from all buffers
+        for (const auto& task_updates : updates) {
+            auto it = std::lower_bound(
+                task_updates.begin(),
+                task_updates.end(),
+                start,
+                [](const std::pair<uint32_t, Node>& update, int64_t loc) {
+                    return update.first < loc;
+                });
+            for (; it != task_updates.end() and it->first < end; ++it) {
+                graph_[it->first].neighbors.push_back(it->second);
+            }
+        }
         for (int64_t i = start; i < end; ++i) {
             auto& neighbors = graph_[i].neighbors;
-            neighbors.insert(neighbors.end(),
-                             reverse_graph[i].neighbors.begin(),
-                             reverse_graph[i].neighbors.end());
             std::sort(neighbors.begin(), neighbors.end());
             neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
             if (neighbors.size() > odescent_param_->max_degree) {
                 neighbors.resize(odescent_param_->max_degree);
             }
+            if (not neighbors.empty()) {
+                graph_[i].greast_neighbor_distance = neighbors.back().distance;
+            }
         }
     };
     parallelize_task(task);
 }
 
 void
-ODescent::sample_candidates(Vector<UnorderedSet<uint32_t>>& old_neighbors,
-                            Vector<UnorderedSet<uint32_t>>& new_neighbors,
+ODescent::sample_candidates(SampledCandidates& old_neighbors,
+                            SampledCandidates& new_neighbors,
                             float sample_rate) {
     auto task = [&, this](int64_t start, int64_t end) {
         LinearCongruentialGenerator r;
@@ -212,26 +216,10 @@ ODescent::sample_candidates(Vector<UnorderedSet<uint32_t>>& old_neighbors,
             for (auto& neighbor : neighbors) {
                 float current_state = r.NextFloat();
                 if (current_state < sample_rate) {
-                    if (neighbor.old) {
-                        {
-                            std::lock_guard<std::mutex> lock(points_lock_[i]);
-                            old_neighbors[i].insert(neighbor.id);
-                        }
-                        {
-                            std::lock_guard<std::mutex> inner_lock(points_lock_[neighbor.id]);
-                            old_neighbors[neighbor.id].insert(i);
-                        }
-                    } else {
-                        {
-                            std::lock_guard<std::mutex> lock(points_lock_[i]);
-                            new_neighbors[i].insert(neighbor.id);
-                        }
-                        {
-                            std::lock_guard<std::mutex> inner_lock(points_lock_[neighbor.id]);
-                            new_neighbors[neighbor.id].insert(i);
-                        }
-                        neighbor.old = true;
-                    }
+                    auto& candidates = neighbor.old ? old_neighbors : new_neighbors;
+                    candidates.Append(i, neighbor.id);
+                    candidates.Append(neighbor.id, i);
+                    neighbor.old = true;
                 }
             }
         }
@@ -285,10 +273,10 @@ ODescent::repair_no_in_edge() {
 
 void
 ODescent::prune_graph() {
-    Vector<int> in_edges_count(data_num_, 0, allocator_);
+    Vector<std::atomic<int>> in_edges_count(data_num_, allocator_);
     for (int i = 0; i < data_num_; ++i) {
         for (auto& neighbor : graph_[i].neighbors) {
-            in_edges_count[neighbor.id]++;
+            in_edges_count[neighbor.id].fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -302,20 +290,13 @@ ODescent::prune_graph() {
             candidates.reserve(odescent_param_->max_degree);
             for (auto& neighbor : neighbors) {
                 bool flag = true;
-                int cur_in_edge = 0;
-                {
-                    std::lock_guard<std::mutex> lock(points_lock_[neighbor.id]);
-                    cur_in_edge = in_edges_count[neighbor.id];
-                }
+                int cur_in_edge = in_edges_count[neighbor.id].load(std::memory_order_relaxed);
                 if (cur_in_edge > min_in_degree) {
                     for (auto& candidate : candidates) {
                         if (get_distance(neighbor.id, candidate.id) * odescent_param_->alpha <
                             neighbor.distance) {
                             flag = false;
-                            {
-                                std::lock_guard<std::mutex> lock(points_lock_[neighbor.id]);
-                                in_edges_count[neighbor.id]--;
-                            }
+                            in_edges_count[neighbor.id].fetch_sub(1, std::memory_order_relaxed);
                             break;
                         }
                     }
@@ -352,6 +333,23 @@ ODescent::parallelize_task(const std::function<void(int64_t, int64_t)>& task) {
     }
 }
 
+void
+SampledCandidates::Reset(int64_t data_num, uint32_t capacity) {
+    capacity_ = capacity;
+    ids_.resize(data_num * capacity);
+    Vector<std::atomic<uint32_t>>(data_num, ids_.get_allocator()).swap(counts_);
+}
+
+uint32_t
+SampledCandidates::Seal(uint32_t loc) {
+    auto count = std::min(counts_[loc].load(std::memory_order_relaxed), capacity_);
+    auto* begin = ids_.data() + static_cast<uint64_t>(loc) * capacity_;
+    std::sort(begin, begin + count);
+    count = static_cast<uint32_t>(std::unique(begin, begin + count) - begin);
+    counts_[loc].store(count, std::memory_order_relaxed);
+    return count;
+}
+
 void
 ODescent::SaveGraph(GraphInterfacePtr& graph_storage) {
     for (int i = 0; i < data_num_; ++i) {
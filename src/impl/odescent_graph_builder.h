@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <queue>
 #include <random>
@@ -76,6 +77,47 @@ struct Linklist {
     }
 };
 
+// sampled join candidates of all points, kept in one flat array with a fixed capacity per point;
+// Append is lock-free and drops the candidate when the list of the point is full
+class SampledCandidates {
+public:
+    explicit SampledCandidates(Allocator* allocator) : ids_(allocator), counts_(allocator) {
+    }
+
+    void
+    Reset(int64_t data_num, uint32_t capacity);
+
+    void
+    Append(uint32_t loc, uint32_t id) {
+        auto pos = counts_[loc].fetch_add(1, std::memory_order_relaxed);
+        if (pos < capacity_) {
+            ids_[static_cast<uint64_t>(loc) * capacity_ + pos] = id;
+        }
+    }
+
+    // sorts and deduplicates the list of loc, must not run concurrently with Append on loc
+    uint32_t
+    Seal(uint32_t loc);
+
+    [[nodiscard]] const uint32_t*
+    Data(uint32_t loc) const {
+        return ids_.data() + static_cast<uint64_t>(loc) * capacity_;
+    }
+
+    void
+    Clear(uint32_t loc) {
+        counts_[loc].store(0, std::memory_order_relaxed);
+    }
+
+private:
+    uint32_t capacity_{0};
+    Vector<uint32_t> ids_;
+    Vector<std::atomic<uint32_t>> counts_;
+};
+
+// (location of the point to update, new neighbor of that point)
+using NeighborUpdates = Vector<std::pair<uint32_t, Node>>;
+
 class ODescent {
 public:
     ODescent(ODescentParameterPtr odescent_parameter,
@@ -88,7 +130,6 @@ public:
           pruning_(pruning),
           allocator_(allocator),
           graph_(allocator),
-          points_lock_(allocator),
           thread_pool_(thread_pool) {
     }
 
@@ -127,17 +168,21 @@ private:
     init_graph(const GraphInterfacePtr& graph_storage);
 
     void
-    update_neighbors(Vector<UnorderedSet<uint32_t>>& old_neighbors,
-                     Vector<UnorderedSet<uint32_t>>& new_neighbors);
+    update_neighbors(SampledCandidates& old_neighbors, SampledCandidates& new_neighbors);
 
     void
     add_reverse_edges();
 
     void
-    sample_candidates(Vector<UnorderedSet<uint32_t>>& old_neighbors,
-                      Vector<UnorderedSet<uint32_t>>& new_neighbors,
+    sample_candidates(SampledCandidates& old_neighbors,
+                      SampledCandidates& new_neighbors,
                       float sample_rate);
 
+    // appends the updates buffered by every task to graph_, then sorts, deduplicates and
+    // truncates each touched list; every task's buffer must be sorted by location
+    void
+    apply_updates(Vector<NeighborUpdates>& updates);
+
     void
     repair_no_in_edge();
 
@@ -148,10 +193,14 @@ private:
     void
     parallelize_task(const std::function<void(int64_t i, int64_t end)>& task);
 
+    [[nodiscard]] int64_t
+    task_count() const {
+        return (data_num_ + odescent_param_->block_size - 1) / odescent_param_->block_size;
+    }
+
     size_t dim_;
     int64_t data_num_;
     Vector<Linklist> graph_;
-    Vector<std::mutex> points_lock_;
     SafeThreadPool* thread_pool_{nullptr};
 
     const InnerIdType* valid_ids_{nullptr};
@@ -17,6 +17,10 @@
 
 namespace vsag {
 
+// number of selected edges compared with a candidate per ComputePairCodes call, small enough to
+// keep the early exit of the heuristic
+static constexpr uint64_t PRUNE_BATCH_SIZE = 16;
+
 void
 select_edges_by_heuristic(MaxHeap& edges,
                           uint64_t max_size,
@@ -33,6 +37,18 @@ select_edges_by_heuristic(MaxHeap& edges,
         edges.pop();
     }
 
+    // the codes of the selected edges are copied once into a contiguous block, followed by the
+    // code of the current candidate, so no code is read twice and no virtual call is made per pair
+    const uint64_t code_size = flatten->code_size_;
+    bool use_codes = code_size > 0 and flatten->SupportPairCodes();
+    Vector<uint8_t> codes(allocator);
+    Vector<float> dists(allocator);
+    if (use_codes) {
+        codes.resize(max_size * code_size);
+        dists.resize(PRUNE_BATCH_SIZE);
+    }
+    uint8_t* current_codes = nullptr;
+
     while (not queue_closest.empty()) {
         if (return_list.size() >= max_size) {
             break;
@@ -42,11 +58,32 @@ select_edges_by_heuristic(MaxHeap& edges,
         queue_closest.pop();
         bool good = true;
 
-        for (const auto& second_pair : return_list) {
-            float curdist = flatten->ComputePairVectors(second_pair.second, current_pair.second);
-            if (curdist < float_query) {
-                good = false;
-                break;
+        if (use_codes) {
+            current_codes = codes.data() + return_list.size() * code_size;
+            use_codes = flatten->GetCodesById(current_pair.second, current_codes);
+        }
+        if (use_codes) {
+            for (uint64_t begin = 0; begin < return_list.size() and good;
+                 begin += PRUNE_BATCH_SIZE) {
+                auto count =
+                    std::min(PRUNE_BATCH_SIZE, static_cast<uint64_t>(return_list.size()) - begin);
+                flatten->ComputePairCodes(
+                    codes.data() + begin * code_size, count, current_codes, dists.data());
+                for (uint64_t i = 0; i < count; ++i) {
+                    if (dists[i] < float_query) {
+                        good = false;
+                        break;
+                    }
+                }
+            }
+        } else {
+            for (const auto& second_pair : return_list) {
+                float curdist =
+                    flatten->ComputePairVectors(second_pair.second, current_pair.second);
+                if (curdist < float_query) {
+                    good = false;
+                    break;
+                }
             }
         }
         if (good) {
@@ -82,28 +119,44 @@ mutually_connect_new_element(InnerIdType cur_c,
 
     InnerIdType next_closest_entry_point = selected_neighbors.back();
 
-    graph->InsertNeighborsById(cur_c, selected_neighbors);
+    {
+        LockGuard cur_lock(neighbors_mutexes, cur_c);
+        graph->InsertNeighborsById(cur_c, selected_neighbors);
+    }
 
+    Vector<InnerIdType> neighbors(allocator);
+    Vector<InnerIdType> current_neighbors(allocator);
+    Vector<InnerIdType> cand_neighbors(allocator);
     for (auto selected_neighbor : selected_neighbors) {
         if (selected_neighbor == cur_c) {
             throw std::runtime_error("Trying to connect an element to itself");
         }
 
-        LockGuard lock(neighbors_mutexes, selected_neighbor);
+        // copy-on-write: the pruned list is built from a private copy without holding the lock,
+        //  and written back only if no other insert has changed the list in the meantime
+        while (true) {
+            {
+                SharedLock lock(neighbors_mutexes, selected_neighbor);
+                graph->GetNeighbors(selected_neighbor, neighbors);
+            }
 
-        Vector<InnerIdType> neighbors(allocator);
-        graph->GetNeighbors(selected_neighbor, neighbors);
+            size_t sz_link_list_other = neighbors.size();
 
-        size_t sz_link_list_other = neighbors.size();
+            if (sz_link_list_other > max_size) {
+                throw std::runtime_error("Bad value of sz_link_list_other");
+            }
+            // If cur_c is already present in the neighboring connections of `selected_neighbors[idx]` then no need to modify any connections or run the heuristics.
+            if (sz_link_list_other < max_size) {
+                LockGuard lock(neighbors_mutexes, selected_neighbor);
+                graph->GetNeighbors(selected_neighbor, neighbors);
+                if (neighbors.size() < max_size) {
+                    neighbors.emplace_back(cur_c);
+                    graph->InsertNeighborsById(selected_neighbor, neighbors);
+                    break;
+                }
+                continue;
+            }
 
-        if (sz_link_list_other > max_size) {
-            throw std::runtime_error("Bad value of sz_link_list_other");
-        }
-        // If cur_c is already present in the neighboring connections of `selected_neighbors[idx]` then no need to modify any connections or run the heuristics.
-        if (sz_link_list_other < max_size) {
-            neighbors.emplace_back(cur_c);
-            graph->InsertNeighborsById(selected_neighbor, neighbors);
-        } else {
             // finding the "weakest" element to replace it with the new one
             float d_max = flatten->ComputePairVectors(cur_c, selected_neighbor);
 
@@ -117,12 +170,18 @@ mutually_connect_new_element(InnerIdType cur_c,
 
             select_edges_by_heuristic(candidates, max_size, flatten, allocator);
 
-            Vector<InnerIdType> cand_neighbors(allocator);
+            cand_neighbors.clear();
             while (not candidates.empty()) {
                 cand_neighbors.emplace_back(candidates.top().second);
                 candidates.pop();
             }
-            graph->InsertNeighborsById(selected_neighbor, cand_neighbors);
+
+            LockGuard lock(neighbors_mutexes, selected_neighbor);
+            graph->GetNeighbors(selected_neighbor, current_neighbors);
+            if (current_neighbors == neighbors) {
+                graph->InsertNeighborsById(selected_neighbor, cand_neighbors);
+                break;
+            }
         }
     }
     return next_closest_entry_point;
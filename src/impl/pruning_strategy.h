@@ -25,6 +25,12 @@
 
 namespace vsag {
 
+void
+select_edges_by_heuristic(MaxHeap& edges,
+                          uint64_t max_size,
+                          const FlattenInterfacePtr& flatten,
+                          Allocator* allocator);
+
 InnerIdType
 mutually_connect_new_element(InnerIdType cur_c,
                              MaxHeap& top_candidates,
@@ -0,0 +1,184 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "query_result_cache.h"
+
+#include <cstring>
+
+#include "dataset_impl.h"
+#include "utils/util_functions.h"
+#include "vsag/constants.h"
+
+namespace vsag {
+
+// the low mantissa bits dropped from every query component, queries within a relative
+//  difference of about 2^-15 per component share an entry
+static constexpr uint32_t QUERY_KEY_DROPPED_BITS = 8;
+
+static constexpr uint64_t HASH_PRIME = 0x100000001b3ULL;
+
+static inline uint64_t
+hash_combine(uint64_t hash, uint64_t value) {
+    return (hash ^ value) * HASH_PRIME;
+}
+
+bool
+QueryResultCache::Key::operator==(const Key& other) const {
+    return hash == other.hash and k == other.k and bitset == other.bitset and
+           space == other.space and filter_version == other.filter_version and
+           codes.size() == other.codes.size() and parameters == other.parameters and
+           std::memcmp(codes.data(), other.codes.data(), codes.size() * sizeof(uint32_t)) == 0;
+}
+
+QueryResultCache::QueryResultCache(uint64_t capacity, int64_t extra_info_size, Allocator* allocator)
+    : allocator_(allocator),
+      extra_info_size_(extra_info_size),
+      slot_count_(std::max<uint64_t>((capacity + STRIPE_COUNT - 1) / STRIPE_COUNT, 1)),
+      entries_(allocator),
+      next_slots_(STRIPE_COUNT, 0, allocator),
+      stripe_mutex_(std::make_shared<PointsMutex>(STRIPE_COUNT, allocator)) {
+    entries_.reserve(STRIPE_COUNT * slot_count_);
+    for (uint64_t i = 0; i < STRIPE_COUNT * slot_count_; ++i) {
+        entries_.emplace_back(allocator);
+    }
+}
+
+bool
+QueryResultCache::MakeKey(const DatasetPtr& query,
+                          int64_t k,
+                          const std::string& parameters,
+                          const FilterPtr& filter,
+                          Key& key) const {
+    if (query == nullptr or query->GetNumElements() != 1 or
+        query->GetFloat32Vectors() == nullptr or query->GetDim() <= 0) {
+        return false;
+    }
+    key.bitset = nullptr;
+    key.space = Filter::BitsetSpace::NONE;
+    key.filter_version = 0;
+    if (filter != nullptr) {
+        key.space = filter->InvalidBitsetSpace();
+        key.bitset = filter->InvalidBitset();
+        if (key.space == Filter::BitsetSpace::NONE or key.bitset == nullptr) {
+            return false;
+        }
+        key.filter_version = filter->Version();
+        if (key.filter_version == Filter::UNSTABLE_VERSION) {
+            return false;
+        }
+    }
+
+    const auto* vector = query->GetFloat32Vectors();
+    auto dim = static_cast<uint64_t>(query->GetDim());
+    key.codes.resize(dim);
+    std::memcpy(key.codes.data(), vector, dim * sizeof(float));
+    uint64_t hash = hash_combine(0, static_cast<uint64_t>(k));
+    for (auto& code : key.codes) {
+        code &= ~((1U << QUERY_KEY_DROPPED_BITS) - 1);
+        hash = hash_combine(hash, code);
+    }
+    key.k = k;
+    key.parameters = parameters;
+    hash = hash_combine(hash, std::hash<std::string>()(parameters));
+    hash = hash_combine(hash, reinterpret_cast<uint64_t>(key.bitset.get()));
+    key.hash = hash_combine(hash, key.filter_version);
+    return true;
+}
+
+DatasetPtr
+QueryResultCache::Get(const Key& key) {
+    auto stripe = key.hash % STRIPE_COUNT;
+    auto epoch = this->Epoch();
+    SharedLock lock(this->stripe_mutex_, stripe);
+    for (uint64_t i = 0; i < slot_count_; ++i) {
+        const auto& entry = this->slot(stripe, i);
+        if (not entry.used or entry.epoch != epoch or not(entry.key == key)) {
+            continue;
+        }
+        hit_count_.fetch_add(1, std::memory_order_relaxed);
+        if (entry.ids.empty()) {
+            return DatasetImpl::MakeEmptyDataset();
+        }
+        auto count = static_cast<int64_t>(entry.ids.size());
+        auto [dataset, dists, ids] = CreateFastDataset(count, allocator_);
+        std::memcpy(ids, entry.ids.data(), entry.ids.size() * sizeof(int64_t));
+        std::memcpy(dists, entry.dists.data(), entry.dists.size() * sizeof(float));
+        if (not entry.extra_infos.empty()) {
+            auto* extra_infos = static_cast<char*>(allocator_->Allocate(entry.extra_infos.size()));
+            std::memcpy(extra_infos, entry.extra_infos.data(), entry.extra_infos.size());
+            dataset->ExtraInfos(extra_infos);
+        }
+        return dataset;
+    }
+    miss_count_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void
+QueryResultCache::Put(const Key& key, uint64_t epoch, const DatasetPtr& result) {
+    if (result == nullptr or epoch != this->Epoch()) {
+        return;
+    }
+    auto stripe = key.hash % STRIPE_COUNT;
+    LockGuard lock(this->stripe_mutex_, stripe);
+    auto target = next_slots_[stripe];
+    bool replaced = true;
+    for (uint64_t i = 0; i < slot_count_; ++i) {
+        const auto& entry = this->slot(stripe, i);
+        if (entry.used and entry.key == key) {
+            target = i;
+            replaced = false;
+            break;
+        }
+    }
+    if (replaced) {
+        next_slots_[stripe] = (target + 1) % slot_count_;
+    }
+
+    auto& entry = this->slot(stripe, target);
+    entry.key.codes = key.codes;
+    entry.key.k = key.k;
+    entry.key.parameters = key.parameters;
+    entry.key.bitset = key.bitset;
+    entry.key.space = key.space;
+    entry.key.filter_version = key.filter_version;
+    entry.key.hash = key.hash;
+    entry.epoch = epoch;
+    entry.used = true;
+
+    auto count = static_cast<uint64_t>(std::max<int64_t>(result->GetDim(), 0));
+    if (result->GetIds() == nullptr or result->GetDistances() == nullptr) {
+        count = 0;
+    }
+    entry.ids.resize(count);
+    entry.dists.resize(count);
+    if (count > 0) {
+        std::memcpy(entry.ids.data(), result->GetIds(), count * sizeof(int64_t));
+        std::memcpy(entry.dists.data(), result->GetDistances(), count * sizeof(float));
+    }
+    entry.extra_infos.clear();
+    if (extra_info_size_ > 0 and count > 0 and result->GetExtraInfos() != nullptr) {
+        entry.extra_infos.resize(count * static_cast<uint64_t>(extra_info_size_));
+        std::memcpy(entry.extra_infos.data(), result->GetExtraInfos(), entry.extra_infos.size());
+    }
+}
+
+void
+QueryResultCache::ToJson(JsonType& json) const {
+    json[STATSTIC_QUERY_CACHE_HIT] = this->HitCount();
+    json[STATSTIC_QUERY_CACHE_MISS] = this->MissCount();
+}
+
+}  // namespace vsag
@@ -0,0 +1,175 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+
+#include "lock_strategy.h"
+#include "typing.h"
+#include "vsag/dataset.h"
+#include "vsag/filter.h"
+
+namespace vsag {
+
+/**
+ * @brief a bounded cache of knn results shared by repeated and near-duplicate queries
+ *
+ * A search is keyed by its query with the lowest mantissa bits of every component dropped,
+ * k, the search parameters and the bitset of its filter; searches whose filter has no
+ * bitset are not cached, their validity cannot be versioned. The entries are spread over
+ * lock stripes by key hash and a full stripe replaces its oldest entry. Every change to
+ * the index bumps the epoch, entries cached in an older epoch are never returned.
+ */
+class QueryResultCache {
+public:
+    class Key {
+    public:
+        explicit Key(Allocator* allocator) : codes(allocator) {
+        }
+
+        bool
+        operator==(const Key& other) const;
+
+    public:
+        Vector<uint32_t> codes;
+        int64_t k{0};
+        std::string parameters;
+        BitsetPtr bitset{nullptr};
+        Filter::BitsetSpace space{Filter::BitsetSpace::NONE};
+        uint64_t filter_version{0};
+        uint64_t hash{0};
+    };
+
+    // bumps the epoch once it goes out of scope, held by every change to the index so that
+    //  an exception halfway through still invalidates the cache
+    class InvalidateGuard {
+    public:
+        explicit InvalidateGuard(QueryResultCache* cache) : cache_(cache) {
+        }
+
+        InvalidateGuard(const InvalidateGuard&) = delete;
+
+        InvalidateGuard&
+        operator=(const InvalidateGuard&) = delete;
+
+        ~InvalidateGuard() {
+            if (cache_ != nullptr) {
+                cache_->Invalidate();
+            }
+        }
+
+    private:
+        QueryResultCache* const cache_{nullptr};
+    };
+
+    QueryResultCache(uint64_t capacity, int64_t extra_info_size, Allocator* allocator);
+
+    /**
+     * @brief fill the key of a knn search
+     *
+     * @return false if the search is not cacheable: not a single float32 query, or a
+     *         filter that does not provide a bitset
+     */
+    [[nodiscard]] bool
+    MakeKey(const DatasetPtr& query,
+            int64_t k,
+            const std::string& parameters,
+            const FilterPtr& filter,
+            Key& key) const;
+
+    /**
+     * @brief get a copy of the cached result, nullptr on a miss
+     */
+    [[nodiscard]] DatasetPtr
+    Get(const Key& key);
+
+    /**
+     * @brief cache the result of a search that started in the given epoch
+     */
+    void
+    Put(const Key& key, uint64_t epoch, const DatasetPtr& result);
+
+    [[nodiscard]] inline uint64_t
+    Epoch() const {
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief called after every change to the index, drops all cached results lazily
+     */
+    inline void
+    Invalidate() {
+        epoch_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    [[nodiscard]] inline uint64_t
+    HitCount() const {
+        return hit_count_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] inline uint64_t
+    MissCount() const {
+        return miss_count_.load(std::memory_order_relaxed);
+    }
+
+    void
+    ToJson(JsonType& json) const;
+
+private:
+    struct Entry {
+        explicit Entry(Allocator* allocator)
+            : key(allocator), ids(allocator), dists(allocator), extra_infos(allocator) {
+        }
+
+        Key key;
+        uint64_t epoch{0};
+        bool used{false};
+        Vector<int64_t> ids;
+        Vector<float> dists;
+        Vector<char> extra_infos;
+    };
+
+    // stripe s owns the slots [s * slot_count_, (s + 1) * slot_count_)
+    Entry&
+    slot(uint64_t stripe, uint64_t index) {
+        return entries_[stripe * slot_count_ + index];
+    }
+
+private:
+    static constexpr uint64_t STRIPE_COUNT = 16;
+
+    Allocator* const allocator_{nullptr};
+
+    const int64_t extra_info_size_{0};
+
+    uint64_t slot_count_{0};
+
+    Vector<Entry> entries_;
+
+    // the next slot to replace in every stripe
+    Vector<uint64_t> next_slots_;
+
+    MutexArrayPtr stripe_mutex_{nullptr};
+
+    std::atomic<uint64_t> epoch_{0};
+
+    std::atomic<uint64_t> hit_count_{0};
+    std::atomic<uint64_t> miss_count_{0};
+};
+
+using QueryResultCachePtr = std::shared_ptr<QueryResultCache>;
+
+}  // namespace vsag
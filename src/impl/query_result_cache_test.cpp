@@ -0,0 +1,172 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "query_result_cache.h"
+
+#include "base_filter_functor.h"
+#include "catch2/catch_test_macros.hpp"
+#include "default_allocator.h"
+#include "utils/util_functions.h"
+#include "vsag/bitset.h"
+
+using namespace vsag;
+
+namespace {
+
+class BitsetFilter : public Filter {
+public:
+    explicit BitsetFilter(BitsetPtr bitset) : bitset_(std::move(bitset)) {
+    }
+
+    [[nodiscard]] bool
+    CheckValid(int64_t id) const override {
+        return not bitset_->Test(id);
+    }
+
+    [[nodiscard]] BitsetPtr
+    InvalidBitset() const override {
+        return bitset_;
+    }
+
+    [[nodiscard]] BitsetSpace
+    InvalidBitsetSpace() const override {
+        return BitsetSpace::LABEL;
+    }
+
+    [[nodiscard]] uint64_t
+    Version() const override {
+        return version;
+    }
+
+    uint64_t version{0};
+
+private:
+    BitsetPtr bitset_;
+};
+
+DatasetPtr
+make_query(std::vector<float>& vector) {
+    auto query = Dataset::Make();
+    query->NumElements(1)
+        ->Dim(static_cast<int64_t>(vector.size()))
+        ->Float32Vectors(vector.data())
+        ->Owner(false);
+    return query;
+}
+
+DatasetPtr
+make_result(int64_t first_id, int64_t count, Allocator* allocator) {
+    auto [dataset, dists, ids] = CreateFastDataset(count, allocator);
+    for (int64_t i = 0; i < count; ++i) {
+        ids[i] = first_id + i;
+        dists[i] = static_cast<float>(i);
+    }
+    return dataset;
+}
+
+}  // namespace
+
+TEST_CASE("QueryResultCache Hit And Invalidate Test", "[ut][QueryResultCache]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    QueryResultCache cache(32, 0, allocator.get());
+    std::vector<float> vector{0.5F, 1.25F, -3.0F, 7.0F};
+    auto query = make_query(vector);
+
+    QueryResultCache::Key key(allocator.get());
+    REQUIRE(cache.MakeKey(query, 3, "{}", nullptr, key));
+    REQUIRE(cache.Get(key) == nullptr);
+    auto epoch = cache.Epoch();
+    cache.Put(key, epoch, make_result(100, 3, allocator.get()));
+
+    auto cached = cache.Get(key);
+    REQUIRE(cached != nullptr);
+    REQUIRE(cached->GetDim() == 3);
+    for (int64_t i = 0; i < 3; ++i) {
+        REQUIRE(cached->GetIds()[i] == 100 + i);
+        REQUIRE(cached->GetDistances()[i] == static_cast<float>(i));
+    }
+
+    // a near-duplicate query shares the entry, another k or parameters do not
+    std::vector<float> near{0.5F * (1.0F + 1e-6F), 1.25F, -3.0F, 7.0F};
+    QueryResultCache::Key near_key(allocator.get());
+    REQUIRE(cache.MakeKey(make_query(near), 3, "{}", nullptr, near_key));
+    REQUIRE(cache.Get(near_key) != nullptr);
+    QueryResultCache::Key other_key(allocator.get());
+    REQUIRE(cache.MakeKey(query, 4, "{}", nullptr, other_key));
+    REQUIRE(cache.Get(other_key) == nullptr);
+    REQUIRE(cache.MakeKey(query, 3, R"({"ef": 1})", nullptr, other_key));
+    REQUIRE(cache.Get(other_key) == nullptr);
+
+    // a search that started before a change is not cached
+    cache.Invalidate();
+    REQUIRE(cache.Get(key) == nullptr);
+    cache.Put(key, epoch, make_result(200, 3, allocator.get()));
+    REQUIRE(cache.Get(key) == nullptr);
+    {
+        QueryResultCache::InvalidateGuard guard(&cache);
+        cache.Put(key, cache.Epoch(), make_result(300, 2, allocator.get()));
+        REQUIRE(cache.Get(key)->GetIds()[0] == 300);
+    }
+    REQUIRE(cache.Get(key) == nullptr);
+
+    REQUIRE(cache.HitCount() == 3);
+    REQUIRE(cache.MissCount() == 6);
+    JsonType stats;
+    cache.ToJson(stats);
+    REQUIRE(stats[STATSTIC_QUERY_CACHE_HIT] == 3);
+}
+
+TEST_CASE("QueryResultCache Filter And Capacity Test", "[ut][QueryResultCache]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    QueryResultCache cache(16, 0, allocator.get());
+    std::vector<float> vector{1.0F, 2.0F};
+    auto query = make_query(vector);
+
+    // only bitset filters carry a version the cache can key on
+    QueryResultCache::Key key(allocator.get());
+    auto function_filter = std::make_shared<UniqueFilter>([](int64_t id) { return id > 0; });
+    REQUIRE_FALSE(cache.MakeKey(query, 1, "{}", function_filter, key));
+
+    auto bitset = Bitset::Make();
+    auto legacy_filter = std::make_shared<UniqueFilter>(bitset);
+    REQUIRE_FALSE(cache.MakeKey(query, 1, "{}", legacy_filter, key));
+    auto filter = std::make_shared<BitsetFilter>(bitset);
+    REQUIRE(cache.MakeKey(query, 1, "{}", filter, key));
+    cache.Put(key, cache.Epoch(), make_result(1, 1, allocator.get()));
+    REQUIRE(cache.Get(key) != nullptr);
+    filter->version = 1;
+    QueryResultCache::Key changed_key(allocator.get());
+    REQUIRE(cache.MakeKey(query, 1, "{}", filter, changed_key));
+    REQUIRE(cache.Get(changed_key) == nullptr);
+
+    // one slot per stripe, an older entry of the same stripe is replaced
+    uint64_t hits = 0;
+    for (int64_t k = 1; k <= 64; ++k) {
+        QueryResultCache::Key k_key(allocator.get());
+        REQUIRE(cache.MakeKey(query, k, "{}", nullptr, k_key));
+        cache.Put(k_key, cache.Epoch(), make_result(k, 1, allocator.get()));
+    }
+    for (int64_t k = 1; k <= 64; ++k) {
+        QueryResultCache::Key k_key(allocator.get());
+        REQUIRE(cache.MakeKey(query, k, "{}", nullptr, k_key));
+        auto cached = cache.Get(k_key);
+        if (cached != nullptr) {
+            REQUIRE(cached->GetIds()[0] == k);
+            ++hits;
+        }
+    }
+    REQUIRE(hits <= 16);
+    REQUIRE(hits > 0);
+}
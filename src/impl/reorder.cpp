@@ -0,0 +1,54 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "reorder.h"
+
+namespace vsag {
+
+void
+reorder_candidates(const float* query,
+                   const FlattenInterfacePtr& flatten,
+                   MaxHeap& candidates,
+                   int64_t k,
+                   Allocator* allocator) {
+    uint64_t size = candidates.size();
+    if (size == 0) {
+        return;
+    }
+    uint64_t topk = size;
+    if (k > 0 and static_cast<uint64_t>(k) < size) {
+        topk = static_cast<uint64_t>(k);
+    }
+    Vector<InnerIdType> ids(size, allocator);
+    Vector<float> dists(size, allocator);
+    uint64_t idx = 0;
+    while (not candidates.empty()) {
+        ids[idx] = candidates.top().second;
+        ++idx;
+        candidates.pop();
+    }
+    auto computer = flatten->FactoryComputer(query);
+    flatten->Query(dists.data(), computer, ids.data(), size);
+    for (uint64_t i = 0; i < size; ++i) {
+        if (candidates.size() < topk or dists[i] <= candidates.top().first) {
+            candidates.emplace(dists[i], ids[i]);
+            if (candidates.size() > topk) {
+                candidates.pop();
+            }
+        }
+    }
+}
+
+}  // namespace vsag
@@ -0,0 +1,38 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "data_cell/flatten_interface.h"
+#include "typing.h"
+#include "vsag/allocator.h"
+
+namespace vsag {
+
+/**
+ * @brief recompute the distances of the candidates with the codes of flatten and keep the
+ *        k closest (all of them when k <= 0)
+ *
+ * All candidates are computed by one batched query, so codes that are not in memory are
+ * fetched by a single MultiRead instead of one read per candidate.
+ */
+void
+reorder_candidates(const float* query,
+                   const FlattenInterfacePtr& flatten,
+                   MaxHeap& candidates,
+                   int64_t k,
+                   Allocator* allocator);
+
+}  // namespace vsag
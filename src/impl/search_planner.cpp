@@ -0,0 +1,83 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "search_planner.h"
+
+#include <algorithm>
+
+#include "impl/inner_id_bitmap_filter.h"
+#include "vsag/constants.h"
+
+namespace vsag {
+
+float
+SearchPlanner::EstimateValidRatio(const FilterPtr& inner_filter) {
+    if (inner_filter == nullptr) {
+        return 1.0F;
+    }
+    return std::clamp(inner_filter->ValidRatio(), 0.0F, 1.0F);
+}
+
+double
+SearchPlanner::GraphSearchCost(uint64_t ef,
+                               uint64_t max_degree,
+                               float valid_ratio,
+                               uint64_t total_count) {
+    // roughly ef / valid_ratio nodes are expanded before ef valid candidates are found,
+    //  and a search never computes more distances than the whole index
+    auto total = static_cast<double>(std::max<uint64_t>(total_count, 1));
+    auto ratio = std::max(static_cast<double>(valid_ratio), 1.0 / total);
+    auto cost = static_cast<double>(ef) * static_cast<double>(max_degree) / ratio;
+    return std::min(cost, static_cast<double>(total_count));
+}
+
+double
+SearchPlanner::ExactScanCost(const FilterPtr& inner_filter,
+                             float valid_ratio,
+                             uint64_t total_count) {
+    auto check_cost = FILTER_CHECK_COST;
+    if (dynamic_cast<const InnerIdBitmapFilter*>(inner_filter.get()) != nullptr) {
+        check_cost = BITMAP_CHECK_COST;
+    }
+    auto total = static_cast<double>(total_count);
+    return total * static_cast<double>(valid_ratio) + total * check_cost;
+}
+
+SearchPlan
+SearchPlanner::Plan(const FilterPtr& inner_filter,
+                    float valid_ratio,
+                    double approximate_cost,
+                    double exact_cost,
+                    bool support_expansion) {
+    if (inner_filter == nullptr or valid_ratio >= 1.0F) {
+        return SearchPlan::GRAPH_SEARCH;
+    }
+    if (exact_cost <= approximate_cost) {
+        return SearchPlan::EXACT_SCAN;
+    }
+    if (support_expansion and valid_ratio < FILTERED_EXPANSION_RATIO) {
+        return SearchPlan::FILTERED_EXPANSION;
+    }
+    return SearchPlan::GRAPH_SEARCH;
+}
+
+void
+SearchPlanStats::ToJson(JsonType& json) const {
+    json[STATSTIC_SEARCH_PLAN_GRAPH] = this->Count(SearchPlan::GRAPH_SEARCH);
+    json[STATSTIC_SEARCH_PLAN_FILTERED_EXPANSION] = this->Count(SearchPlan::FILTERED_EXPANSION);
+    json[STATSTIC_SEARCH_PLAN_EXACT_SCAN] = this->Count(SearchPlan::EXACT_SCAN);
+}
+
+}  // namespace vsag
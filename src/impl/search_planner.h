@@ -0,0 +1,89 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "typing.h"
+#include "vsag/filter.h"
+
+namespace vsag {
+
+enum class SearchPlan {
+    GRAPH_SEARCH = 0,        // normal traversal, invalid nodes are only skipped randomly
+    FILTERED_EXPANSION = 1,  // traversal that looks through invalid neighbors to their neighbors
+    EXACT_SCAN = 2,          // compute the distance of every valid vector
+};
+
+// chooses the search strategy of a filtered query by comparing the estimated number of
+//  distance computations (in units of one distance) of each strategy
+class SearchPlanner {
+public:
+    /**
+     * @brief estimate the ratio of valid vectors, a bitmap filter gives the exact ratio
+     */
+    static float
+    EstimateValidRatio(const FilterPtr& inner_filter);
+
+    /**
+     * @brief the cost of a graph search which keeps ef valid candidates
+     */
+    static double
+    GraphSearchCost(uint64_t ef, uint64_t max_degree, float valid_ratio, uint64_t total_count);
+
+    /**
+     * @brief the cost of checking every id and computing the distance of the valid ones
+     */
+    static double
+    ExactScanCost(const FilterPtr& inner_filter, float valid_ratio, uint64_t total_count);
+
+    static SearchPlan
+    Plan(const FilterPtr& inner_filter,
+         float valid_ratio,
+         double approximate_cost,
+         double exact_cost,
+         bool support_expansion);
+
+public:
+    // below this valid ratio a graph search uses the filtered neighbor expansion
+    static constexpr float FILTERED_EXPANSION_RATIO = 0.1F;
+
+    // the cost of a virtual CheckValid (with label lookup) and of a bitmap probe
+    static constexpr double FILTER_CHECK_COST = 0.1;
+    static constexpr double BITMAP_CHECK_COST = 0.01;
+};
+
+class SearchPlanStats {
+public:
+    void
+    Record(SearchPlan plan) {
+        counts_[static_cast<uint64_t>(plan)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t
+    Count(SearchPlan plan) const {
+        return counts_[static_cast<uint64_t>(plan)].load(std::memory_order_relaxed);
+    }
+
+    void
+    ToJson(JsonType& json) const;
+
+private:
+    std::atomic<uint64_t> counts_[3]{};
+};
+
+}  // namespace vsag
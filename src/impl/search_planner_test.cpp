@@ -0,0 +1,87 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "search_planner.h"
+
+#include "catch2/catch_test_macros.hpp"
+#include "default_allocator.h"
+#include "impl/inner_id_bitmap_filter.h"
+#include "vsag/constants.h"
+
+using namespace vsag;
+
+class RatioFilter : public Filter {
+public:
+    explicit RatioFilter(float ratio) : ratio_(ratio) {
+    }
+
+    [[nodiscard]] bool
+    CheckValid(int64_t id) const override {
+        return true;
+    }
+
+    [[nodiscard]] float
+    ValidRatio() const override {
+        return ratio_;
+    }
+
+private:
+    float ratio_;
+};
+
+TEST_CASE("SearchPlanner Plan Test", "[ut][SearchPlanner]") {
+    uint64_t total = 1000000;
+    uint64_t ef = 100;
+    uint64_t degree = 32;
+
+    auto plan_of = [&](const FilterPtr& filter) {
+        auto ratio = SearchPlanner::EstimateValidRatio(filter);
+        return SearchPlanner::Plan(filter,
+                                   ratio,
+                                   SearchPlanner::GraphSearchCost(ef, degree, ratio, total),
+                                   SearchPlanner::ExactScanCost(filter, ratio, total),
+                                   true);
+    };
+
+    REQUIRE(plan_of(nullptr) == SearchPlan::GRAPH_SEARCH);
+    REQUIRE(plan_of(std::make_shared<RatioFilter>(1.0F)) == SearchPlan::GRAPH_SEARCH);
+    REQUIRE(plan_of(std::make_shared<RatioFilter>(0.5F)) == SearchPlan::GRAPH_SEARCH);
+    REQUIRE(plan_of(std::make_shared<RatioFilter>(0.05F)) == SearchPlan::FILTERED_EXPANSION);
+    REQUIRE(plan_of(std::make_shared<RatioFilter>(0.0001F)) == SearchPlan::EXACT_SCAN);
+    REQUIRE(plan_of(std::make_shared<RatioFilter>(0.0F)) == SearchPlan::EXACT_SCAN);
+
+    // a graph search never costs more than the whole index
+    REQUIRE(SearchPlanner::GraphSearchCost(ef, degree, 0.0F, total) <= static_cast<double>(total));
+
+    // probing a bitmap is cheaper than calling a filter
+    auto allocator = std::make_shared<DefaultAllocator>();
+    auto bitmap = std::make_shared<InnerIdBitmapFilter>(100, allocator.get());
+    REQUIRE(SearchPlanner::ExactScanCost(bitmap, 0.0F, total) <
+            SearchPlanner::ExactScanCost(std::make_shared<RatioFilter>(0.0F), 0.0F, total));
+}
+
+TEST_CASE("SearchPlanStats Test", "[ut][SearchPlanner]") {
+    SearchPlanStats stats;
+    stats.Record(SearchPlan::GRAPH_SEARCH);
+    stats.Record(SearchPlan::EXACT_SCAN);
+    stats.Record(SearchPlan::EXACT_SCAN);
+    REQUIRE(stats.Count(SearchPlan::GRAPH_SEARCH) == 1);
+    REQUIRE(stats.Count(SearchPlan::FILTERED_EXPANSION) == 0);
+    REQUIRE(stats.Count(SearchPlan::EXACT_SCAN) == 2);
+
+    JsonType json;
+    stats.ToJson(json);
+    REQUIRE(json[STATSTIC_SEARCH_PLAN_EXACT_SCAN].get<uint64_t>() == 2);
+}
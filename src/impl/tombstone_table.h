@@ -0,0 +1,82 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "typing.h"
+#include "vsag/allocator.h"
+
+namespace vsag {
+
+/**
+ * @brief the deletion state of every inner id, read by searches without a lock
+ *
+ * The capacity is fixed: a resize publishes a larger copy, and searches that still hold the
+ * old table keep reading it. Ids beyond the capacity were added after the table was copied
+ * and are reported as live.
+ */
+class TombstoneTable {
+public:
+    static constexpr uint8_t LIVE = 0;
+    static constexpr uint8_t DELETED = 1;  // removed but still linked in the graph
+    static constexpr uint8_t FREED = 2;    // unlinked from the graph, the slot can be reused
+
+    TombstoneTable(uint64_t capacity, Allocator* allocator) : states_(capacity, allocator) {
+    }
+
+    // a table of new_capacity that starts with the states of other
+    TombstoneTable(const TombstoneTable& other, uint64_t new_capacity, Allocator* allocator)
+        : states_(new_capacity, allocator) {
+        auto count = std::min(other.Capacity(), new_capacity);
+        for (uint64_t i = 0; i < count; ++i) {
+            states_[i].store(other.states_[i].load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] inline uint8_t
+    Get(InnerIdType inner_id) const {
+        if (inner_id >= states_.size()) {
+            return LIVE;
+        }
+        return states_[inner_id].load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] inline bool
+    IsLive(InnerIdType inner_id) const {
+        return this->Get(inner_id) == LIVE;
+    }
+
+    inline void
+    Set(InnerIdType inner_id, uint8_t state) {
+        states_[inner_id].store(state, std::memory_order_release);
+    }
+
+    [[nodiscard]] inline uint64_t
+    Capacity() const {
+        return states_.size();
+    }
+
+private:
+    Vector<std::atomic<uint8_t>> states_;
+};
+
+using TombstoneTablePtr = std::shared_ptr<TombstoneTable>;
+
+}  // namespace vsag
@@ -17,7 +17,9 @@
 
 #include <local_file_reader.h>
 
+#include <cstdio>
 #include <exception>
+#include <fstream>
 #include <functional>
 #include <future>
 #include <iterator>
@@ -37,6 +39,7 @@
 #include "vsag/constants.h"
 #include "vsag/errors.h"
 #include "vsag/expected.hpp"
+#include "vsag/factory.h"
 #include "vsag/index.h"
 #include "vsag/readerset.h"
 
@@ -55,6 +58,8 @@ const static std::string BUILD_STATUS = "status";
 const static std::string BUILD_CURRENT_ROUND = "round";
 const static std::string BUILD_NODES = "builded_nodes";
 const static std::string BUILD_FAILED_LOC = "failed_loc";
+const static std::string OUT_OF_CORE_BASE_SUFFIX = ".base.tmp";
+const static std::string OUT_OF_CORE_GRAPH_SUFFIX = ".graph.tmp";
 
 template <typename T>
 Binary
@@ -141,6 +146,42 @@ convert_binary_to_stream(const Binary& binary, std::stringstream& stream) {
     }
 }
 
+Binary
+convert_file_to_binary(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (not file.is_open()) {
+        throw VsagException(ErrorType::READ_ERROR, fmt::format("failed to open file: {}", path));
+    }
+    auto size = static_cast<std::streamsize>(file.tellg());
+    std::shared_ptr<int8_t[]> binary_data(new int8_t[size]);
+    file.seekg(0, std::ios::beg);
+    file.read((char*)binary_data.get(), size);
+    Binary binary{
+        .data = binary_data,
+        .size = (size_t)size,
+    };
+    return binary;
+}
+
+// removes the intermediate files of an out-of-core build, also when the build throws
+class TemporaryFiles {
+public:
+    ~TemporaryFiles() {
+        for (const auto& path : paths_) {
+            std::remove(path.c_str());
+        }
+    }
+
+    std::string
+    Add(const std::string& path) {
+        paths_.emplace_back(path);
+        return path;
+    }
+
+private:
+    std::vector<std::string> paths_;
+};
+
 DiskANN::DiskANN(DiskannParameters& diskann_params, const IndexCommonParam& index_common_param)
     : metric_(diskann_params.metric),
       L_(static_cast<int32_t>(diskann_params.ef_construction)),
@@ -227,8 +268,17 @@ DiskANN::build(const DatasetPtr& base) {
         const auto* ids = base->GetIds();
         auto data_num = base->GetNumElements();
 
+        const auto& layout_path = diskann_params_.layout_path;
+        bool out_of_core = diskann_params_.build_memory_budget > 0;
+        TemporaryFiles temporary_files;
+        std::string graph_path;
+
         std::vector<size_t> failed_locs;
-        if (diskann_params_.graph_type == GRAPH_TYPE_ODESCENT) {
+        if (out_of_core) {
+            SlowTaskTimer t("diskann build full (out-of-core graph)");
+            graph_path = temporary_files.Add(layout_path + OUT_OF_CORE_GRAPH_SUFFIX);
+            this->build_merged_graph(vectors, ids, data_num, graph_path, temporary_files);
+        } else if (diskann_params_.graph_type == GRAPH_TYPE_ODESCENT) {
             SlowTaskTimer t("odescent build full (graph)");
             FlattenDataCellParamPtr flatten_param =
                 std::make_shared<vsag::FlattenDataCellParameter>();
@@ -285,14 +335,45 @@ DiskANN::build(const DatasetPtr& base) {
         }
         {
             SlowTaskTimer t("diskann build full (disk layout)");
-            diskann::create_disk_layout<float>(vectors,
-                                               data_num,
-                                               data_dim,
-                                               failed_locs,
-                                               graph_stream_,
-                                               disk_layout_stream_,
-                                               sector_len_,
-                                               metric_);
+            if (layout_path.empty()) {
+                diskann::create_disk_layout<float>(vectors,
+                                                   data_num,
+                                                   data_dim,
+                                                   failed_locs,
+                                                   graph_stream_,
+                                                   disk_layout_stream_,
+                                                   sector_len_,
+                                                   metric_);
+            } else {
+                // the layout is written sector by sector, only one sector stays in memory
+                std::ifstream graph_file;
+                std::istream* graph_reader = &graph_stream_;
+                if (out_of_core) {
+                    graph_file.open(graph_path, std::ios::binary);
+                    graph_reader = &graph_file;
+                }
+                std::ofstream layout_file(layout_path, std::ios::binary | std::ios::trunc);
+                if (not layout_file.is_open()) {
+                    throw VsagException(ErrorType::INTERNAL_ERROR,
+                                        fmt::format("failed to open file: {}", layout_path));
+                }
+                diskann::create_disk_layout<float>(vectors,
+                                                   data_num,
+                                                   data_dim,
+                                                   failed_locs,
+                                                   *graph_reader,
+                                                   layout_file,
+                                                   sector_len_,
+                                                   metric_);
+                layout_file.seekp(0, std::ios::end);
+                layout_size_ = static_cast<uint64_t>(layout_file.tellp());
+                layout_file.close();
+                if (out_of_core and preload_) {
+                    graph_file.clear();
+                    graph_file.seekg(0, std::ios::beg);
+                    graph_stream_ << graph_file.rdbuf();
+                }
+            }
         }
 
         std::vector<int64_t> failed_ids;
@@ -301,7 +382,12 @@ DiskANN::build(const DatasetPtr& base) {
                        std::back_inserter(failed_ids),
                        [&ids](const auto& index) { return ids[index]; });
 
-        disk_layout_reader_ = std::make_shared<LocalMemoryReader>(disk_layout_stream_);
+        if (layout_path.empty()) {
+            disk_layout_reader_ = std::make_shared<LocalMemoryReader>(disk_layout_stream_);
+        } else {
+            disk_layout_reader_ = Factory::CreateLocalFileReader(
+                layout_path, 0, static_cast<int64_t>(layout_size_));
+        }
         reader_.reset(new LocalFileReader(batch_read_));
         index_.reset(new diskann::PQFlashIndex<float, int64_t>(
             reader_, metric_, sector_len_, dim_, use_bsa_));
@@ -635,7 +721,11 @@ DiskANN::serialize() const {
 
         bs.Set(DISKANN_PQ, convert_stream_to_binary(pq_pivots_stream_));
         bs.Set(DISKANN_COMPRESSED_VECTOR, convert_stream_to_binary(disk_pq_compressed_vectors_));
-        bs.Set(DISKANN_LAYOUT_FILE, convert_stream_to_binary(disk_layout_stream_));
+        if (layout_size_ > 0) {
+            bs.Set(DISKANN_LAYOUT_FILE, convert_file_to_binary(diskann_params_.layout_path));
+        } else {
+            bs.Set(DISKANN_LAYOUT_FILE, convert_stream_to_binary(disk_layout_stream_));
+        }
         bs.Set(DISKANN_TAG_FILE, convert_stream_to_binary(tag_stream_));
         if (preload_) {
             bs.Set(DISKANN_GRAPH, convert_stream_to_binary(graph_stream_));
@@ -779,11 +869,19 @@ int64_t
 DiskANN::GetEstimateBuildMemory(const int64_t num_elements) const {
     int64_t estimate_memory_usage = 0;
     // Memory usage of graph (1.365 is the relaxation factor used by DiskANN during graph construction.)
-    estimate_memory_usage += (num_elements * R_ * sizeof(uint32_t)  // NOLINT
-                              + num_elements * (R_ + 1) * sizeof(uint32_t)) *
-                             GRAPH_SLACK;
-    // Memory usage of disk layout
-    if (sector_len_ > MINIMAL_SECTOR_LEN) {
+    int64_t graph_memory_usage = (num_elements * R_ * sizeof(uint32_t)  // NOLINT
+                                  + num_elements * (R_ + 1) * sizeof(uint32_t)) *
+                                 GRAPH_SLACK;
+    if (diskann_params_.build_memory_budget > 0) {
+        graph_memory_usage = std::min(
+            graph_memory_usage,
+            static_cast<int64_t>(diskann_params_.build_memory_budget * 1024 * 1024 * 1024));
+    }
+    estimate_memory_usage += graph_memory_usage;
+    // Memory usage of disk layout, a layout written to file keeps only one sector in memory
+    if (not diskann_params_.layout_path.empty()) {
+        estimate_memory_usage += static_cast<int64_t>(sector_len_);
+    } else if (sector_len_ > MINIMAL_SECTOR_LEN) {
         estimate_memory_usage +=
             static_cast<int64_t>((num_elements + 1) * sector_len_ * sizeof(uint8_t));
     } else {
@@ -1022,6 +1120,56 @@ DiskANN::build_partial_graph(const DatasetPtr& base,
     return {};
 }
 
+void
+DiskANN::build_merged_graph(const float* vectors,
+                            const int64_t* ids,
+                            int64_t data_num,
+                            const std::string& graph_path,
+                            TemporaryFiles& temporary_files) {
+    const auto& prefix = diskann_params_.layout_path;
+    auto base_path = temporary_files.Add(prefix + OUT_OF_CORE_BASE_SUFFIX);
+    temporary_files.Add(graph_path + ".data");
+    temporary_files.Add(graph_path + ".tags");
+    auto medoids_path = temporary_files.Add(prefix + "_medoids.bin");
+    auto centroids_path = temporary_files.Add(prefix + "_centroids.bin");
+
+    auto data_num_int32 = static_cast<int32_t>(data_num);
+    auto data_dim_int32 = static_cast<int32_t>(dim_);
+    {
+        std::ofstream base_file(base_path, std::ios::binary | std::ios::trunc);
+        if (not base_file.is_open()) {
+            throw VsagException(ErrorType::INTERNAL_ERROR,
+                                fmt::format("failed to open file: {}", base_path));
+        }
+        base_file.write((char*)&data_num_int32, sizeof(data_num_int32));
+        base_file.write((char*)&data_dim_int32, sizeof(data_dim_int32));
+        base_file.write((const char*)vectors,
+                        static_cast<std::streamsize>(data_num * dim_ * sizeof(float)));
+    }
+
+    // the vendored builder shards the base by k-means until every shard fits in the budget,
+    //  builds the shards one by one and merges them into a graph file
+    double sampling_rate = std::min(
+        1.0, static_cast<double>(MAX_PQ_TRAINING_SET_SIZE) / static_cast<double>(data_num));
+    diskann::build_merged_vamana_index<float>(base_path,
+                                              metric_,
+                                              L_,
+                                              R_,
+                                              sampling_rate,
+                                              diskann_params_.build_memory_budget,
+                                              graph_path,
+                                              medoids_path,
+                                              centroids_path,
+                                              0,
+                                              false,
+                                              Options::Instance().num_threads_building());
+
+    tag_stream_.write((char*)&data_num_int32, sizeof(data_num_int32));
+    int32_t tag_dim = 1;
+    tag_stream_.write((char*)&tag_dim, sizeof(tag_dim));
+    tag_stream_.write((const char*)ids, static_cast<std::streamsize>(data_num * sizeof(int64_t)));
+}
+
 tl::expected<void, Error>
 DiskANN::load_disk_index(const BinarySet& binary_set) {
     disk_layout_reader_ = std::make_shared<LocalMemoryReader>(disk_layout_stream_);
@@ -51,6 +51,8 @@
 
 namespace vsag {
 
+class TemporaryFiles;
+
 enum IndexStatus { EMPTY = 0, MEMORY = 1, HYBRID = 2, BUILDING = 3 };
 
 enum BuildStatus { BEGIN = 0, GRAPH = 1, EDGE_PRUNE = 2, PQ = 3, DISK_LAYOUT = 4, FINISH = 5 };
@@ -212,6 +214,13 @@ private:
                         BinarySet& after_binary_set,
                         int round);
 
+    void
+    build_merged_graph(const float* vectors,
+                       const int64_t* ids,
+                       int64_t data_num,
+                       const std::string& graph_path,
+                       TemporaryFiles& temporary_files);
+
     tl::expected<void, Error>
     load_disk_index(const BinarySet& binary_set);
 
@@ -235,6 +244,8 @@ private:
     std::function<void(const std::vector<read_request>&, bool, CallBack)> batch_read_;
     diskann::Metric metric_;
     std::shared_ptr<Reader> disk_layout_reader_;
+    // the size of the layout file written by an out-of-core build, 0 if the layout is in memory
+    uint64_t layout_size_{0};
 
     int L_ = 200;
     int R_ = 64;
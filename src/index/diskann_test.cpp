@@ -16,6 +16,7 @@
 #include "diskann.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <filesystem>
 #include <nlohmann/json.hpp>
 #include <tuple>
 
@@ -587,3 +588,81 @@ TEST_CASE("split building process", "[ut][diskann]") {
     vsag::logger::debug("Recall: " + std::to_string(recall_full));
     REQUIRE(recall_full == recall_partial);
 }
+
+TEST_CASE("diskann out-of-core build", "[ut][diskann]") {
+    vsag::logger::set_level(vsag::logger::level::debug);
+    vsag::IndexCommonParam common_param;
+    common_param.dim_ = 128;
+    common_param.data_type_ = vsag::DataTypes::DATA_TYPE_FLOAT;
+    common_param.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    vsag::DiskannParameters diskann_obj = parse_diskann_params(common_param);
+    diskann_obj.pq_dims = 16;
+    diskann_obj.max_degree = 12;
+    diskann_obj.use_reference = false;
+    diskann_obj.use_preload = false;
+
+    fixtures::TempDir dir("diskann");
+    diskann_obj.layout_path = dir.path + "layout";
+    // far below the estimated usage of 2000 vectors, the base is built in several shards
+    diskann_obj.build_memory_budget = 0.0006;
+    auto index = std::make_shared<vsag::DiskANN>(diskann_obj, common_param);
+
+    int64_t num_elements = 2000;
+    auto [ids, vectors] = fixtures::generate_ids_and_vectors(num_elements, common_param.dim_);
+    auto dataset = vsag::Dataset::Make();
+    dataset->Dim(common_param.dim_)
+        ->NumElements(num_elements)
+        ->Ids(ids.data())
+        ->Float32Vectors(vectors.data())
+        ->Owner(false);
+    REQUIRE(index->Build(dataset).has_value());
+
+    // only the layout is left on disk, it is not kept in memory
+    REQUIRE(std::filesystem::exists(diskann_obj.layout_path));
+    uint64_t file_count = 0;
+    for ([[maybe_unused]] const auto& entry : std::filesystem::directory_iterator(dir.path)) {
+        ++file_count;
+    }
+    REQUIRE(file_count == 1);
+
+    auto binary_set = index->Serialize();
+    REQUIRE(binary_set.has_value());
+    REQUIRE(binary_set->Get(vsag::DISKANN_LAYOUT_FILE).size ==
+            std::filesystem::file_size(diskann_obj.layout_path));
+    diskann_obj.layout_path.clear();
+    diskann_obj.build_memory_budget = 0;
+    auto deserialized = std::make_shared<vsag::DiskANN>(diskann_obj, common_param);
+    REQUIRE(deserialized->Deserialize(binary_set.value()).has_value());
+    auto in_memory = std::make_shared<vsag::DiskANN>(diskann_obj, common_param);
+    REQUIRE(in_memory->Build(dataset).has_value());
+
+    vsag::JsonType parameters{
+        {"diskann", {{"ef_search", 50}, {"beam_search", 4}, {"io_limit", 50}}}};
+    float correct = 0;
+    float in_memory_correct = 0;
+    for (int64_t i = 0; i < num_elements; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(common_param.dim_)
+            ->Float32Vectors(vectors.data() + i * common_param.dim_)
+            ->Owner(false);
+        auto result = index->KnnSearch(query, 1, parameters.dump());
+        REQUIRE(result.has_value());
+        auto expected = deserialized->KnnSearch(query, 1, parameters.dump());
+        REQUIRE(expected.has_value());
+        REQUIRE(result.value()->GetIds()[0] == expected.value()->GetIds()[0]);
+        if (result.value()->GetIds()[0] == ids[i]) {
+            ++correct;
+        }
+        auto in_memory_result = in_memory->KnnSearch(query, 1, parameters.dump());
+        REQUIRE(in_memory_result.has_value());
+        if (in_memory_result.value()->GetIds()[0] == ids[i]) {
+            ++in_memory_correct;
+        }
+    }
+    // the shards are built with a smaller degree before they are merged
+    vsag::logger::debug(fmt::format("recall out-of-core: {}, in memory: {}",
+                                    correct / static_cast<float>(num_elements),
+                                    in_memory_correct / static_cast<float>(num_elements)));
+    REQUIRE(correct >= in_memory_correct * 0.9);
+}
@@ -141,6 +141,29 @@ DiskannParameters::FromJson(
                                                 GRAPH_TYPE_ODESCENT,
                                                 obj.graph_type));
     }
+
+    // set obj.layout_path
+    if (diskann_param_obj.contains(DISKANN_PARAMETER_LAYOUT_PATH)) {
+        obj.layout_path = diskann_param_obj[DISKANN_PARAMETER_LAYOUT_PATH];
+    }
+
+    // set obj.build_memory_budget
+    if (diskann_param_obj.contains(DISKANN_PARAMETER_BUILD_MEMORY_BUDGET)) {
+        obj.build_memory_budget = diskann_param_obj[DISKANN_PARAMETER_BUILD_MEMORY_BUDGET];
+        CHECK_ARGUMENT(obj.build_memory_budget >= 0,
+                       fmt::format("{} must be greater equal than 0, now is {}",
+                                   DISKANN_PARAMETER_BUILD_MEMORY_BUDGET,
+                                   obj.build_memory_budget));
+        CHECK_ARGUMENT(obj.build_memory_budget == 0 or not obj.layout_path.empty(),
+                       fmt::format("parameters[{}] requires {}",
+                                   DISKANN_PARAMETER_BUILD_MEMORY_BUDGET,
+                                   DISKANN_PARAMETER_LAYOUT_PATH));
+        CHECK_ARGUMENT(obj.build_memory_budget == 0 or obj.graph_type == DISKANN_GRAPH_TYPE_VAMANA,
+                       fmt::format("parameters[{}] requires {} to be {}",
+                                   DISKANN_PARAMETER_BUILD_MEMORY_BUDGET,
+                                   DISKANN_PARAMETER_GRAPH_TYPE,
+                                   DISKANN_GRAPH_TYPE_VAMANA));
+    }
     return obj;
 }
 
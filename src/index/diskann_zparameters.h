@@ -50,6 +50,11 @@ public:
     int64_t turn = 40;
     float sample_rate = 0.3;
 
+    // out-of-core build: stream the disk layout to this file instead of memory
+    std::string layout_path;
+    // the memory budget(GiB) of the vamana graph build, 0 means no limit, requires layout_path
+    float build_memory_budget = 0;
+
 private:
     DiskannParameters() = default;
 };
@@ -35,3 +35,29 @@ TEST_CASE("create diskann with correct parameter", "[ut][diskann]") {
     nlohmann::json parsed_params = nlohmann::json::parse(build_parameter_json);
     vsag::DiskannParameters::FromJson(parsed_params, common_param);
 }
+
+TEST_CASE("create diskann with out-of-core build parameter", "[ut][diskann]") {
+    vsag::IndexCommonParam common_param;
+    common_param.dim_ = 128;
+    common_param.data_type_ = vsag::DataTypes::DATA_TYPE_FLOAT;
+    common_param.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    auto build_parameter_json = R"(
+        {
+            "max_degree": 16,
+            "ef_construction": 200,
+            "pq_dims": 32,
+            "pq_sample_rate": 0.5,
+            "build_memory_budget_gb": 4
+        }
+        )";
+    nlohmann::json parsed_params = nlohmann::json::parse(build_parameter_json);
+    REQUIRE_THROWS(vsag::DiskannParameters::FromJson(parsed_params, common_param));
+
+    parsed_params["layout_path"] = "/tmp/diskann_layout";
+    auto params = vsag::DiskannParameters::FromJson(parsed_params, common_param);
+    REQUIRE(params.layout_path == "/tmp/diskann_layout");
+    REQUIRE(params.build_memory_budget == 4);
+
+    parsed_params["build_memory_budget_gb"] = -1;
+    REQUIRE_THROWS(vsag::DiskannParameters::FromJson(parsed_params, common_param));
+}
@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <exception>
+#include <future>
 #include <new>
 #include <nlohmann/json.hpp>
 #include <stdexcept>
@@ -28,6 +29,7 @@
 #include "data_cell/flatten_datacell.h"
 #include "data_cell/graph_datacell_parameter.h"
 #include "empty_index_binary_set.h"
+#include "impl/graph_search_cursor.h"
 #include "impl/odescent_graph_builder.h"
 #include "index/hnsw_zparameters.h"
 #include "io/memory_block_io_parameter.h"
@@ -52,6 +54,8 @@ const static uint32_t UPDATE_CHECK_SEARCH_K = 10;
 const static uint32_t GENERATE_SEARCH_L = 400;
 const static uint32_t UPDATE_CHECK_SEARCH_L = 100;
 const static float GENERATE_OMEGA = 0.51;
+const static int64_t FEEDBACK_CHUNK_SIZE = 16;
+const static int64_t ADD_STREAM_TASK_SIZE = 64;
 
 HNSW::HNSW(HnswParameters hnsw_params, const IndexCommonParam& index_common_param)
     : space_(std::move(hnsw_params.space)),
@@ -76,6 +80,12 @@ HNSW::HNSW(HnswParameters hnsw_params, const IndexCommonParam& index_common_para
         conjugate_graph_ = std::make_shared<ConjugateGraph>(allocator_.get());
     }
 
+    if (index_common_param.query_cache_size_ > 0) {
+        query_cache_ = std::make_shared<QueryResultCache>(index_common_param.query_cache_size_,
+                                                          index_common_param.extra_info_size_,
+                                                          allocator_.get());
+    }
+
     if (!use_static_) {
         alg_hnsw_ =
             std::make_shared<hnswlib::HierarchicalNSW>(space_.get(),
@@ -186,6 +196,60 @@ HNSW::add(const DatasetPtr& base) {
     }
 }
 
+tl::expected<std::vector<int64_t>, Error>
+HNSW::add_stream(const DatasetStream& next_chunk) {
+#ifndef ENABLE_TESTS
+    SlowTaskTimer t("hnsw add stream", 20);
+#endif
+    if (use_static_) {
+        LOG_ERROR_AND_RETURNS(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                              "static index does not support add");
+    }
+    try {
+        CHECK_ARGUMENT(next_chunk != nullptr, "next_chunk is nullptr");
+        std::vector<int64_t> failed_ids;
+        DatasetPtr chunk = nullptr;
+        // a chunk is fully inserted and released before the next one is pulled, so the source
+        // is never read ahead and at most one chunk is held
+        while ((chunk = next_chunk()) != nullptr) {
+            auto base_dim = chunk->GetDim();
+            CHECK_ARGUMENT(
+                base_dim == dim_,
+                fmt::format("base.dim({}) must be equal to index.dim({})", base_dim, dim_));
+
+            int64_t num_elements = chunk->GetNumElements();
+            const auto* ids = chunk->GetIds();
+            void* vectors = nullptr;
+            size_t data_size = 0;
+            get_vectors(chunk, &vectors, &data_size);
+
+            auto task_count = (num_elements + ADD_STREAM_TASK_SIZE - 1) / ADD_STREAM_TASK_SIZE;
+            std::vector<std::vector<int64_t>> task_failed_ids(task_count);
+            auto add_task = [&](int64_t task_id) {
+                auto end = std::min(num_elements, (task_id + 1) * ADD_STREAM_TASK_SIZE);
+                for (auto i = task_id * ADD_STREAM_TASK_SIZE; i < end; ++i) {
+                    std::shared_lock lock(rw_mutex_);
+                    if (!alg_hnsw_->addPoint((const void*)((char*)vectors + data_size * i),
+                                             ids[i])) {
+                        logger::debug("duplicate point: {}", ids[i]);
+                        task_failed_ids[task_id].push_back(ids[i]);
+                    }
+                }
+            };
+            this->run_tasks(task_count, add_task);
+
+            for (const auto& task_ids : task_failed_ids) {
+                failed_ids.insert(failed_ids.end(), task_ids.begin(), task_ids.end());
+            }
+            chunk.reset();
+        }
+        return failed_ids;
+    } catch (const std::invalid_argument& e) {
+        LOG_ERROR_AND_RETURNS(
+            ErrorType::INVALID_ARGUMENT, "failed to add stream(invalid argument): ", e.what());
+    }
+}
+
 template <typename FilterType>
 tl::expected<DatasetPtr, Error>
 HNSW::knn_search_internal(const DatasetPtr& query,
@@ -196,9 +260,30 @@ HNSW::knn_search_internal(const DatasetPtr& query,
         auto filter = std::make_shared<UniqueFilter>(filter_obj);
         return this->knn_search(query, k, parameters, filter);
     }
-    return this->knn_search(query, k, parameters, nullptr);
+    return this->knn_search_cached(query, k, parameters, nullptr);
 };
 
+tl::expected<DatasetPtr, Error>
+HNSW::knn_search_cached(const DatasetPtr& query,
+                        int64_t k,
+                        const std::string& parameters,
+                        const FilterPtr& filter_ptr) const {
+    QueryResultCache::Key key(allocator_.get());
+    if (query_cache_ == nullptr or
+        not query_cache_->MakeKey(query, k, parameters, filter_ptr, key)) {
+        return this->knn_search(query, k, parameters, filter_ptr);
+    }
+    auto epoch = query_cache_->Epoch();
+    if (auto cached = query_cache_->Get(key); cached != nullptr) {
+        return cached;
+    }
+    auto result = this->knn_search(query, k, parameters, filter_ptr);
+    if (result.has_value()) {
+        query_cache_->Put(key, epoch, result.value());
+    }
+    return result;
+}
+
 tl::expected<DatasetPtr, Error>
 HNSW::knn_search(const DatasetPtr& query,
                  int64_t k,
@@ -255,13 +340,30 @@ HNSW::knn_search(const DatasetPtr& query,
             if (use_conjugate_graph_ and params.use_conjugate_graph_search) {
                 k = std::max(k, LOOK_AT_K);
             }
-            results = alg_hnsw_->searchKnn((const void*)(vector),
-                                           k,
-                                           std::max(params.ef_search, k),
-                                           filter_ptr,
-                                           params.skip_ratio,
-                                           iter_filter_ctx,
-                                           is_last_filter);
+            auto plan = SearchPlan::GRAPH_SEARCH;
+            if (iter_filter_ctx == nullptr) {
+                auto ef = static_cast<uint64_t>(std::max(params.ef_search, k));
+                auto total = static_cast<uint64_t>(GetNumElements());
+                auto valid_ratio = SearchPlanner::EstimateValidRatio(filter_ptr);
+                plan = SearchPlanner::Plan(
+                    filter_ptr,
+                    valid_ratio,
+                    SearchPlanner::GraphSearchCost(ef, max_degree_, valid_ratio, total),
+                    SearchPlanner::ExactScanCost(filter_ptr, valid_ratio, total),
+                    false);
+                search_plan_stats_.Record(plan);
+            }
+            if (plan == SearchPlan::EXACT_SCAN) {
+                results = alg_hnsw_->bruteForce((const void*)(vector), k, filter_ptr);
+            } else {
+                results = alg_hnsw_->searchKnn((const void*)(vector),
+                                               k,
+                                               std::max(params.ef_search, k),
+                                               filter_ptr,
+                                               params.skip_ratio,
+                                               iter_filter_ctx,
+                                               is_last_filter);
+            }
         } catch (const std::runtime_error& e) {
             LOG_ERROR_AND_RETURNS(ErrorType::INTERNAL_ERROR,
                                   "failed to perofrm knn_search(internalError): ",
@@ -287,12 +389,8 @@ HNSW::knn_search(const DatasetPtr& query,
             time_cost = 0;
             Timer t(time_cost);
 
-            auto func = [this, vector](int64_t label) {
-                try {
-                    return this->alg_hnsw_->getDistanceByLabel(label, vector);
-                } catch (const std::runtime_error& e) {
-                    return std::numeric_limits<float>::max();
-                }
+            auto func = [this, vector](const int64_t* labels, int64_t count, float* distances) {
+                this->alg_hnsw_->getDistancesByLabel(labels, count, vector, distances);
             };
             conjugate_graph_->EnhanceResult(results, func);
             k = original_k;
@@ -323,6 +421,106 @@ HNSW::knn_search(const DatasetPtr& query,
     }
 }
 
+namespace {
+
+// a cursor over the level 0 graph of hnswlib, the filter is tested on labels
+class HNSWSearchCursor : public GraphSearchCursor {
+public:
+    HNSWSearchCursor(const void* query,
+                     size_t query_size,
+                     uint64_t ef,
+                     std::shared_ptr<hnswlib::HierarchicalNSW> hnsw,
+                     FilterPtr filter,
+                     std::shared_mutex& index_mutex,
+                     Allocator* allocator)
+        : GraphSearchCursor(
+              ef, static_cast<InnerIdType>(hnsw->getCurrentElementCount()), allocator),
+          query_(static_cast<const char*>(query),
+                 static_cast<const char*>(query) + query_size,
+                 allocator),
+          hnsw_(std::move(hnsw)),
+          filter_(std::move(filter)),
+          index_mutex_(index_mutex) {
+        query_data_ = query_.data();
+        hnsw_->normalizeVector(query_data_, normalized_query_);
+    }
+
+    tl::expected<DatasetPtr, Error>
+    Next(int64_t n) override {
+        std::shared_lock lock(index_mutex_);
+        return GraphSearchCursor::Next(n);
+    }
+
+    [[nodiscard]] const void*
+    QueryData() const {
+        return query_data_;
+    }
+
+protected:
+    void
+    get_neighbors(InnerIdType inner_id, Vector<InnerIdType>& neighbors) const override {
+        hnsw_->getNeighborsAtLevel0(inner_id, neighbors);
+    }
+
+    void
+    compute_distances(const InnerIdType* inner_ids, uint64_t count, float* dists) const override {
+        hnsw_->calcDistancesByInternalIds(query_data_, inner_ids, count, dists);
+    }
+
+    [[nodiscard]] bool
+    check_valid(InnerIdType inner_id) const override {
+        if (hnsw_->isMarkedDeleted(inner_id)) {
+            return false;
+        }
+        return filter_ == nullptr or filter_->CheckValid(hnsw_->getExternalLabel(inner_id));
+    }
+
+    [[nodiscard]] LabelType
+    get_label(InnerIdType inner_id) const override {
+        return hnsw_->getExternalLabel(inner_id);
+    }
+
+private:
+    Vector<char> query_;
+    const void* query_data_{nullptr};
+    std::shared_ptr<float[]> normalized_query_{nullptr};
+
+    const std::shared_ptr<hnswlib::HierarchicalNSW> hnsw_{nullptr};
+    const FilterPtr filter_{nullptr};
+    std::shared_mutex& index_mutex_;
+};
+
+}  // namespace
+
+SearchCursorPtr
+HNSW::open_search_cursor(const DatasetPtr& query,
+                         const std::string& parameters,
+                         const FilterPtr& filter_ptr) const {
+    CHECK_ARGUMENT(not use_static_, "static hnsw does not support search cursor");
+    CHECK_ARGUMENT(query->GetNumElements() == 1, "query dataset should contain 1 vector only");
+    int64_t query_dim = query->GetDim();
+    CHECK_ARGUMENT(query_dim == dim_,
+                   fmt::format("query.dim({}) must be equal to index.dim({})", query_dim, dim_));
+    void* vector = nullptr;
+    size_t data_size = 0;
+    get_vectors(query, &vector, &data_size);
+    auto params = HnswSearchParameters::FromJson(parameters);
+
+    std::shared_lock lock(rw_mutex_);
+    auto hnsw = std::static_pointer_cast<hnswlib::HierarchicalNSW>(alg_hnsw_);
+    auto cursor = std::make_shared<HNSWSearchCursor>(vector,
+                                                     data_size,
+                                                     static_cast<uint64_t>(params.ef_search),
+                                                     hnsw,
+                                                     filter_ptr,
+                                                     rw_mutex_,
+                                                     allocator_.get());
+    if (not empty_index_ and hnsw->getCurrentElementCount() > 0) {
+        cursor->Seed(hnsw->searchUpperLevels(cursor->QueryData()));
+    }
+    return cursor;
+}
+
 template <typename FilterType>
 tl::expected<DatasetPtr, Error>
 HNSW::range_search_internal(const DatasetPtr& query,
@@ -385,8 +583,8 @@ HNSW::range_search(const DatasetPtr& query,
         try {
             std::shared_lock lock(rw_mutex_);
             Timer timer(time_cost);
-            results =
-                alg_hnsw_->searchRange((const void*)(vector), radius, params.ef_search, filter_ptr);
+            results = alg_hnsw_->searchRange(
+                (const void*)(vector), radius, params.ef_search, filter_ptr, limited_size);
         } catch (std::runtime_error& e) {
             LOG_ERROR_AND_RETURNS(ErrorType::INTERNAL_ERROR,
                                   "failed to perofrm range_search(internalError): ",
@@ -608,6 +806,10 @@ HNSW::GetStats() const {
             j[item.first] = item.second.GetAvgResult();
         }
     }
+    search_plan_stats_.ToJson(j);
+    if (query_cache_ != nullptr) {
+        query_cache_->ToJson(j);
+    }
     return j.dump();
 }
 
@@ -852,53 +1054,53 @@ HNSW::pretrain(const std::vector<int64_t>& base_tag_ids,
     }
 
     uint32_t data_size = 0;
-    uint32_t add_edges = 0;
-    int64_t topk_neighbor_tag_id;
-    auto base = Dataset::Make();
-    auto generated_query = Dataset::Make();
     if (type_ == DataTypes::DATA_TYPE_INT8) {
         data_size = dim_;
     } else {
         data_size = dim_ * 4;
     }
-    std::shared_ptr<int8_t[]> base_data(new int8_t[data_size]);
-    std::shared_ptr<int8_t[]> topk_data(new int8_t[data_size]);
+    auto generate_parameters = fmt::format(R"(
+                                        {{
+                                            "hnsw": {{
+                                                "ef_search": {},
+                                                "use_conjugate_graph": true
+                                            }}
+                                        }})",
+                                           vsag::GENERATE_SEARCH_L);
+    auto* hnsw = static_cast<hnswlib::HierarchicalNSW*>(alg_hnsw_.get());
 
-    std::shared_ptr<int8_t[]> generated_data(new int8_t[data_size]);
-    set_dataset(generated_query, generated_data.get(), 1);
+    auto collect = [&](int64_t index, ConjugateEdgeBuffer& edges) {
+        auto base_tag_id = base_tag_ids[index];
+        auto base = Dataset::Make();
+        auto generated_query = Dataset::Make();
+        std::shared_ptr<int8_t[]> base_data(new int8_t[data_size]);
+        std::shared_ptr<int8_t[]> topk_data(new int8_t[data_size]);
+        std::shared_ptr<int8_t[]> generated_data(new int8_t[data_size]);
+        set_dataset(generated_query, generated_data.get(), 1);
 
-    for (const int64_t& base_tag_id : base_tag_ids) {
         try {
-            std::reinterpret_pointer_cast<hnswlib::HierarchicalNSW>(alg_hnsw_)->copyDataByLabel(
-                base_tag_id, base_data.get());
+            hnsw->copyDataByLabel(base_tag_id, base_data.get());
             set_dataset(base, base_data.get(), 1);
         } catch (const std::runtime_error& e) {
-            LOG_ERROR_AND_RETURNS(ErrorType::INVALID_ARGUMENT,
-                                  fmt::format("failed to pretrain(invalid argument): base tag id "
-                                              "({}) doesn't belong to index",
-                                              base_tag_id));
+            throw VsagException(ErrorType::INVALID_ARGUMENT,
+                                fmt::format("failed to pretrain(invalid argument): base tag id "
+                                            "({}) doesn't belong to index",
+                                            base_tag_id));
         }
 
-        auto result = this->knn_search(base,
-                                       vsag::GENERATE_SEARCH_K,
-                                       fmt::format(R"(
-                                        {{
-                                            "hnsw": {{
-                                                "ef_search": {},
-                                                "use_conjugate_graph": true
-                                            }}
-                                        }})",
-                                                   vsag::GENERATE_SEARCH_L),
-                                       nullptr);
+        auto result =
+            this->knn_search(base, vsag::GENERATE_SEARCH_K, generate_parameters, nullptr);
+        if (not result.has_value()) {
+            throw VsagException(result.error());
+        }
 
         for (int i = 0; i < result.value()->GetDim(); i++) {
-            topk_neighbor_tag_id = result.value()->GetIds()[i];
+            auto topk_neighbor_tag_id = result.value()->GetIds()[i];
             if (topk_neighbor_tag_id == base_tag_id) {
                 continue;
             }
 
-            std::reinterpret_pointer_cast<hnswlib::HierarchicalNSW>(alg_hnsw_)->copyDataByLabel(
-                topk_neighbor_tag_id, topk_data.get());
+            hnsw->copyDataByLabel(topk_neighbor_tag_id, topk_data.get());
 
             for (int d = 0; d < dim_; d++) {
                 if (type_ == DataTypes::DATA_TYPE_INT8) {
@@ -912,18 +1114,149 @@ HNSW::pretrain(const std::vector<int64_t>& base_tag_ids,
                 }
             }
 
-            auto feedback_result = this->Feedback(generated_query, k, parameters, base_tag_id);
-            if (feedback_result.has_value()) {
-                add_edges += *feedback_result;
-            } else {
-                LOG_ERROR_AND_RETURNS(ErrorType::INVALID_ARGUMENT,
-                                      "failed to feedback(invalid argument): ",
-                                      feedback_result.error().message);
+            this->collect_feedback_edges(generated_query, k, parameters, base_tag_id, edges);
+        }
+    };
+
+    return this->merge_conjugate_edges(static_cast<int64_t>(base_tag_ids.size()), collect);
+}
+
+tl::expected<uint32_t, Error>
+HNSW::batch_feedback(const DatasetPtr& queries,
+                     int64_t k,
+                     const std::string& parameters,
+                     const std::vector<int64_t>& global_optimum_tag_ids) {
+    if (not use_conjugate_graph_) {
+        LOG_ERROR_AND_RETURNS(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                              "no conjugate graph used for feedback");
+    }
+    if (empty_index_) {
+        return 0;
+    }
+
+    auto query_count = queries->GetNumElements();
+    CHECK_ARGUMENT(k > 0, fmt::format("k({}) must be greater than 0", k));
+    CHECK_ARGUMENT(
+        queries->GetDim() == dim_,
+        fmt::format("query.dim({}) must be equal to index.dim({})", queries->GetDim(), dim_));
+    CHECK_ARGUMENT(global_optimum_tag_ids.empty() or
+                       global_optimum_tag_ids.size() == static_cast<uint64_t>(query_count),
+                   fmt::format("global optimum tag ids size({}) must be 0 or query num({})",
+                               global_optimum_tag_ids.size(),
+                               query_count));
+    // rejected before any search, so an invalid tag id doesn't fail the batch halfway
+    for (uint64_t i = 0; i < global_optimum_tag_ids.size(); ++i) {
+        CHECK_ARGUMENT(alg_hnsw_->isValidLabel(global_optimum_tag_ids[i]),
+                       fmt::format("failed to feedback(invalid argument): global optimum tag "
+                                   "id({}) of query({}) doesn't belong to index",
+                                   global_optimum_tag_ids[i],
+                                   i));
+    }
+
+    void* vectors = nullptr;
+    size_t data_size = 0;
+    get_vectors(queries, &vectors, &data_size);
+
+    auto collect = [&](int64_t index, ConjugateEdgeBuffer& edges) {
+        auto query = Dataset::Make();
+        set_dataset(query, (const int8_t*)vectors + index * data_size, 1);
+        auto global_optimum_tag_id = global_optimum_tag_ids.empty()
+                                         ? std::numeric_limits<int64_t>::max()
+                                         : global_optimum_tag_ids[index];
+        this->collect_feedback_edges(query, k, parameters, global_optimum_tag_id, edges);
+    };
+
+    return this->merge_conjugate_edges(query_count, collect);
+}
+
+void
+HNSW::collect_feedback_edges(const DatasetPtr& query,
+                             int64_t k,
+                             const std::string& parameters,
+                             int64_t global_optimum_tag_id,
+                             ConjugateEdgeBuffer& edges) {
+    if (global_optimum_tag_id == std::numeric_limits<int64_t>::max()) {
+        auto exact_result = this->brute_force(query, 1);
+        if (not exact_result.has_value()) {
+            throw VsagException(exact_result.error());
+        }
+        global_optimum_tag_id = exact_result.value()->GetIds()[0];
+    }
+
+    auto result = this->knn_search(query, k, parameters, nullptr);
+    if (not result.has_value()) {
+        throw VsagException(result.error());
+    }
+    const auto* tag_ids = result.value()->GetIds();
+    auto edge_count = std::min(k, result.value()->GetDim());
+    for (int64_t i = 0; i < edge_count; ++i) {
+        edges.emplace_back(tag_ids[i], global_optimum_tag_id);
+    }
+}
+
+uint32_t
+HNSW::merge_conjugate_edges(
+    int64_t count, const std::function<void(int64_t, ConjugateEdgeBuffer&)>& collect) {
+    auto task_count = (count + FEEDBACK_CHUNK_SIZE - 1) / FEEDBACK_CHUNK_SIZE;
+    std::vector<ConjugateEdgeBuffer> buffers(task_count);
+    auto collect_chunk = [&](int64_t task_id) {
+        auto end = std::min(count, (task_id + 1) * FEEDBACK_CHUNK_SIZE);
+        for (auto i = task_id * FEEDBACK_CHUNK_SIZE; i < end; ++i) {
+            collect(i, buffers[task_id]);
+        }
+    };
+
+    this->run_tasks(task_count, collect_chunk);
+
+    // edges are merged in input order, so the result doesn't depend on the scheduling
+    std::unique_lock lock(rw_mutex_);
+    uint32_t successfully_feedback = 0;
+    for (const auto& edges : buffers) {
+        for (const auto& [tag_id, global_optimum_tag_id] : edges) {
+            // the tag ids were valid when searched, skip the ones removed since then
+            if (not alg_hnsw_->isValidLabel(global_optimum_tag_id) or
+                not alg_hnsw_->isValidLabel(tag_id)) {
+                continue;
+            }
+            if (*conjugate_graph_->AddNeighbor(tag_id, global_optimum_tag_id)) {
+                successfully_feedback++;
             }
         }
     }
+    return successfully_feedback;
+}
 
-    return add_edges;
+void
+HNSW::run_tasks(int64_t task_count, const std::function<void(int64_t)>& task) const {
+    auto thread_pool = index_common_param_.thread_pool_;
+    if (thread_pool == nullptr and task_count > 1) {
+        thread_pool = SafeThreadPool::FactoryDefaultThreadPool();
+    }
+    if (thread_pool == nullptr) {
+        for (int64_t task_id = 0; task_id < task_count; ++task_id) {
+            task(task_id);
+        }
+        return;
+    }
+    std::vector<std::future<void>> futures;
+    futures.reserve(task_count);
+    for (int64_t task_id = 0; task_id < task_count; ++task_id) {
+        futures.emplace_back(thread_pool->GeneralEnqueue(task, task_id));
+    }
+    // every task must finish before the state captured by the caller goes out of scope
+    std::exception_ptr first_error = nullptr;
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (first_error == nullptr) {
+                first_error = std::current_exception();
+            }
+        }
+    }
+    if (first_error != nullptr) {
+        std::rethrow_exception(first_error);
+    }
 }
 
 tl::expected<bool, Error>
@@ -984,6 +1317,9 @@ HNSW::init_feature_list() {
                                IndexFeature::SUPPORT_KNN_SEARCH_WITH_ID_FILTER,
                                IndexFeature::SUPPORT_RANGE_SEARCH_WITH_ID_FILTER,
                                IndexFeature::SUPPORT_KNN_ITERATOR_FILTER_SEARCH});
+    if (not use_static_) {
+        feature_list_.SetFeature(IndexFeature::SUPPORT_SEARCH_CURSOR);
+    }
     // concurrency
     feature_list_.SetFeatures({IndexFeature::SUPPORT_SEARCH_CONCURRENT,
                                IndexFeature::SUPPORT_ADD_SEARCH_CONCURRENT,
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -34,6 +35,8 @@
 #include "data_type.h"
 #include "hnsw_zparameters.h"
 #include "impl/conjugate_graph.h"
+#include "impl/query_result_cache.h"
+#include "impl/search_planner.h"
 #include "index_common_param.h"
 #include "index_feature_list.h"
 #include "index_impl.h"
@@ -49,6 +52,9 @@
 
 namespace vsag {
 
+// (tag id, neighbor tag id) edges waiting to be inserted into the conjugate graph
+using ConjugateEdgeBuffer = std::vector<std::pair<int64_t, int64_t>>;
+
 class HNSW : public Index {
 public:
     HNSW(HnswParameters hnsw_params, const IndexCommonParam& index_common_param);
@@ -64,26 +70,37 @@ public:
 public:
     tl::expected<std::vector<int64_t>, Error>
     Build(const DatasetPtr& base) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->build(base));
     }
 
     tl::expected<std::vector<int64_t>, Error>
     Add(const DatasetPtr& base) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->add(base));
     }
 
+    tl::expected<std::vector<int64_t>, Error>
+    AddStream(const DatasetStream& next_chunk) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
+        SAFE_CALL(return this->add_stream(next_chunk));
+    }
+
     tl::expected<bool, Error>
     Remove(int64_t id) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->remove(id));
     }
 
     tl::expected<bool, Error>
     UpdateId(int64_t old_id, int64_t new_id) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->update_id(old_id, new_id));
     }
 
     tl::expected<bool, Error>
     UpdateVector(int64_t id, const DatasetPtr& new_base, bool force_update = false) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->update_vector(id, new_base, force_update));
     }
 
@@ -108,7 +125,7 @@ public:
               int64_t k,
               const std::string& parameters,
               const FilterPtr& filter) const override {
-        SAFE_CALL(return this->knn_search(query, k, parameters, filter));
+        SAFE_CALL(return this->knn_search_cached(query, k, parameters, filter));
     }
 
     tl::expected<DatasetPtr, Error>
@@ -122,6 +139,13 @@ public:
             return this->knn_search(query, k, parameters, filter, &filter_ctx, is_last_search));
     }
 
+    tl::expected<SearchCursorPtr, Error>
+    OpenSearchCursor(const DatasetPtr& query,
+                     const std::string& parameters,
+                     const FilterPtr& filter = nullptr) const override {
+        SAFE_CALL(return this->open_search_cursor(query, parameters, filter));
+    }
+
     tl::expected<DatasetPtr, Error>
     RangeSearch(const DatasetPtr& query,
                 float radius,
@@ -156,13 +180,24 @@ public:
              int64_t k,
              const std::string& parameters,
              int64_t global_optimum_tag_id = std::numeric_limits<int64_t>::max()) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->feedback(query, k, parameters, global_optimum_tag_id));
     };
 
+    tl::expected<uint32_t, Error>
+    BatchFeedback(const DatasetPtr& queries,
+                  int64_t k,
+                  const std::string& parameters,
+                  const std::vector<int64_t>& global_optimum_tag_ids = {}) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
+        SAFE_CALL(return this->batch_feedback(queries, k, parameters, global_optimum_tag_ids));
+    };
+
     tl::expected<uint32_t, Error>
     Pretrain(const std::vector<int64_t>& base_tag_ids,
              uint32_t k,
              const std::string& parameters) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->pretrain(base_tag_ids, k, parameters));
     };
 
@@ -202,21 +237,25 @@ public:
 
     tl::expected<void, Error>
     Deserialize(const BinarySet& binary_set) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->deserialize(binary_set));
     }
 
     tl::expected<void, Error>
     Deserialize(const ReaderSet& reader_set) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->deserialize(reader_set));
     }
 
     tl::expected<void, Error>
     Deserialize(std::istream& in_stream) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->deserialize(in_stream));
     }
 
     tl::expected<void, Error>
     Merge(const std::vector<MergeUnit>& merge_units) override {
+        QueryResultCache::InvalidateGuard guard(this->query_cache_.get());
         SAFE_CALL(return this->merge(merge_units));
     }
 
@@ -261,6 +300,9 @@ private:
     tl::expected<std::vector<int64_t>, Error>
     add(const DatasetPtr& base);
 
+    tl::expected<std::vector<int64_t>, Error>
+    add_stream(const DatasetStream& next_chunk);
+
     tl::expected<bool, Error>
     remove(int64_t id);
 
@@ -285,6 +327,18 @@ private:
                vsag::IteratorContext** iter_ctx = nullptr,
                bool is_last_filter = false) const;
 
+    // knn_search answered by the query result cache when the index has one
+    tl::expected<DatasetPtr, Error>
+    knn_search_cached(const DatasetPtr& query,
+                      int64_t k,
+                      const std::string& parameters,
+                      const FilterPtr& filter_ptr) const;
+
+    SearchCursorPtr
+    open_search_cursor(const DatasetPtr& query,
+                       const std::string& parameters,
+                       const FilterPtr& filter_ptr) const;
+
     template <typename FilterType>
     tl::expected<DatasetPtr, Error>
     range_search_internal(const DatasetPtr& query,
@@ -312,6 +366,31 @@ private:
     tl::expected<DatasetPtr, Error>
     brute_force(const DatasetPtr& query, int64_t k);
 
+    tl::expected<uint32_t, Error>
+    batch_feedback(const DatasetPtr& queries,
+                   int64_t k,
+                   const std::string& parameters,
+                   const std::vector<int64_t>& global_optimum_tag_ids);
+
+    // searches one query and buffers the (result tag id, global optimum tag id) edges
+    void
+    collect_feedback_edges(const DatasetPtr& query,
+                           int64_t k,
+                           const std::string& parameters,
+                           int64_t global_optimum_tag_id,
+                           ConjugateEdgeBuffer& edges);
+
+    // runs collect on [0, count) in parallel chunks, each chunk filling its own buffer without
+    // locking, then inserts all buffered edges into conjugate graph under one exclusive lock
+    uint32_t
+    merge_conjugate_edges(int64_t count,
+                          const std::function<void(int64_t, ConjugateEdgeBuffer&)>& collect);
+
+    // runs task(0) ... task(task_count - 1) on the thread pool, waits for all of them and
+    // rethrows the first exception
+    void
+    run_tasks(int64_t task_count, const std::function<void(int64_t)>& task) const;
+
     tl::expected<uint32_t, Error>
     pretrain(const std::vector<int64_t>& base_tag_ids, uint32_t k, const std::string& parameters);
 
@@ -363,6 +442,11 @@ private:
     mutable std::mutex stats_mutex_;
     mutable std::map<std::string, WindowResultQueue> result_queues_;
 
+    mutable SearchPlanStats search_plan_stats_;
+
+    // nullptr unless the index is created with a query_cache_size
+    QueryResultCachePtr query_cache_{nullptr};
+
     mutable std::shared_mutex rw_mutex_;
 
     IndexFeatureList feature_list_{};
@@ -590,6 +590,50 @@ TEST_CASE("build with reversed edges", "[ut][hnsw]") {
     }
 }
 
+TEST_CASE("remove with reversed edges", "[ut][hnsw]") {
+    int64_t dim = 32;
+    IndexCommonParam common_param;
+    common_param.dim_ = dim;
+    common_param.data_type_ = DataTypes::DATA_TYPE_FLOAT;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    common_param.allocator_ = SafeAllocator::FactoryDefaultAllocator();
+
+    HnswParameters hnsw_obj = parse_hnsw_params(common_param);
+    hnsw_obj.use_reversed_edges = true;
+    auto index = std::make_shared<HNSW>(hnsw_obj, common_param);
+    index->InitMemorySpace();
+
+    const int64_t num_elements = 1000;
+    auto [ids, vectors] = fixtures::generate_ids_and_vectors(num_elements, dim);
+    auto dataset = Dataset::Make();
+    dataset->Dim(dim)
+        ->NumElements(num_elements)
+        ->Ids(ids.data())
+        ->Float32Vectors(vectors.data())
+        ->Owner(false);
+    REQUIRE(index->Build(dataset).has_value());
+
+    const int64_t num_removed = 300;
+    for (int64_t i = 0; i < num_removed; ++i) {
+        REQUIRE(index->Remove(ids[i]).value());
+    }
+    REQUIRE(index->GetNumElements() == num_elements - num_removed);
+    REQUIRE(index->CheckGraphIntegrity());
+
+    JsonType params{
+        {"hnsw", {{"ef_search", 100}}},
+    };
+    int64_t hit = 0;
+    for (int64_t i = num_removed; i < num_elements; ++i) {
+        auto query = Dataset::Make();
+        query->NumElements(1)->Dim(dim)->Float32Vectors(vectors.data() + i * dim)->Owner(false);
+        auto result = index->KnnSearch(query, 1, params.dump());
+        REQUIRE(result.has_value());
+        hit += result.value()->GetIds()[0] == ids[i];
+    }
+    REQUIRE(hit > (num_elements - num_removed) * 0.95);
+}
+
 TEST_CASE("feedback with invalid argument", "[ut][hnsw]") {
     Options::Instance().logger()->SetLevel(Logger::Level::kDEBUG);
     // parameters
@@ -693,6 +737,90 @@ TEST_CASE("redundant feedback and empty enhancement", "[ut][hnsw]") {
     }
 }
 
+TEST_CASE("batch feedback", "[ut][hnsw]") {
+    Options::Instance().logger()->SetLevel(Logger::Level::kDEBUG);
+
+    // parameters
+    int64_t num_base = 200;
+    int64_t num_query = 40;
+    int64_t k = 10;
+    int64_t dim = 128;
+
+    IndexCommonParam common_param;
+    common_param.dim_ = dim;
+    common_param.data_type_ = DataTypes::DATA_TYPE_FLOAT;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    common_param.allocator_ = SafeAllocator::FactoryDefaultAllocator();
+
+    HnswParameters hnsw_obj = parse_hnsw_params(common_param);
+    hnsw_obj.max_degree = 16;
+    hnsw_obj.ef_construction = 200;
+    hnsw_obj.use_conjugate_graph = true;
+    auto index = std::make_shared<HNSW>(hnsw_obj, common_param);
+    index->InitMemorySpace();
+
+    auto [base_ids, base_vectors] = fixtures::generate_ids_and_vectors(num_base, dim);
+    auto base = Dataset::Make();
+    base->NumElements(num_base)
+        ->Dim(dim)
+        ->Ids(base_ids.data())
+        ->Float32Vectors(base_vectors.data())
+        ->Owner(false);
+    // build index
+    auto buildindex = index->Build(base);
+    REQUIRE(buildindex.has_value());
+
+    // searches without enhancement, so the edges don't depend on the insertion order
+    JsonType search_parameters{
+        {"hnsw", {{"ef_search", 20}, {"use_conjugate_graph_search", false}}},
+    };
+
+    auto [ids, vectors] = fixtures::generate_ids_and_vectors(num_query, dim, true, 2024);
+    auto queries = Dataset::Make();
+    queries->NumElements(num_query)->Dim(dim)->Float32Vectors(vectors.data())->Owner(false);
+
+    SECTION("same edges as feedback one by one") {
+        auto batch_result = index->BatchFeedback(queries, k, search_parameters.dump());
+        REQUIRE(batch_result.has_value());
+        REQUIRE(*batch_result > 0);
+
+        for (int64_t i = 0; i < num_query; ++i) {
+            auto query = Dataset::Make();
+            query->NumElements(1)
+                ->Dim(dim)
+                ->Float32Vectors(vectors.data() + i * dim)
+                ->Owner(false);
+            auto feedback_result = index->Feedback(query, k, search_parameters.dump());
+            REQUIRE(feedback_result.has_value());
+            REQUIRE(*feedback_result == 0);
+        }
+    }
+
+    SECTION("given global optimum tag ids") {
+        std::vector<int64_t> global_optimum_tag_ids(num_query, base_ids[0]);
+        auto batch_result =
+            index->BatchFeedback(queries, k, search_parameters.dump(), global_optimum_tag_ids);
+        REQUIRE(batch_result.has_value());
+        REQUIRE(*batch_result > 0);
+
+        // an invalid tag id rejects the whole batch before any edge is added
+        std::vector<int64_t> invalid_tag_ids(num_query, base_ids[1]);
+        invalid_tag_ids.back() = -1000;
+        batch_result = index->BatchFeedback(queries, k, search_parameters.dump(), invalid_tag_ids);
+        REQUIRE(batch_result.error().type == ErrorType::INVALID_ARGUMENT);
+        auto query = Dataset::Make();
+        query->NumElements(1)->Dim(dim)->Float32Vectors(vectors.data())->Owner(false);
+        auto feedback_result = index->Feedback(query, k, search_parameters.dump(), base_ids[1]);
+        REQUIRE(feedback_result.has_value());
+        REQUIRE(*feedback_result > 0);
+
+        global_optimum_tag_ids.pop_back();
+        batch_result =
+            index->BatchFeedback(queries, k, search_parameters.dump(), global_optimum_tag_ids);
+        REQUIRE(batch_result.error().type == ErrorType::INVALID_ARGUMENT);
+    }
+}
+
 TEST_CASE("feedback and pretrain without use conjugate graph", "[ut][hnsw]") {
     Options::Instance().logger()->SetLevel(Logger::Level::kDEBUG);
 
@@ -889,6 +1017,116 @@ TEST_CASE("get distance by label", "[ut][hnsw]") {
     }
 }
 
+TEST_CASE("replace deleted elements", "[ut][hnsw]") {
+    int64_t dim = 32;
+    int64_t num_base = 200;
+    int64_t num_deleted = 50;
+    auto [base_ids, base_vectors] = fixtures::generate_ids_and_vectors(num_base, dim);
+    auto [new_ids, new_vectors] = fixtures::generate_ids_and_vectors(num_deleted, dim, true, 2024);
+    hnswlib::L2Space space(dim);
+    DefaultAllocator allocator;
+    hnswlib::HierarchicalNSW alg_hnsw(
+        &space, num_base, &allocator, 16, 200, false, false, 128 * 1024 * 1024, 100, true);
+    alg_hnsw.init_memory_space();
+    for (int64_t i = 0; i < num_base; ++i) {
+        REQUIRE(alg_hnsw.addPoint(base_vectors.data() + i * dim, i));
+    }
+    for (int64_t i = 0; i < num_deleted; ++i) {
+        alg_hnsw.markDelete(i);
+    }
+    REQUIRE(alg_hnsw.getDeletedCount() == num_deleted);
+
+    // new elements take over the deleted slots instead of growing the index
+    for (int64_t i = 0; i < num_deleted; ++i) {
+        REQUIRE(alg_hnsw.addPoint(new_vectors.data() + i * dim, num_base + i));
+    }
+    REQUIRE(alg_hnsw.getDeletedCount() == 0);
+    REQUIRE(alg_hnsw.getCurrentElementCount() == num_base);
+    REQUIRE_THROWS(alg_hnsw.getDistanceByLabel(0, base_vectors.data()));
+
+    for (int64_t i = 0; i < num_deleted; ++i) {
+        auto result = alg_hnsw.searchKnn(new_vectors.data() + i * dim, 1, 100);
+        REQUIRE(result.top().second == num_base + i);
+    }
+    for (int64_t i = num_deleted; i < num_base; ++i) {
+        auto result = alg_hnsw.searchKnn(base_vectors.data() + i * dim, 1, 100);
+        REQUIRE(result.top().second == i);
+    }
+
+    REQUIRE(alg_hnsw.addPoint(base_vectors.data(), num_base + num_deleted));
+    REQUIRE(alg_hnsw.getCurrentElementCount() == num_base + 1);
+}
+
+TEST_CASE("add stream", "[ut][hnsw]") {
+    int64_t dim = 32;
+    int64_t num_base = 1000;
+    int64_t chunk_size = 128;
+    auto [base_ids, base_vectors] = fixtures::generate_ids_and_vectors(num_base, dim);
+
+    IndexCommonParam common_param;
+    common_param.dim_ = dim;
+    common_param.data_type_ = DataTypes::DATA_TYPE_FLOAT;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    common_param.allocator_ = SafeAllocator::FactoryDefaultAllocator();
+    HnswParameters hnsw_obj = parse_hnsw_params(common_param);
+    hnsw_obj.max_degree = 16;
+    hnsw_obj.ef_construction = 100;
+    auto index = std::make_shared<HNSW>(hnsw_obj, common_param);
+    index->InitMemorySpace();
+
+    // the last chunk repeats the first ids, they are reported as failed
+    int64_t offset = 0;
+    int64_t pulled = 0;
+    auto next_chunk = [&]() -> DatasetPtr {
+        ++pulled;
+        if (offset > num_base) {
+            return nullptr;
+        }
+        auto chunk = Dataset::Make();
+        auto begin = offset == num_base ? 0 : offset;
+        auto count = offset == num_base ? 10 : std::min(chunk_size, num_base - offset);
+        chunk->NumElements(count)
+            ->Dim(dim)
+            ->Ids(base_ids.data() + begin)
+            ->Float32Vectors(base_vectors.data() + begin * dim)
+            ->Owner(false);
+        offset = offset == num_base ? offset + 1 : offset + count;
+        return chunk;
+    };
+    auto result = index->AddStream(next_chunk);
+    REQUIRE(result.has_value());
+    REQUIRE(result->size() == 10);
+    REQUIRE(pulled == (num_base + chunk_size - 1) / chunk_size + 2);
+    REQUIRE(index->GetNumElements() == num_base);
+
+    JsonType search_parameters{{"hnsw", {{"ef_search", 100}}}};
+    int64_t correct = 0;
+    for (int64_t i = 0; i < num_base; ++i) {
+        auto query = Dataset::Make();
+        query->NumElements(1)
+            ->Dim(dim)
+            ->Float32Vectors(base_vectors.data() + i * dim)
+            ->Owner(false);
+        auto knn_result = index->KnnSearch(query, 1, search_parameters.dump());
+        REQUIRE(knn_result.has_value());
+        correct += knn_result.value()->GetIds()[0] == base_ids[i];
+    }
+    REQUIRE(correct > num_base * 0.99);
+
+    auto wrong_dim = Dataset::Make();
+    wrong_dim->NumElements(1)->Dim(dim + 1)->Float32Vectors(base_vectors.data())->Owner(false);
+    bool returned = false;
+    auto error_result = index->AddStream([&]() -> DatasetPtr {
+        if (returned) {
+            return nullptr;
+        }
+        returned = true;
+        return wrong_dim;
+    });
+    REQUIRE_FALSE(error_result.has_value());
+    REQUIRE(error_result.error().type == ErrorType::INVALID_ARGUMENT);
+}
+
 TEST_CASE("get min and max id", "[ut][hnsw]") {
     Options::Instance().logger()->SetLevel(Logger::Level::kDEBUG);
 
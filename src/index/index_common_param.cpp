@@ -78,6 +78,17 @@ fill_extra_info_size(IndexCommonParam& result, JsonType::const_reference extra_i
     result.extra_info_size_ = extra_info_size;
 }
 
+inline void
+fill_query_cache_size(IndexCommonParam& result, JsonType::const_reference query_cache_size_obj) {
+    CHECK_ARGUMENT(query_cache_size_obj.is_number_integer(),
+                   fmt::format("parameters[{}] must be integer type", PARAMETER_QUERY_CACHE_SIZE));
+    int64_t query_cache_size = query_cache_size_obj.get<int64_t>();
+    CHECK_ARGUMENT(
+        query_cache_size >= 0,
+        fmt::format("parameters[{}] must not be less than 0", PARAMETER_QUERY_CACHE_SIZE));
+    result.query_cache_size_ = query_cache_size;
+}
+
 IndexCommonParam
 IndexCommonParam::CheckAndCreate(JsonType& params, const std::shared_ptr<Resource>& resource) {
     IndexCommonParam result;
@@ -107,6 +118,11 @@ IndexCommonParam::CheckAndCreate(JsonType& params, const std::shared_ptr<Resourc
         fill_extra_info_size(result, extra_info_size_obj);
     }
 
+    if (params.contains(PARAMETER_QUERY_CACHE_SIZE)) {
+        const auto query_cache_size_obj = params[PARAMETER_QUERY_CACHE_SIZE];
+        fill_query_cache_size(result, query_cache_size_obj);
+    }
+
     return result;
 }
 
@@ -32,6 +32,8 @@ public:
     DataTypes data_type_{DataTypes::DATA_TYPE_FLOAT};
     int64_t dim_{0};
     int64_t extra_info_size_{0};
+    // the entries of the knn result cache, 0 disables it
+    int64_t query_cache_size_{0};
     std::shared_ptr<Allocator> allocator_{nullptr};
     std::shared_ptr<SafeThreadPool> thread_pool_{nullptr};
 
@@ -51,6 +51,7 @@ public:
 public:
     tl::expected<std::vector<int64_t>, Error>
     Build(const DatasetPtr& base) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(return this->inner_index_->Build(base));
     }
 
@@ -61,26 +62,37 @@ public:
 
     tl::expected<Checkpoint, Error>
     ContinueBuild(const DatasetPtr& base, const BinarySet& binary_set) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(return this->inner_index_->ContinueBuild(base, binary_set));
     }
 
     tl::expected<std::vector<int64_t>, Error>
     Add(const DatasetPtr& base) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(return this->inner_index_->Add(base));
     }
 
+    tl::expected<std::vector<int64_t>, Error>
+    AddStream(const DatasetStream& next_chunk) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
+        SAFE_CALL(return this->inner_index_->AddStream(next_chunk));
+    }
+
     tl::expected<bool, Error>
     Remove(int64_t id) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(return this->inner_index_->Remove(id));
     }
 
     tl::expected<bool, Error>
     UpdateId(int64_t old_id, int64_t new_id) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(return this->inner_index_->UpdateId(old_id, new_id));
     }
 
     tl::expected<bool, Error>
     UpdateVector(int64_t id, const DatasetPtr& new_base, bool force_update = false) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(return this->inner_index_->UpdateVector(id, new_base, force_update));
     }
 
@@ -92,6 +104,9 @@ public:
         if (GetNumElements() == 0) {
             return DatasetImpl::MakeEmptyDataset();
         }
+        if (invalid == nullptr) {
+            SAFE_CALL(return this->inner_index_->CachedKnnSearch(query, k, parameters, nullptr));
+        }
         SAFE_CALL(return this->inner_index_->KnnSearch(query, k, parameters, invalid));
     }
 
@@ -114,7 +129,7 @@ public:
         if (GetNumElements() == 0) {
             return DatasetImpl::MakeEmptyDataset();
         }
-        SAFE_CALL(return this->inner_index_->KnnSearch(query, k, parameters, filter));
+        SAFE_CALL(return this->inner_index_->CachedKnnSearch(query, k, parameters, filter));
     }
 
     tl::expected<DatasetPtr, Error>
@@ -131,6 +146,54 @@ public:
             query, k, parameters, filter, iter_ctx, is_last_filter));
     }
 
+    tl::expected<SearchCursorPtr, Error>
+    OpenSearchCursor(const DatasetPtr& query,
+                     const std::string& parameters,
+                     const FilterPtr& filter = nullptr) const override {
+        SAFE_CALL(return this->inner_index_->OpenSearchCursor(query, parameters, filter));
+    }
+
+    tl::expected<SearchParamPtr, Error>
+    CompileSearchParam(const std::string& parameters) const override {
+        SAFE_CALL(return this->inner_index_->CompileSearchParam(parameters));
+    }
+
+    [[nodiscard]] tl::expected<DatasetPtr, Error>
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              BitsetPtr invalid = nullptr) const override {
+        if (GetNumElements() == 0) {
+            return DatasetImpl::MakeEmptyDataset();
+        }
+        if (invalid == nullptr) {
+            SAFE_CALL(return this->inner_index_->CachedKnnSearch(query, k, param, nullptr));
+        }
+        SAFE_CALL(return this->inner_index_->KnnSearch(query, k, param, invalid));
+    }
+
+    tl::expected<DatasetPtr, Error>
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const std::function<bool(int64_t)>& filter) const override {
+        if (GetNumElements() == 0) {
+            return DatasetImpl::MakeEmptyDataset();
+        }
+        SAFE_CALL(return this->inner_index_->KnnSearch(query, k, param, filter));
+    }
+
+    tl::expected<DatasetPtr, Error>
+    KnnSearch(const DatasetPtr& query,
+              int64_t k,
+              const SearchParamPtr& param,
+              const FilterPtr& filter) const override {
+        if (GetNumElements() == 0) {
+            return DatasetImpl::MakeEmptyDataset();
+        }
+        SAFE_CALL(return this->inner_index_->CachedKnnSearch(query, k, param, filter));
+    }
+
     [[nodiscard]] tl::expected<DatasetPtr, Error>
     RangeSearch(const DatasetPtr& query,
                 float radius,
@@ -181,10 +244,61 @@ public:
             query, radius, parameters, filter, limited_size));
     }
 
+    tl::expected<DatasetPtr, Error>
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                int64_t limited_size = -1) const override {
+        if (GetNumElements() == 0) {
+            return DatasetImpl::MakeEmptyDataset();
+        }
+        SAFE_CALL(return this->inner_index_->RangeSearch(query, radius, param, limited_size));
+    }
+
+    tl::expected<DatasetPtr, Error>
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                BitsetPtr invalid,
+                int64_t limited_size = -1) const override {
+        if (GetNumElements() == 0) {
+            return DatasetImpl::MakeEmptyDataset();
+        }
+        SAFE_CALL(
+            return this->inner_index_->RangeSearch(query, radius, param, invalid, limited_size));
+    }
+
+    tl::expected<DatasetPtr, Error>
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const std::function<bool(int64_t)>& filter,
+                int64_t limited_size = -1) const override {
+        if (GetNumElements() == 0) {
+            return DatasetImpl::MakeEmptyDataset();
+        }
+        SAFE_CALL(
+            return this->inner_index_->RangeSearch(query, radius, param, filter, limited_size));
+    }
+
+    tl::expected<DatasetPtr, Error>
+    RangeSearch(const DatasetPtr& query,
+                float radius,
+                const SearchParamPtr& param,
+                const FilterPtr& filter,
+                int64_t limited_size = -1) const override {
+        if (GetNumElements() == 0) {
+            return DatasetImpl::MakeEmptyDataset();
+        }
+        SAFE_CALL(
+            return this->inner_index_->RangeSearch(query, radius, param, filter, limited_size));
+    }
+
     tl::expected<uint32_t, Error>
     Pretrain(const std::vector<int64_t>& base_tag_ids,
              uint32_t k,
              const std::string& parameters) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(return this->inner_index_->Pretrain(base_tag_ids, k, parameters));
     }
 
@@ -193,9 +307,20 @@ public:
              int64_t k,
              const std::string& parameters,
              int64_t global_optimum_tag_id = std::numeric_limits<int64_t>::max()) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(return this->inner_index_->Feedback(query, k, parameters, global_optimum_tag_id));
     }
 
+    tl::expected<uint32_t, Error>
+    BatchFeedback(const DatasetPtr& queries,
+                  int64_t k,
+                  const std::string& parameters,
+                  const std::vector<int64_t>& global_optimum_tag_ids = {}) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
+        SAFE_CALL(return this->inner_index_->BatchFeedback(
+            queries, k, parameters, global_optimum_tag_ids));
+    }
+
     tl::expected<float, Error>
     CalcDistanceById(const float* vector, int64_t id) const override {
         SAFE_CALL(return this->inner_index_->CalcDistanceById(vector, id));
@@ -218,9 +343,15 @@ public:
 
     tl::expected<void, Error>
     Merge(const std::vector<MergeUnit>& merge_units) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(this->inner_index_->Merge(merge_units));
     }
 
+    [[nodiscard]] InnerIndexPtr
+    GetInnerIndex() const {
+        return this->inner_index_;
+    }
+
     tl::expected<IndexPtr, Error>
     Clone() const override {
         auto clone_value = this->clone_inner_index();
@@ -246,11 +377,13 @@ public:
 
     tl::expected<void, Error>
     Deserialize(const BinarySet& binary_set) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(this->inner_index_->Deserialize(binary_set));
     }
 
     tl::expected<void, Error>
     Deserialize(const ReaderSet& reader_set) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(this->inner_index_->Deserialize(reader_set));
     }
 
@@ -261,6 +394,7 @@ public:
 
     tl::expected<void, Error>
     Deserialize(std::istream& in_stream) override {
+        QueryResultCache::InvalidateGuard guard(this->inner_index_->query_cache_.get());
         SAFE_CALL(this->inner_index_->Deserialize(in_stream));
     }
 
@@ -0,0 +1,195 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "label_remap.h"
+
+#include <fmt/format-inl.h>
+
+#include "vsag_exception.h"
+
+namespace vsag {
+
+static_assert(sizeof(std::atomic<LabelType>) == sizeof(LabelType));
+static_assert(sizeof(std::atomic<InnerIdType>) == sizeof(InnerIdType));
+
+LabelRemap::Slots::Slots(uint64_t capacity, Allocator* allocator)
+    : capacity(capacity), labels(capacity, allocator), ids(capacity, allocator) {
+    for (auto& id : this->ids) {
+        id.store(EMPTY_SLOT, std::memory_order_relaxed);
+    }
+}
+
+LabelRemap::LabelRemap(Allocator* allocator)
+    : allocator_(allocator), slots_(std::make_shared<Slots>(MIN_CAPACITY, allocator)) {
+}
+
+uint64_t
+LabelRemap::hash(LabelType label) {
+    // splitmix64 finalizer, sequential labels spread over the whole table
+    auto x = static_cast<uint64_t>(label);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t
+LabelRemap::capacity_for(uint64_t count) {
+    uint64_t capacity = MIN_CAPACITY;
+    while (static_cast<double>(count) > static_cast<double>(capacity) * MAX_LOAD_FACTOR) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+void
+LabelRemap::Insert(LabelType label, InnerIdType id) {
+    if (id >= DELETED_SLOT) {
+        throw VsagException(ErrorType::INTERNAL_ERROR, fmt::format("inner id {} is reserved", id));
+    }
+    auto capacity = this->slots_->capacity;
+    if (static_cast<double>(this->used_ + 1) > static_cast<double>(capacity) * MAX_LOAD_FACTOR) {
+        // grow when the live labels fill half the table, otherwise only drop the removed ones
+        auto live_count = this->size_.load(std::memory_order_relaxed) + 1;
+        this->rehash(live_count * 2 > capacity ? capacity_for(live_count * 2) : capacity);
+    }
+    auto& slots = *this->slots_;
+    auto mask = slots.capacity - 1;
+    for (auto pos = hash(label) & mask;; pos = (pos + 1) & mask) {
+        auto current = slots.ids[pos].load(std::memory_order_relaxed);
+        if (current == EMPTY_SLOT) {
+            // the label is visible before the id that publishes the slot
+            slots.labels[pos].store(label, std::memory_order_relaxed);
+            slots.ids[pos].store(id, std::memory_order_release);
+            ++this->used_;
+            this->size_.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        if (slots.labels[pos].load(std::memory_order_relaxed) == label) {
+            slots.ids[pos].store(id, std::memory_order_release);
+            if (current == DELETED_SLOT) {
+                this->size_.fetch_add(1, std::memory_order_release);
+            }
+            return;
+        }
+    }
+}
+
+bool
+LabelRemap::Remove(LabelType label) {
+    auto& slots = *this->slots_;
+    auto mask = slots.capacity - 1;
+    for (auto pos = hash(label) & mask;; pos = (pos + 1) & mask) {
+        auto current = slots.ids[pos].load(std::memory_order_relaxed);
+        if (current == EMPTY_SLOT) {
+            return false;
+        }
+        if (slots.labels[pos].load(std::memory_order_relaxed) == label) {
+            if (current == DELETED_SLOT) {
+                return false;
+            }
+            slots.ids[pos].store(DELETED_SLOT, std::memory_order_release);
+            this->size_.fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+    }
+}
+
+bool
+LabelRemap::Find(LabelType label, InnerIdType& id) const {
+    auto slots = std::atomic_load(&this->slots_);
+    auto mask = slots->capacity - 1;
+    for (auto pos = hash(label) & mask;; pos = (pos + 1) & mask) {
+        auto current = slots->ids[pos].load(std::memory_order_acquire);
+        if (current == EMPTY_SLOT) {
+            return false;
+        }
+        if (slots->labels[pos].load(std::memory_order_relaxed) == label) {
+            if (current == DELETED_SLOT) {
+                return false;
+            }
+            id = current;
+            return true;
+        }
+    }
+}
+
+void
+LabelRemap::Reserve(uint64_t count) {
+    auto capacity = capacity_for(count);
+    if (capacity > this->slots_->capacity) {
+        this->rehash(capacity);
+    }
+}
+
+void
+LabelRemap::Clear() {
+    std::atomic_store(&this->slots_, std::make_shared<Slots>(MIN_CAPACITY, allocator_));
+    this->used_ = 0;
+    this->size_.store(0, std::memory_order_release);
+}
+
+void
+LabelRemap::rehash(uint64_t capacity) {
+    auto slots = std::make_shared<Slots>(capacity, allocator_);
+    auto mask = capacity - 1;
+    uint64_t used = 0;
+    this->ForEach([&](LabelType label, InnerIdType id) {
+        auto pos = hash(label) & mask;
+        while (slots->ids[pos].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+            pos = (pos + 1) & mask;
+        }
+        slots->labels[pos].store(label, std::memory_order_relaxed);
+        slots->ids[pos].store(id, std::memory_order_relaxed);
+        ++used;
+    });
+    // readers still holding the old table keep it alive until they finish
+    std::atomic_store(&this->slots_, slots);
+    this->used_ = used;
+}
+
+void
+LabelRemap::Serialize(StreamWriter& writer) const {
+    auto slots = std::atomic_load(&this->slots_);
+    StreamWriter::WriteObj(writer, slots->capacity);
+    StreamWriter::WriteObj(writer, this->used_);
+    auto size = this->Size();
+    StreamWriter::WriteObj(writer, size);
+    writer.Write(reinterpret_cast<const char*>(slots->labels.data()),
+                 slots->capacity * sizeof(LabelType));
+    writer.Write(reinterpret_cast<const char*>(slots->ids.data()),
+                 slots->capacity * sizeof(InnerIdType));
+}
+
+void
+LabelRemap::Deserialize(StreamReader& reader) {
+    uint64_t capacity;
+    StreamReader::ReadObj(reader, capacity);
+    if (capacity < MIN_CAPACITY or (capacity & (capacity - 1)) != 0) {
+        throw VsagException(ErrorType::INVALID_BINARY,
+                            fmt::format("invalid label remap capacity {}", capacity));
+    }
+    uint64_t used;
+    StreamReader::ReadObj(reader, used);
+    uint64_t size;
+    StreamReader::ReadObj(reader, size);
+    auto slots = std::make_shared<Slots>(capacity, allocator_);
+    reader.Read(reinterpret_cast<char*>(slots->labels.data()), capacity * sizeof(LabelType));
+    reader.Read(reinterpret_cast<char*>(slots->ids.data()), capacity * sizeof(InnerIdType));
+    std::atomic_store(&this->slots_, slots);
+    this->used_ = used;
+    this->size_.store(size, std::memory_order_release);
+}
+
+}  // namespace vsag
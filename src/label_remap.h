@@ -0,0 +1,131 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <limits>
+#include <memory>
+
+#include "stream_reader.h"
+#include "stream_writer.h"
+#include "typing.h"
+
+namespace vsag {
+
+/**
+ * @brief an open-addressing map from labels to inner ids
+ *
+ * Writers are serialized by the caller, readers never lock: a slot belongs to one label for
+ * the lifetime of its table and only its id changes afterwards, and a grown table is published
+ * as a whole. The slots are two flat arrays, which are serialized and loaded without rehashing.
+ */
+class LabelRemap {
+public:
+    explicit LabelRemap(Allocator* allocator);
+
+    // insert a label, or overwrite the id of an existing one
+    void
+    Insert(LabelType label, InnerIdType id);
+
+    bool
+    Remove(LabelType label);
+
+    bool
+    Find(LabelType label, InnerIdType& id) const;
+
+    [[nodiscard]] inline bool
+    Contains(LabelType label) const {
+        InnerIdType id;
+        return this->Find(label, id);
+    }
+
+    [[nodiscard]] inline uint64_t
+    Size() const {
+        return this->size_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] inline bool
+    Empty() const {
+        return this->Size() == 0;
+    }
+
+    // make room for count labels, so that inserting them does not grow the table
+    void
+    Reserve(uint64_t count);
+
+    void
+    Clear();
+
+    // call func(label, id) for every label in the map, in slot order
+    template <typename Func>
+    void
+    ForEach(const Func& func) const {
+        auto slots = std::atomic_load(&this->slots_);
+        for (uint64_t i = 0; i < slots->capacity; ++i) {
+            auto id = slots->ids[i].load(std::memory_order_acquire);
+            if (id < DELETED_SLOT) {
+                func(slots->labels[i].load(std::memory_order_relaxed), id);
+            }
+        }
+    }
+
+    void
+    Serialize(StreamWriter& writer) const;
+
+    void
+    Deserialize(StreamReader& reader);
+
+private:
+    struct Slots {
+        Slots(uint64_t capacity, Allocator* allocator);
+
+        const uint64_t capacity{0};
+        Vector<std::atomic<LabelType>> labels;
+        Vector<std::atomic<InnerIdType>> ids;
+    };
+
+    using SlotsPtr = std::shared_ptr<Slots>;
+
+    static uint64_t
+    hash(LabelType label);
+
+    static uint64_t
+    capacity_for(uint64_t count);
+
+    // move the labels into a table of the given capacity, dropping removed slots
+    void
+    rehash(uint64_t capacity);
+
+private:
+    Allocator* const allocator_{nullptr};
+
+    SlotsPtr slots_{nullptr};
+
+    std::atomic<uint64_t> size_{0};
+
+    // live and removed slots, a removed slot keeps its label until the next rehash
+    uint64_t used_{0};
+
+    static constexpr InnerIdType EMPTY_SLOT = std::numeric_limits<InnerIdType>::max();
+    static constexpr InnerIdType DELETED_SLOT = EMPTY_SLOT - 1;
+
+    static constexpr uint64_t MIN_CAPACITY = 16;
+
+    // rehash once live and removed slots reach this share of the table
+    static constexpr double MAX_LOAD_FACTOR = 0.7;
+};
+
+}  // namespace vsag
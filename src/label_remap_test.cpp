@@ -0,0 +1,138 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "label_remap.h"
+
+#include <sstream>
+#include <thread>
+
+#include "catch2/catch_test_macros.hpp"
+#include "default_allocator.h"
+
+using namespace vsag;
+
+TEST_CASE("LabelRemap Basic Test", "[ut][LabelRemap]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    LabelRemap remap(allocator.get());
+    REQUIRE(remap.Empty());
+
+    InnerIdType count = 10000;
+    for (InnerIdType i = 0; i < count; ++i) {
+        remap.Insert(static_cast<LabelType>(i) * 7 - 5000, i);
+    }
+    REQUIRE(remap.Size() == count);
+    for (InnerIdType i = 0; i < count; ++i) {
+        InnerIdType id;
+        REQUIRE(remap.Find(static_cast<LabelType>(i) * 7 - 5000, id));
+        REQUIRE(id == i);
+    }
+    REQUIRE_FALSE(remap.Contains(1));
+
+    // remove, overwrite and insert a removed label again
+    REQUIRE(remap.Remove(-5000));
+    REQUIRE_FALSE(remap.Remove(-5000));
+    REQUIRE_FALSE(remap.Contains(-5000));
+    remap.Insert(2, 3);
+    InnerIdType id;
+    REQUIRE(remap.Find(2, id));
+    REQUIRE(id == 3);
+    remap.Insert(-5000, count);
+    REQUIRE(remap.Find(-5000, id));
+    REQUIRE(id == count);
+    REQUIRE(remap.Size() == count + 1);
+
+    uint64_t visited = 0;
+    remap.ForEach([&](LabelType label, InnerIdType inner_id) {
+        InnerIdType found;
+        REQUIRE(remap.Find(label, found));
+        REQUIRE(found == inner_id);
+        ++visited;
+    });
+    REQUIRE(visited == count + 1);
+
+    remap.Clear();
+    REQUIRE(remap.Empty());
+    REQUIRE_FALSE(remap.Contains(2));
+}
+
+TEST_CASE("LabelRemap Remove Churn Test", "[ut][LabelRemap]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    LabelRemap remap(allocator.get());
+    // removed slots are dropped by rehashing, the table does not fill up
+    for (InnerIdType i = 0; i < 100000; ++i) {
+        remap.Insert(i, i);
+        if (i >= 10) {
+            REQUIRE(remap.Remove(i - 10));
+        }
+    }
+    REQUIRE(remap.Size() == 10);
+    for (InnerIdType i = 100000 - 10; i < 100000; ++i) {
+        REQUIRE(remap.Contains(i));
+    }
+}
+
+TEST_CASE("LabelRemap Serialize Test", "[ut][LabelRemap]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    LabelRemap remap(allocator.get());
+    for (InnerIdType i = 0; i < 1000; ++i) {
+        remap.Insert(static_cast<LabelType>(i) << 20, i);
+    }
+    remap.Remove(0);
+
+    std::stringstream ss;
+    IOStreamWriter writer(ss);
+    remap.Serialize(writer);
+    ss.seekg(0, std::ios::beg);
+    IOStreamReader reader(ss);
+    LabelRemap loaded(allocator.get());
+    loaded.Deserialize(reader);
+
+    REQUIRE(loaded.Size() == remap.Size());
+    REQUIRE_FALSE(loaded.Contains(0));
+    for (InnerIdType i = 1; i < 1000; ++i) {
+        InnerIdType id;
+        REQUIRE(loaded.Find(static_cast<LabelType>(i) << 20, id));
+        REQUIRE(id == i);
+    }
+    loaded.Insert(-1, 1000);
+    REQUIRE(loaded.Contains(-1));
+}
+
+TEST_CASE("LabelRemap Concurrent Read Test", "[ut][LabelRemap]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    LabelRemap remap(allocator.get());
+    InnerIdType count = 100000;
+    std::atomic<InnerIdType> published{0};
+    std::atomic<bool> missed{false};
+    // readers never miss a label that was inserted before, even while the table grows
+    std::thread reader_thread([&]() {
+        while (published.load() < count) {
+            auto last = published.load();
+            if (last == 0) {
+                continue;
+            }
+            InnerIdType id;
+            if (not remap.Find(last - 1, id) or id != last - 1) {
+                missed.store(true);
+            }
+        }
+    });
+    for (InnerIdType i = 0; i < count; ++i) {
+        remap.Insert(i, i);
+        published.store(i + 1);
+    }
+    reader_thread.join();
+    REQUIRE_FALSE(missed.load());
+}
@@ -17,6 +17,7 @@
 
 #include <fmt/format-inl.h>
 
+#include "label_remap.h"
 #include "stream_reader.h"
 #include "stream_writer.h"
 #include "typing.h"
@@ -25,28 +26,34 @@ namespace vsag {
 class LabelTable {
 public:
     explicit LabelTable(Allocator* allocator)
-        : allocator_(allocator), label_table_(0, allocator), label_remap_(0, allocator){};
+        : allocator_(allocator), label_table_(0, allocator), label_remap_(allocator){};
 
     inline void
     Insert(InnerIdType id, LabelType label) {
-        label_remap_[label] = id;
+        label_remap_.Insert(label, id);
         if (id + 1 > label_table_.size()) {
             label_table_.resize(id + 1);
         }
         label_table_[id] = label;
     }
 
+    inline void
+    Remove(LabelType label) {
+        label_remap_.Remove(label);
+    }
+
     inline InnerIdType
     GetIdByLabel(LabelType label) const {
-        if (this->label_remap_.count(label) == 0) {
+        InnerIdType inner_id;
+        if (not this->label_remap_.Find(label, inner_id)) {
             throw std::runtime_error(fmt::format("label {} is not exists", label));
         }
-        return this->label_remap_.at(label);
+        return inner_id;
     }
 
     inline bool
     CheckLabel(LabelType label) const {
-        return label_remap_.find(label) != label_remap_.end();
+        return label_remap_.Contains(label);
     }
 
     inline LabelType
@@ -66,14 +73,16 @@ public:
     void
     Deserialize(StreamReader& reader) {
         StreamReader::ReadVector(reader, label_table_);
+        this->label_remap_.Clear();
+        this->label_remap_.Reserve(label_table_.size());
         for (InnerIdType id = 0; id < label_table_.size(); ++id) {
-            this->label_remap_[label_table_[id]] = id;
+            this->label_remap_.Insert(label_table_[id], id);
         }
     }
 
 public:
     Vector<LabelType> label_table_;
-    UnorderedMap<LabelType, InnerIdType> label_remap_;
+    LabelRemap label_remap_;
 
     Allocator* allocator_{nullptr};
 };
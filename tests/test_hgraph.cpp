@@ -162,6 +162,8 @@ HgraphTestIndex::TestGeneral(const TestIndex::IndexPtr& index,
     TestGetMinAndMaxId(index, dataset);
     TestKnnSearch(index, dataset, search_param, recall, true);
     TestKnnSearchIter(index, dataset, search_param, recall, true);
+    TestSearchCursor(index, dataset, search_param, recall);
+    TestCompiledSearchParam(index, dataset, search_param);
     TestConcurrentKnnSearch(index, dataset, search_param, recall, true);
     TestRangeSearch(index, dataset, search_param, recall, 10, true);
     TestRangeSearch(index, dataset, search_param, recall / 2.0, 5, true);
@@ -459,6 +461,202 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex, "HGraph Add", "[ft][hgra
     }
 }
 
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex, "HGraph Remove", "[ft][hgraph]") {
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto metric_type = GENERATE("l2", "cosine");
+    const std::vector<std::pair<std::string, float>> remove_test_cases = {
+        {"fp32", 0.99},
+        {"sq8_uniform,fp32", 0.98},
+    };
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 200, false);
+    for (auto dim : dims) {
+        for (auto& [base_quantization_str, recall] : remove_test_cases) {
+            vsag::Options::Instance().set_block_size_limit(size);
+            auto param =
+                GenerateHGraphBuildParametersString(metric_type, dim, base_quantization_str);
+            auto index = TestFactory(name, param, true);
+            auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+            TestBuildIndex(index, dataset, true);
+            TestRemoveIndex(index, dataset, search_param, true);
+            TestGeneral(index, dataset, search_param, recall);
+            TestUpdateId(index, dataset, search_param, true);
+            vsag::Options::Instance().set_block_size_limit(origin_size);
+        }
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex, "HGraph ODescent Build", "[ft][hgraph]") {
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto metric_type = GENERATE("l2", "cosine");
+    const std::vector<std::pair<std::string, float>> odescent_test_cases = {
+        {"fp32", 0.98},
+        {"sq8_uniform,fp32", 0.97},
+    };
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 200, false);
+    for (auto dim : dims) {
+        for (auto& [base_quantization_str, recall] : odescent_test_cases) {
+            vsag::Options::Instance().set_block_size_limit(size);
+            auto param = nlohmann::json::parse(
+                GenerateHGraphBuildParametersString(metric_type, dim, base_quantization_str));
+            param[vsag::INDEX_PARAM][vsag::HGRAPH_GRAPH_TYPE] = vsag::GRAPH_TYPE_ODESCENT;
+            auto index = TestFactory(name, param.dump(), true);
+            auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+            TestBuildIndex(index, dataset, true);
+            TestGeneral(index, dataset, search_param, recall);
+            vsag::Options::Instance().set_block_size_limit(origin_size);
+        }
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex, "HGraph Adaptive Search", "[ft][hgraph]") {
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "hgraph";
+    // ef_search only caps the search, it stops once the top-k converges
+    auto search_param = R"({"hgraph": {"ef_search": 400, "target_recall": 0.99}})";
+    for (auto dim : dims) {
+        vsag::Options::Instance().set_block_size_limit(size);
+        auto param = GenerateHGraphBuildParametersString(metric_type, dim, "fp32");
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.95, true);
+        TestFilterSearch(index, dataset, search_param, 0.95, true);
+        vsag::Options::Instance().set_block_size_limit(origin_size);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
+                             "HGraph Multi Entry Point Search",
+                             "[ft][hgraph]") {
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "hgraph";
+    auto search_param = R"({"hgraph": {"ef_search": 100, "entry_point_count": 4}})";
+    for (auto dim : dims) {
+        vsag::Options::Instance().set_block_size_limit(size);
+        auto param = GenerateHGraphBuildParametersString(metric_type, dim, "fp32");
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.99, true);
+        TestFilterSearch(index, dataset, search_param, 0.99, true);
+        TestRangeSearch(index, dataset, search_param, 0.99, 10, true);
+        vsag::Options::Instance().set_block_size_limit(origin_size);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
+                             "HGraph Search Without Filtered Expansion",
+                             "[ft][hgraph]") {
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "hgraph";
+    auto search_param = R"({"hgraph": {"ef_search": 200, "use_filtered_expansion": false}})";
+    for (auto dim : dims) {
+        vsag::Options::Instance().set_block_size_limit(size);
+        auto param = GenerateHGraphBuildParametersString(metric_type, dim, "fp32");
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.99, true);
+        TestFilterSearch(index, dataset, search_param, 0.99, true);
+        vsag::Options::Instance().set_block_size_limit(origin_size);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex, "HGraph Add Stream", "[ft][hgraph]") {
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto metric_type = GENERATE("l2", "ip", "cosine");
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 200, false);
+    for (auto dim : dims) {
+        vsag::Options::Instance().set_block_size_limit(size);
+        auto param = GenerateHGraphBuildParametersString(metric_type, dim, "fp32");
+        auto index = TestFactory(name, param, true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestAddStream(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.99, true);
+        vsag::Options::Instance().set_block_size_limit(origin_size);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex, "HGraph Query Cache", "[ft][hgraph]") {
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 100, false);
+    for (auto dim : dims) {
+        vsag::Options::Instance().set_block_size_limit(size);
+        auto param =
+            nlohmann::json::parse(GenerateHGraphBuildParametersString(metric_type, dim, "fp32"));
+        param[vsag::PARAMETER_QUERY_CACHE_SIZE] = 64;
+        auto index = TestFactory(name, param.dump(), true);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.99, true);
+        TestQueryCache(index, dataset, search_param);
+        vsag::Options::Instance().set_block_size_limit(origin_size);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex, "HGraph Merge", "[ft][hgraph]") {
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto metric_type = GENERATE("l2", "ip");
+    const std::string name = "hgraph";
+    auto search_param = fmt::format(search_param_tmp, 200, false);
+    for (auto dim : dims) {
+        vsag::Options::Instance().set_block_size_limit(size);
+        auto param = GenerateHGraphBuildParametersString(metric_type, dim, "fp32");
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type);
+        auto index = TestMergeIndex(name, param, dataset, 5, true);
+        TestKnnSearch(index, dataset, search_param, 0.98, true);
+        TestFilterSearch(index, dataset, search_param, 0.98, true);
+        TestCheckIdExist(index, dataset);
+        vsag::Options::Instance().set_block_size_limit(origin_size);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
+                             "HGraph Merge Shards With Different Quantizer Models",
+                             "[ft][hgraph]") {
+    auto dim = dims[0];
+    auto param = GenerateHGraphBuildParametersString("l2", dim, "sq8");
+    auto dataset = pool.GetDatasetAndCreate(dim, base_count, "l2");
+    const auto& base = dataset->base_;
+    int64_t half = base->GetNumElements() / 2;
+    auto index = vsag::Factory::CreateIndex("hgraph", param).value();
+    std::vector<vsag::MergeUnit> merge_units;
+    for (int64_t i = 0; i < 2; ++i) {
+        // every shard trains its own sq8 model on a different half of the data
+        auto subset = vsag::Dataset::Make();
+        subset->Float32Vectors(base->GetFloat32Vectors() + i * half * dim)
+            ->Ids(base->GetIds() + i * half)
+            ->NumElements(half)
+            ->Dim(dim)
+            ->Owner(false);
+        auto shard = vsag::Factory::CreateIndex("hgraph", param).value();
+        REQUIRE(shard->Build(subset).has_value());
+        vsag::IdMapFunction id_map = [](int64_t id) -> std::tuple<bool, int64_t> {
+            return std::make_tuple(true, id);
+        };
+        merge_units.push_back({shard, id_map});
+    }
+    auto result = index->Merge(merge_units);
+    REQUIRE_FALSE(result.has_value());
+    REQUIRE(result.error().type == vsag::ErrorType::INVALID_ARGUMENT);
+}
+
 TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
                              "HGraph Search with Dirty Vector",
                              "[ft][hgraph]") {
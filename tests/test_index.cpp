@@ -71,6 +71,98 @@ TestIndex::TestAddIndex(const IndexPtr& index,
     }
 }
 
+void
+TestIndex::TestAddStream(const IndexPtr& index,
+                         const TestDatasetPtr& dataset,
+                         bool expected_success) {
+    if (not index->CheckFeature(vsag::SUPPORT_ADD_FROM_EMPTY)) {
+        return;
+    }
+    auto base_count = dataset->base_->GetNumElements();
+    auto dim = dataset->base_->GetDim();
+    int64_t chunk_size = std::max(1L, base_count / 4);
+    int64_t offset = 0;
+    auto next_chunk = [&]() -> vsag::DatasetPtr {
+        if (offset >= base_count) {
+            return nullptr;
+        }
+        auto count = std::min(chunk_size, base_count - offset);
+        auto chunk = vsag::Dataset::Make();
+        chunk->Dim(dim)
+            ->Ids(dataset->base_->GetIds() + offset)
+            ->NumElements(count)
+            ->Float32Vectors(dataset->base_->GetFloat32Vectors() + offset * dim)
+            ->Owner(false);
+        offset += count;
+        return chunk;
+    };
+    auto add_index = index->AddStream(next_chunk);
+    if (expected_success) {
+        REQUIRE(add_index.has_value());
+        REQUIRE(add_index->empty());
+        REQUIRE(offset == base_count);
+        // check the number of vectors in index
+        REQUIRE(index->GetNumElements() == base_count);
+    } else {
+        REQUIRE(not add_index.has_value());
+    }
+}
+
+void
+TestIndex::TestRemoveIndex(const IndexPtr& index,
+                           const TestDatasetPtr& dataset,
+                           const std::string& search_param,
+                           bool expected_success) {
+    if (not index->CheckFeature(vsag::SUPPORT_DELETE_BY_ID)) {
+        return;
+    }
+    const auto* ids = dataset->base_->GetIds();
+    const auto* base = dataset->base_->GetFloat32Vectors();
+    auto num_vectors = dataset->base_->GetNumElements();
+    auto dim = dataset->base_->GetDim();
+    auto remove_count = num_vectors / 2;
+
+    for (int64_t i = 0; i < remove_count; ++i) {
+        auto remove_res = index->Remove(ids[i]);
+        REQUIRE(remove_res.has_value());
+        REQUIRE(remove_res.value() == expected_success);
+    }
+    if (not expected_success) {
+        return;
+    }
+    REQUIRE(index->GetNumElements() == num_vectors - remove_count);
+
+    // removed ids can't be removed again and never show up in the results
+    auto remove_again_res = index->Remove(ids[0]);
+    REQUIRE(remove_again_res.has_value());
+    REQUIRE(not remove_again_res.value());
+    std::unordered_set<int64_t> removed_ids(ids, ids + remove_count);
+    for (int64_t i = 0; i < remove_count; ++i) {
+        if (index->CheckFeature(vsag::SUPPORT_CHECK_ID_EXIST)) {
+            REQUIRE(index->CheckIdExist(ids[i]) == false);
+        }
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)->Dim(dim)->Float32Vectors(base + i * dim)->Owner(false);
+        auto result = index->KnnSearch(query, dataset->top_k, search_param);
+        REQUIRE(result.has_value());
+        for (int64_t j = 0; j < result.value()->GetDim(); ++j) {
+            REQUIRE(removed_ids.count(result.value()->GetIds()[j]) == 0);
+        }
+    }
+
+    // add the removed vectors back
+    auto removed_base = vsag::Dataset::Make();
+    removed_base->NumElements(remove_count)
+        ->Dim(dim)
+        ->Ids(ids)
+        ->Float32Vectors(base)
+        ->Owner(false);
+    auto add_res = index->Add(removed_base);
+    REQUIRE(add_res.has_value());
+    REQUIRE(add_res.value().empty());
+    REQUIRE(index->GetNumElements() == num_vectors);
+}
+
 void
 TestIndex::TestUpdateId(const IndexPtr& index,
                         const TestDatasetPtr& dataset,
@@ -381,6 +473,51 @@ TestIndex::TestKnnSearch(const IndexPtr& index,
     REQUIRE(cur_recall > expected_recall * query_count * RECALL_THRESHOLD);
 }
 
+void
+TestIndex::TestCompiledSearchParam(const IndexPtr& index,
+                                   const TestDatasetPtr& dataset,
+                                   const std::string& search_param) {
+    auto compiled = index->CompileSearchParam(search_param);
+    REQUIRE(compiled.has_value());
+    REQUIRE(compiled.value()->GetParameters() == search_param);
+    auto queries = dataset->query_;
+    auto query_count = std::min(queries->GetNumElements(), 100L);
+    auto dim = queries->GetDim();
+    auto topk = dataset->top_k;
+    vsag::FilterPtr filter = nullptr;
+    for (auto i = 0; i < query_count; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(dim)
+            ->Float32Vectors(queries->GetFloat32Vectors() + i * dim)
+            ->SparseVectors(queries->GetSparseVectors() + i)
+            ->Paths(queries->GetPaths() + i)
+            ->Owner(false);
+        // the compiled handle must give the same result as parsing the string
+        auto expected = index->KnnSearch(query, topk, search_param, filter);
+        auto res = index->KnnSearch(query, topk, compiled.value(), filter);
+        REQUIRE(expected.has_value());
+        REQUIRE(res.has_value());
+        REQUIRE(res.value()->GetDim() == expected.value()->GetDim());
+        for (int64_t j = 0; j < res.value()->GetDim(); ++j) {
+            REQUIRE(res.value()->GetIds()[j] == expected.value()->GetIds()[j]);
+        }
+
+        if (not index->CheckFeature(vsag::SUPPORT_RANGE_SEARCH)) {
+            continue;
+        }
+        auto radius = dataset->range_radius_[i];
+        auto expected_range = index->RangeSearch(query, radius, search_param, filter, 10);
+        auto res_range = index->RangeSearch(query, radius, compiled.value(), filter, 10);
+        REQUIRE(expected_range.has_value());
+        REQUIRE(res_range.has_value());
+        REQUIRE(res_range.value()->GetDim() == expected_range.value()->GetDim());
+        for (int64_t j = 0; j < res_range.value()->GetDim(); ++j) {
+            REQUIRE(res_range.value()->GetIds()[j] == expected_range.value()->GetIds()[j]);
+        }
+    }
+}
+
 void
 TestIndex::TestRangeSearch(const IndexPtr& index,
                            const TestDatasetPtr& dataset,
@@ -544,6 +681,112 @@ TestIndex::TestKnnSearchIter(const IndexPtr& index,
     REQUIRE(cur_recall > expected_recall * query_count * RECALL_THRESHOLD);
 }
 
+void
+TestIndex::TestSearchCursor(const IndexPtr& index,
+                            const TestDatasetPtr& dataset,
+                            const std::string& search_param,
+                            float expected_recall) {
+    if (not index->CheckFeature(vsag::SUPPORT_SEARCH_CURSOR)) {
+        return;
+    }
+    auto queries = dataset->query_;
+    auto query_count = queries->GetNumElements();
+    auto dim = queries->GetDim();
+    auto gts = dataset->filter_ground_truth_;
+    auto gt_topK = dataset->top_k;
+    auto filter = std::make_shared<FilterObj>(
+        dataset->filter_function_, dataset->ex_filter_function_, dataset->valid_ratio_);
+    int64_t page_size = std::max<int64_t>(gt_topK / 4, 1);
+    float cur_recall = 0.0f;
+    for (auto i = 0; i < query_count; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(dim)
+            ->Float32Vectors(queries->GetFloat32Vectors() + i * dim)
+            ->Paths(queries->GetPaths() + i)
+            ->Owner(false);
+        auto cursor = index->OpenSearchCursor(query, search_param, filter);
+        REQUIRE(cursor.has_value());
+        std::vector<int64_t> ids;
+        while (ids.size() < gt_topK and not cursor.value()->Exhausted()) {
+            auto page = cursor.value()->Next(page_size);
+            REQUIRE(page.has_value());
+            auto count = page.value()->GetDim();
+            REQUIRE(count <= page_size);
+            for (int64_t j = 0; j < count; ++j) {
+                REQUIRE(filter->CheckValid(page.value()->GetIds()[j]));
+                ids.emplace_back(page.value()->GetIds()[j]);
+            }
+        }
+        REQUIRE(std::unordered_set<int64_t>(ids.begin(), ids.end()).size() == ids.size());
+        auto gt = gts->GetIds() + gt_topK * i;
+        auto val = Intersection(gt, gt_topK, ids.data(), std::min<int64_t>(ids.size(), gt_topK));
+        cur_recall += static_cast<float>(val) / static_cast<float>(gt_topK);
+    }
+    if (cur_recall <= expected_recall * query_count) {
+        WARN(fmt::format("cur_result({}) <= expected_recall * query_count({})",
+                         cur_recall,
+                         expected_recall * query_count));
+    }
+    REQUIRE(cur_recall > expected_recall * query_count * RECALL_THRESHOLD);
+}
+
+void
+TestIndex::TestQueryCache(const IndexPtr& index,
+                          const TestDatasetPtr& dataset,
+                          const std::string& search_param) {
+    auto queries = dataset->query_;
+    auto query_count = std::min<int64_t>(queries->GetNumElements(), 10);
+    auto dim = queries->GetDim();
+    auto topk = dataset->top_k;
+    auto get_hit_count = [&]() -> uint64_t {
+        auto stats = nlohmann::json::parse(index->GetStats());
+        REQUIRE(stats.contains(vsag::STATSTIC_QUERY_CACHE_HIT));
+        return stats[vsag::STATSTIC_QUERY_CACHE_HIT].get<uint64_t>();
+    };
+    auto make_query = [&](int64_t i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(dim)
+            ->Float32Vectors(queries->GetFloat32Vectors() + i * dim)
+            ->Owner(false);
+        return query;
+    };
+
+    auto hit_count = get_hit_count();
+    for (int64_t i = 0; i < query_count; ++i) {
+        auto query = make_query(i);
+        auto first = index->KnnSearch(query, topk, search_param);
+        REQUIRE(first.has_value());
+        auto second = index->KnnSearch(query, topk, search_param);
+        REQUIRE(second.has_value());
+        REQUIRE(first.value()->GetDim() == second.value()->GetDim());
+        for (int64_t j = 0; j < first.value()->GetDim(); ++j) {
+            REQUIRE(first.value()->GetIds()[j] == second.value()->GetIds()[j]);
+            REQUIRE(first.value()->GetDistances()[j] == second.value()->GetDistances()[j]);
+        }
+    }
+    REQUIRE(get_hit_count() >= hit_count + query_count);
+
+    // a removed id must not come back from a cached result
+    if (not index->CheckFeature(vsag::SUPPORT_DELETE_BY_ID)) {
+        return;
+    }
+    auto query = make_query(0);
+    auto before = index->KnnSearch(query, topk, search_param);
+    REQUIRE(before.has_value());
+    REQUIRE(before.value()->GetDim() > 0);
+    auto removed_id = before.value()->GetIds()[0];
+    auto removed = index->Remove(removed_id);
+    REQUIRE(removed.has_value());
+    REQUIRE(removed.value());
+    auto after = index->KnnSearch(query, topk, search_param);
+    REQUIRE(after.has_value());
+    for (int64_t j = 0; j < after.value()->GetDim(); ++j) {
+        REQUIRE(after.value()->GetIds()[j] != removed_id);
+    }
+}
+
 void
 TestIndex::TestFilterSearch(const TestIndex::IndexPtr& index,
                             const TestDatasetPtr& dataset,
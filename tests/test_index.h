@@ -65,6 +65,11 @@ protected:
                  const TestDatasetPtr& dataset,
                  bool expected_success = true);
 
+    static void
+    TestAddStream(const IndexPtr& index,
+                  const TestDatasetPtr& dataset,
+                  bool expected_success = true);
+
     static void
     TestUpdateId(const IndexPtr& index,
                  const TestDatasetPtr& dataset,
@@ -77,6 +82,12 @@ protected:
                      const std::string& search_param,
                      bool expected_success = true);
 
+    static void
+    TestRemoveIndex(const IndexPtr& index,
+                    const TestDatasetPtr& dataset,
+                    const std::string& search_param,
+                    bool expected_success = true);
+
     static void
     TestContinueAdd(const IndexPtr& index,
                     const TestDatasetPtr& dataset,
@@ -107,6 +118,23 @@ protected:
                       bool expected_success = true,
                       bool use_ex_filter = false);
 
+    static void
+    TestSearchCursor(const IndexPtr& index,
+                     const TestDatasetPtr& dataset,
+                     const std::string& search_param,
+                     float expected_recall = 0.99);
+
+    // the index must be created with a query_cache_size, it is changed by a Remove
+    static void
+    TestQueryCache(const IndexPtr& index,
+                   const TestDatasetPtr& dataset,
+                   const std::string& search_param);
+
+    static void
+    TestCompiledSearchParam(const IndexPtr& index,
+                            const TestDatasetPtr& dataset,
+                            const std::string& search_param);
+
     static void
     TestSearchWithDirtyVector(const IndexPtr& index,
                               const TestDatasetPtr& dataset,
@@ -112,6 +112,7 @@ IVFTestIndex::TestGeneral(const TestIndex::IndexPtr& index,
                           float recall) {
     TestKnnSearch(index, dataset, search_param, recall, true);
     TestConcurrentKnnSearch(index, dataset, search_param, recall, true);
+    TestCompiledSearchParam(index, dataset, search_param);
     TestRangeSearch(index, dataset, search_param, recall, 10, true);
     TestRangeSearch(index, dataset, search_param, recall / 2.0, 5, true);
     TestFilterSearch(index, dataset, search_param, recall, true);